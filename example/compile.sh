@@ -1 +1 @@
-g++ -g -Wall example.cpp -o example -I../include -L../src -lyt
+g++ -g -Wall -fopenmp example.cpp -o example -I../include -L../src -lyt
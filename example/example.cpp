@@ -40,6 +40,12 @@ real set_density( const double x, const double y, const double z, const double t
 int main( int argc, char *argv[] )
 {
 
+// [optional] the staging mode requires MPI to be initialized before yt_init()
+#  ifdef SUPPORT_MPI
+   MPI_Init( &argc, &argv );
+#  endif
+
+
 // ==========================================
 // 1. initialize libyt
 // ==========================================
@@ -55,6 +61,24 @@ int main( int argc, char *argv[] )
 // YT analysis script without the ".py" extension (default="yt_inline_script")
    param_libyt.script  = "inline_script";
 
+// [optional] perform inline analysis every N steps (default=every step)
+// ==> yt_set_parameter(), yt_add_user_parameter_*(), yt_add_grid(), and yt_inline() are no-ops on other steps
+// param_libyt.analysis_interval_step = 2;
+
+// [optional] abort the analysis script if a single yt_inline() call takes longer than 60 seconds,
+// and postpone analyses to keep them below 10% of the total wall time
+// param_libyt.analysis_time_budget     = 60.0;
+// param_libyt.analysis_overhead_target = 0.1;
+
+// [optional] run the analysis script in a separate process instead (start "python ../tool/libyt_server.py
+// libyt inline_script" in this directory before or after launching this example)
+// param_libyt.shm_name = "libyt";
+
+// [optional] reserve the last rank for analysis (compile both libyt and this example with -DSUPPORT_MPI,
+// and run with, e.g., "mpirun -np 3 ./example")
+// ==> the other ranks return from yt_inline() as soon as the analysis rank has pulled their grids
+// param_libyt.num_analysis_ranks = 1;
+
 // *** libyt API ***
    if ( yt_init( argc, argv, &param_libyt ) != YT_SUCCESS )
    {
@@ -62,6 +86,32 @@ int main( int argc, char *argv[] )
       exit( EXIT_FAILURE );
    }
 
+// the analysis ranks run the analysis script for the compute ranks until they call yt_finalize()
+// ==> the compute ranks must use the communicator returned by yt_get_compute_comm() instead of MPI_COMM_WORLD
+// ==> without the staging mode, every rank runs the analysis script itself and must add all grids, so the grids
+//     are only divided among the compute ranks in the staging mode
+   int rank = 0, nrank = 1;
+
+#  ifdef SUPPORT_MPI
+   if ( yt_is_analysis_rank() )
+   {
+      const int status = yt_run_analysis_server();
+
+      yt_finalize();
+      MPI_Finalize();
+
+      return ( status == YT_SUCCESS ) ? EXIT_SUCCESS : EXIT_FAILURE;
+   }
+
+   if ( param_libyt.num_analysis_ranks > 0 )
+   {
+      MPI_Comm compute_comm;
+      yt_get_compute_comm( &compute_comm );
+      MPI_Comm_rank( compute_comm, &rank );
+      MPI_Comm_size( compute_comm, &nrank );
+   }
+#  endif
+
 
 
 // **********************************************
@@ -246,8 +296,16 @@ int main( int argc, char *argv[] )
 
 
 //    set general grid attributes and invoke inline analysis
+//    ==> yt_add_grid() is thread-safe and can be called from an OpenMP parallel region
+//    ==> in the staging mode, each compute rank only adds the grids it owns
+//    ==> do not exit inside the parallel region; record the failure and exit after the loop instead
+      bool add_grid_failed = false;
+
+#     pragma omp parallel for schedule( static ) reduction( ||:add_grid_failed )
       for (int gid=0; gid<param_yt.num_grids; gid++)
       {
+         if ( gid % nrank != rank )   continue;
+
 //       set pointers pointing to different field data
          libyt_grids[gid].field_data = new void* [num_fields];
          for (int v=0; v<num_fields; v++)   libyt_grids[gid].field_data[v] = field_data[gid][v];
@@ -258,13 +316,15 @@ int main( int argc, char *argv[] )
          libyt_grids[gid].field_ftype  = ( typeid(real) == typeid(float) ) ? YT_FLOAT : YT_DOUBLE;
 
 //       *** libyt API ***
-         if ( yt_add_grid( &libyt_grids[gid] ) != YT_SUCCESS )
-         {
-            fprintf( stderr, "ERROR: yt_add_grid() failed!\n" );
-            exit( EXIT_FAILURE );
-         }
+         if ( yt_add_grid( &libyt_grids[gid] ) != YT_SUCCESS )   add_grid_failed = true;
       } // for (int gid=0; gid<param_yt.num_grids; gid++)
 
+      if ( add_grid_failed )
+      {
+         fprintf( stderr, "ERROR: yt_add_grid() failed!\n" );
+         exit( EXIT_FAILURE );
+      }
+
 
 
 //    ==========================================
@@ -300,6 +360,10 @@ int main( int argc, char *argv[] )
 
    delete [] field_data;
 
+#  ifdef SUPPORT_MPI
+   MPI_Finalize();
+#  endif
+
    return EXIT_SUCCESS;
 
 } // FUNCTION : main
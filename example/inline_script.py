@@ -1,4 +1,5 @@
 import yt
+import libyt
 
 def yt_inline():
     ds = yt.frontends.libyt.libytDataset()
@@ -8,5 +9,7 @@ def yt_inline():
     sz.set_zlim( 'Dens', 1.0e0, 1.0e6 )
     sz.annotate_grids( periodic=False )
 
-    sz.save()
-
+    # pixelize now since libyt.grid_data is only valid during yt_inline(),
+    # then encode and write the figure in the background
+    sz.frb[ 'Dens' ]
+    libyt.submit_output( sz.save )
@@ -14,6 +14,9 @@
 
 // include relevant headers
 #include <stdio.h>
+#ifdef SUPPORT_MPI
+#include <mpi.h>
+#endif
 #include "yt_type.h"
 
 
@@ -34,6 +37,21 @@ int yt_add_user_parameter_double( const char *key, const int n, const double *in
 int yt_add_user_parameter_string( const char *key,              const char   *input );
 int yt_add_grid( yt_grid *grid );
 int yt_inline();
+int yt_set_reduced_output( const yt_reduced_output *output );
+int yt_replay( const char *filename );
+int yt_analysis_due();
+int yt_add_derived_field( const yt_derived_field *field );
+int yt_inline_wait();
+int yt_set_grid_filter( const yt_grid_filter *filter );
+int yt_set_uniform_decomposition( const int blocks[3], const int block_dims[3] );
+int yt_add_uniform_block( const long block_id, void **field_data );
+int yt_add_block_pool( const yt_block_pool *pool );
+int yt_declare_fields( const int num_fields, const yt_field *fields, const yt_ftype field_ftype );
+#ifdef SUPPORT_MPI
+int yt_is_analysis_rank();
+int yt_run_analysis_server();
+int yt_get_compute_comm( MPI_Comm *comm );
+#endif
 
 #ifdef __cplusplus
 }
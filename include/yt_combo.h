@@ -28,10 +28,17 @@
 // Python.h must be included before any standard headers are included
 #include <Python.h>
 #include "numpy/arrayobject.h"
+#include "yt_gil.h"
 
 #endif // #ifndef NO_PYTHON
 
 
+// MPI headers
+#ifdef SUPPORT_MPI
+#include <mpi.h>
+#endif
+
+
 // standard headers
 #include <stdio.h>
 #include <stdlib.h>
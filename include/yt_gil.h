@@ -0,0 +1,71 @@
+#ifndef __YT_GIL_H__
+#define __YT_GIL_H__
+
+
+
+/*******************************************************************************
+/
+/  yt_gil_guard and yt_nogil_guard structures
+/
+/  ==> included by yt_combo.h (Python files only)
+/
+********************************************************************************/
+
+
+//-------------------------------------------------------------------------------------------------------
+// Structure   :  yt_gil_guard
+// Description :  Hold the Python GIL during the lifetime of this object
+//
+// Note        :  1. The main thread releases the GIL at the end of yt_init() so that the output workers
+//                   (see output_pool.cpp) can run Python code while the simulation is running
+//                   ==> All API functions touching Python objects must declare a guard first:
+//                          yt_gil_guard gil;
+//                2. Can be nested
+//
+// Method      :  yt_gil_guard : Constructor ==> acquire the GIL
+//               ~yt_gil_guard : Destructor  ==> release the GIL
+//-------------------------------------------------------------------------------------------------------
+struct yt_gil_guard
+{
+
+   PyGILState_STATE state;
+
+   yt_gil_guard()  {  state = PyGILState_Ensure();  }
+   ~yt_gil_guard() {  PyGILState_Release( state );  }
+
+}; // struct yt_gil_guard
+
+
+
+// defined in native_calls.cpp
+void native_call_begin();
+void native_call_end();
+
+
+//-------------------------------------------------------------------------------------------------------
+// Structure   :  yt_nogil_guard
+// Description :  Release the Python GIL during the lifetime of this object for native code reading the
+//                staged grids (i.e., "g_grids", the spatial index, and the block pools)
+//
+// Note        :  1. Must be declared with the GIL held, and only after checking "g_param_libyt.grids_committed"
+//                2. The call is counted as in flight, and the grids are never freed or replaced while any
+//                   call is in flight (see native_call_drain())
+//                   ==> Output workers may call the native routines concurrently with the main thread
+//                3. Cannot be nested
+//
+// Method      :  yt_nogil_guard : Constructor ==> count the call and release the GIL
+//               ~yt_nogil_guard : Destructor  ==> acquire the GIL and uncount the call
+//-------------------------------------------------------------------------------------------------------
+struct yt_nogil_guard
+{
+
+   PyThreadState *state;
+
+   yt_nogil_guard()  {  native_call_begin();  state = PyEval_SaveThread();  }
+   ~yt_nogil_guard() {  PyEval_RestoreThread( state );  native_call_end();  }
+
+}; // struct yt_nogil_guard
+
+
+
+#endif // #ifndef __YT_GIL_H__
@@ -38,13 +38,31 @@ SET_GLOBAL( yt_param_libyt, g_param_libyt           );   // libyt runtime parame
                                                          // ==> Do not defined it as a pointer so that it is
                                                          //     initialized during compilation
 SET_GLOBAL( yt_param_yt,    g_param_yt              );   // YT parameters
+SET_GLOBAL( yt_reduced_output, g_reduced_output     );   // reduced data products dumped by the output stage
+SET_GLOBAL( yt_grid_filter, g_grid_filter           );   // grids and fields selected for the analysis
+SET_GLOBAL( yt_grid,       *g_grids,          NULL  );   // grids staged by yt_add_grid() (indexed by grid ID)
+SET_GLOBAL( yt_derived_field, *g_derived_fields, NULL );  // derived fields registered by yt_add_derived_field()
+SET_GLOBAL( int,            g_num_derived_fields, 0  );   // number of registered derived fields
+SET_GLOBAL( yt_field,      *g_fields,         NULL  );   // fields declared by yt_declare_fields()
+SET_GLOBAL( int,            g_num_fields,     0     );   // number of declared fields
+SET_GLOBAL( yt_ftype,       g_fields_ftype,   YT_FTYPE_UNKNOWN );   // floating-point type of all declared fields
+
+// MPI objects of the staging mode (see "g_param_libyt.num_analysis_ranks")
+#ifdef SUPPORT_MPI
+SET_GLOBAL( MPI_Comm,       g_compute_comm        );   // communicator of the compute (or analysis) ranks
+SET_GLOBAL( MPI_Win,        g_staging_win         );   // dynamic RMA window exposing the field data of the compute ranks
+#endif
 
 // add the prefix "g_py_" for all global Python objects
 #ifndef NO_PYTHON
 SET_GLOBAL( PyObject,      *g_py_grid_data,   NULL  );   // Python dictionary to store grid data
 SET_GLOBAL( PyObject,      *g_py_hierarchy,   NULL  );   // Python dictionary to store hierachy information
-SET_GLOBAL( PyObject,      *g_py_param_yt,    NULL  );   // Python dictionary to store YT parameters
+SET_GLOBAL( PyObject,      *g_py_param_yt,    NULL  );   // Python object to access YT parameters
 SET_GLOBAL( PyObject,      *g_py_param_user,  NULL  );   // Python dictionary to store code-specific parameters
+SET_GLOBAL( PyObject,      *g_py_derived_cache, NULL );  // Python dictionary to cache derived fields computed at this step
+SET_GLOBAL( PyThreadState, *g_py_main_tstate, NULL  );   // thread state saved when the main thread releases the GIL
+SET_GLOBAL( PyObject,      *g_py_grid_dict,   NULL  );   // Python dictionary type of grids with encoded fields
+SET_GLOBAL( PyObject,      *g_py_views,       NULL  );   // Python list tracking NumPy arrays wrapping the simulation data
 #endif
 
 
@@ -17,6 +17,9 @@ void log_error( const char *format, ... );
 #define FLT_UNDEFINED      3.40282347e+38F
 #define INT_UNDEFINED      2147483647
 
+#define MIN( a, b )        (  ( (a) < (b) ) ? (a) : (b)  )
+#define MAX( a, b )        (  ( (a) > (b) ) ? (a) : (b)  )
+
 
 // convenient macro to deal with errors
 #define YT_ABORT( ... )                                              \
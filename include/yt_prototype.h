@@ -13,12 +13,122 @@ void log_error  ( const char *format, ... );
 int  init_python( int argc, char *argv[] );
 int  init_libyt_module();
 int  allocate_hierarchy();
+int  commit_grids();
+int  get_left_index( const yt_grid *grid, long left_index[3] );
+int  get_parent_offset( const yt_grid *grid, long offset[3] );
+int  reduced_output_init();
+int  reduced_output_add_grid( const yt_grid *grid );
+int  reduced_output_flush();
+int  reduced_output_finalize();
+int  capture_open( const char *filename );
+int  capture_close();
+int  capture_param_yt( const yt_param_yt *param_yt );
+template <typename T>
+int  capture_user_param( const char *key, const int n, const T *input );
+int  capture_user_param_string( const char *key, const char *input );
+int  capture_grid( const yt_grid *grid );
+int  capture_inline();
+int  replay_capture( const char *filename );
+double get_wall_time();
+bool decide_analysis( const double time );
+void end_analysis_step();
+int  begin_step( yt_param_yt *param_yt );
+void reset_step();
+const yt_derived_field *find_derived_field( const char *name );
+void evaluate_derived_field( const yt_derived_field *field, const yt_grid *grid, const void **inputs, void *output );
+void *find_field_data( const yt_grid *grid, const char *label );
+void *get_field_data( const yt_grid *grid, const char *label, yt_ftype *ftype, bool *allocated );
+yt_encoding field_encoding( const yt_grid *grid, const int v );
+int  decode_field( const yt_grid *grid, const int v, void *output );
+int  grid_filter_init( const yt_grid_filter *filter );
+void grid_filter_free();
+bool grid_filter_accept( const yt_grid *grid );
+bool grid_filter_field( const char *label );
+int  compact_grids();
+int  renumber_grids( const long *new_id, const long count );
+int  order_grids();
+void grid_order_free();
+long grid_host_id( const long grid_id );
+void **block_pool_register( const yt_block_pool *pool );
+const char **block_pool_labels();
+void block_pool_free();
+int  field_registry_init( const int num_fields, const yt_field *fields, const yt_ftype field_ftype );
+void field_registry_free();
+const char **field_registry_labels();
+int  field_registry_find( const char *label );
+yt_centering field_centering( const yt_grid *grid, const int v );
+void field_dimensions( const yt_grid *grid, const int v, int dims[3] );
+int  grid_index_build();
+long grid_index_find( const double pos[3] );
+long grid_index_query( const double left[3], const double right[3], long *grid_ids );
+void grid_index_mark_covered( const long grid_id, char *mask, const char value );
+long grid_index_children( const long grid_id, const long **children );
+void grid_index_free();
+int  find_clumps( const char *field, const double threshold, const long min_cells, long *num_clumps,
+                  long **cell_count, double **mass, double **left_edge, double **right_edge );
+void output_pool_wait();
+bool output_pool_is_worker();
+void output_pool_finalize();
+void native_call_drain();
+int  covering_grid( const int level, const double left[3], const int dims[3], const char *field, const bool linear,
+                    const yt_ftype out_ftype, void *out );
+double sample_grid( const yt_grid *grid, const void *data, const yt_ftype ftype, const double pos[3],
+                    const bool linear );
+int  sample_points( const long num_points, const double *pos, const int num_fields, const char **fields,
+                    const bool linear, double **out );
+int  ray_cast( const yt_render *render, double *image );
+int  shm_init();
+int  shm_finalize();
+int  shm_set_parameter( yt_param_yt *param_yt );
+template <typename T>
+int  shm_user_param( const char *key, const int n, const T *input );
+int  shm_user_param_string( const char *key, const char *input );
+int  shm_inline();
+#ifdef SUPPORT_MPI
+int  staging_init();
+int  staging_finalize();
+bool staging_agree( const bool due );
+int  staging_set_parameter( yt_param_yt *param_yt );
+template <typename T>
+int  staging_user_param( const char *key, const int n, const T *input );
+int  staging_user_param_string( const char *key, const char *input );
+int  staging_inline();
+int  staging_serve();
+#endif
 #ifndef NO_PYTHON
 template <typename T>
 int  add_dict_scalar( PyObject *dict, const char *key, const T value );
 template <typename T>
 int  add_dict_vector3( PyObject *dict, const char *key, const T *vector );
 int  add_dict_string( PyObject *dict, const char *key, const char *string );
+PyObject *decode_hierarchy( PyObject *self, PyObject *args );
+PyObject *get_derived_field( PyObject *self, PyObject *args );
+PyObject *get_clumps( PyObject *self, PyObject *args );
+PyObject *get_covering_grid( PyObject *self, PyObject *args, PyObject *kwargs );
+PyObject *get_render( PyObject *self, PyObject *args, PyObject *kwargs );
+PyObject *get_sample( PyObject *self, PyObject *args, PyObject *kwargs );
+PyObject *get_ring_buffer( PyObject *self, PyObject *args, PyObject *kwargs );
+PyObject *parallel_map( PyObject *self, PyObject *args, PyObject *kwargs );
+int  output_pool_init();
+void output_pool_submit( PyObject *callable, PyObject *args );
+PyObject *submit_output( PyObject *self, PyObject *args );
+PyObject *new_param_yt_object();
+PyObject *get_decoded_field( PyObject *self, PyObject *args );
+void decode_cache_clear();
+int  export_grid_order();
+int  export_block_pools();
+void clear_block_pools();
+PyObject *get_grid_data( PyObject *self, PyObject *args );
+int  export_field_list();
+PyObject *field_key( const yt_grid *grid, const int v );
+int  init_gc_policy();
+void collect_garbage();
+void track_view( const long grid_id, const char *label, PyObject *view );
+int  release_views();
+int  watchdog_start( const double start );
+bool watchdog_stop();
+int  run_analysis_task();
+void analysis_task_free();
 #endif
 
 
@@ -18,12 +18,24 @@ typedef unsigned long int  ulong;
 // enumerate types
 enum yt_verbose { YT_VERBOSE_OFF=0, YT_VERBOSE_INFO=1, YT_VERBOSE_WARNING=2, YT_VERBOSE_DEBUG=3 };
 enum yt_ftype   { YT_FTYPE_UNKNOWN=0, YT_FLOAT=1, YT_DOUBLE=2 };
+enum yt_encoding { YT_ENCODING_NONE=0, YT_FIXED16=1, YT_BLOCK8=2 };
+enum yt_gc_policy  { YT_GC_FULL=0, YT_GC_GENERATIONAL=1, YT_GC_NONE=2, YT_GC_FREEZE=3 };
+enum yt_view_check { YT_VIEW_CHECK_OFF=0, YT_VIEW_CHECK_WARN=1, YT_VIEW_CHECK_ERROR=2 };
+enum yt_grid_order { YT_ORDER_HOST=0, YT_ORDER_MORTON=1, YT_ORDER_HILBERT=2 };
+enum yt_centering  { YT_CELL_CENTERED=0, YT_NODE_CENTERED=1, YT_FACE_CENTERED_X=2, YT_FACE_CENTERED_Y=3, YT_FACE_CENTERED_Z=4 };
 
 
 // structures
 #include "yt_type_param_libyt.h"
 #include "yt_type_param_yt.h"
+#include "yt_type_codec.h"
 #include "yt_type_grid.h"
+#include "yt_type_reduced_output.h"
+#include "yt_type_derived_field.h"
+#include "yt_type_grid_filter.h"
+#include "yt_type_block_pool.h"
+#include "yt_type_field.h"
+#include "yt_type_render.h"
 
 
 
@@ -0,0 +1,151 @@
+#ifndef __YT_TYPE_BLOCK_POOL_H__
+#define __YT_TYPE_BLOCK_POOL_H__
+
+
+
+/*******************************************************************************
+/
+/  yt_block_pool structure
+/
+/  ==> included by yt_type.h
+/
+********************************************************************************/
+
+
+// include relevant headers/prototypes
+#include "yt_macro.h"
+
+
+
+//-------------------------------------------------------------------------------------------------------
+// Structure   :  yt_block_pool
+// Description :  Data structure describing a pool of equal-sized blocks stored in a single array
+//
+// Data Member :  num_blocks     : Number of blocks
+//                block_dims     : Number of cells of each block along each direction
+//                first_id       : Grid ID of the first block ==> block "b" is grid "first_id + b"
+//                num_fields     : Number of fields
+//                field_labels   : Name of each field
+//                field_ftype    : Floating-point type of "data" ==> YT_FLOAT or YT_DOUBLE
+//                data           : Pointer to the pool
+//                block_stride   : Distance in elements between two consecutive blocks
+//                                 (0 ==> num_fields*block_dims[0]*block_dims[1]*block_dims[2])
+//                field_stride   : Distance in elements between two consecutive fields of a block
+//                                 (0 ==> block_dims[0]*block_dims[1]*block_dims[2])
+//                left_edge      : Left  edge of each block ==> [num_blocks][3]
+//                right_edge     : Right edge of each block ==> [num_blocks][3]
+//                level          : AMR level of each block  ==> [num_blocks]
+//                parent_id      : Parent grid ID of each block ==> [num_blocks] (NULL ==> -1 for all blocks)
+//                particle_count : Number of particles of each block ==> [num_blocks] (NULL ==> 0 for all blocks)
+//
+// Note        :  1. Data of field "v" of block "b" start at data + b*block_stride + v*field_stride and
+//                   are contiguous in the same order as yt_grid::field_data
+//                   ==> The default strides correspond to a C array [num_blocks][num_fields][cells]
+//                2. All arrays must remain valid until yt_inline() returns
+//
+// Method      :  yt_block_pool : Constructor
+//                validate      : Check if all data members have been set properly by users
+//-------------------------------------------------------------------------------------------------------
+struct yt_block_pool
+{
+
+// data members
+// ===================================================================================
+   long         num_blocks;
+   int          block_dims[3];
+   long         first_id;
+
+   int          num_fields;
+   const char **field_labels;
+   yt_ftype     field_ftype;
+
+   void        *data;
+   long         block_stride;
+   long         field_stride;
+
+   const double (*left_edge)[3];
+   const double (*right_edge)[3];
+   const int   *level;
+   const long  *parent_id;
+   const long  *particle_count;
+
+
+   //===================================================================================
+   // Method      :  yt_block_pool
+   // Description :  Constructor of the structure "yt_block_pool"
+   //
+   // Note        :  Initialize all data members
+   //
+   // Parameter   :  None
+   //===================================================================================
+   yt_block_pool()
+   {
+
+//    set defaults
+      num_blocks     = INT_UNDEFINED;
+      for (int d=0; d<3; d++) {
+      block_dims[d]  = INT_UNDEFINED; }
+      first_id       = INT_UNDEFINED;
+
+      num_fields     = INT_UNDEFINED;
+      field_labels   = NULL;
+      field_ftype    = YT_FTYPE_UNKNOWN;
+
+      data           = NULL;
+      block_stride   = 0;
+      field_stride   = 0;
+
+      left_edge      = NULL;
+      right_edge     = NULL;
+      level          = NULL;
+      parent_id      = NULL;
+      particle_count = NULL;
+
+   } // METHOD : yt_block_pool
+
+
+   //===================================================================================
+   // Method      :  validate
+   // Description :  Check if all data members have been set properly by users
+   //
+   // Note        :  1. Per-block metadata are checked by yt_add_grid()
+   //
+   // Parameter   :  None
+   //
+   // Return      :  YT_SUCCESS or YT_FAIL
+   //===================================================================================
+   int validate() const
+   {
+
+      if ( num_blocks   == INT_UNDEFINED    )   YT_ABORT( "\"%s\" has not been set!\n", "num_blocks" );
+      for (int d=0; d<3; d++) {
+      if ( block_dims[d] == INT_UNDEFINED   )   YT_ABORT( "\"%s[%d]\" has not been set!\n", "block_dims", d ); }
+      if ( first_id     == INT_UNDEFINED    )   YT_ABORT( "\"%s\" has not been set!\n", "first_id" );
+      if ( num_fields   == INT_UNDEFINED    )   YT_ABORT( "\"%s\" has not been set!\n", "num_fields" );
+      if ( field_labels == NULL             )   YT_ABORT( "\"%s\" has not been set!\n", "field_labels" );
+      if ( field_ftype  == YT_FTYPE_UNKNOWN )   YT_ABORT( "\"%s\" has not been set!\n", "field_ftype" );
+      if ( data         == NULL             )   YT_ABORT( "\"%s\" has not been set!\n", "data" );
+      if ( left_edge    == NULL             )   YT_ABORT( "\"%s\" has not been set!\n", "left_edge" );
+      if ( right_edge   == NULL             )   YT_ABORT( "\"%s\" has not been set!\n", "right_edge" );
+      if ( level        == NULL             )   YT_ABORT( "\"%s\" has not been set!\n", "level" );
+
+//    additional checks
+      if ( num_blocks   <  0                )   YT_ABORT( "\"%s\" == %ld < 0!\n", "num_blocks", num_blocks );
+      for (int d=0; d<3; d++) {
+      if ( block_dims[d] <= 0               )   YT_ABORT( "\"%s[%d]\" == %d <= 0!\n", "block_dims", d, block_dims[d] ); }
+      if ( first_id     <  0                )   YT_ABORT( "\"%s\" == %ld < 0!\n", "first_id", first_id );
+      if ( num_fields   <= 0                )   YT_ABORT( "\"%s\" == %d <= 0!\n", "num_fields", num_fields );
+      if ( block_stride <  0                )   YT_ABORT( "\"%s\" == %ld < 0!\n", "block_stride", block_stride );
+      if ( field_stride <  0                )   YT_ABORT( "\"%s\" == %ld < 0!\n", "field_stride", field_stride );
+      if ( field_ftype != YT_FLOAT  &&  field_ftype != YT_DOUBLE )
+         YT_ABORT( "Unknown \"%s\" == %d!\n", "field_ftype", field_ftype );
+
+      return YT_SUCCESS;
+
+   } // METHOD : validate
+
+}; // struct yt_block_pool
+
+
+
+#endif // #ifndef __YT_TYPE_BLOCK_POOL_H__
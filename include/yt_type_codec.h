@@ -0,0 +1,91 @@
+#ifndef __YT_TYPE_CODEC_H__
+#define __YT_TYPE_CODEC_H__
+
+
+
+/*******************************************************************************
+/
+/  yt_codec and yt_block8 structures
+/
+/  ==> included by yt_type.h
+/
+********************************************************************************/
+
+
+// include relevant headers/prototypes
+#include "yt_macro.h"
+
+
+
+//-------------------------------------------------------------------------------------------------------
+// Structure   :  yt_codec
+// Description :  Data structure describing how a field passed to yt_add_grid() is encoded
+//
+// Data Member :  encoding : Encoding of the field data
+//                           YT_ENCODING_NONE ==> plain array of "yt_grid::field_ftype"
+//                           YT_FIXED16       ==> 16-bit fixed point (unsigned short) with
+//                                                value = offset + scale*q
+//                           YT_BLOCK8        ==> array of "yt_block8" (see below)
+//                scale    : Scale of YT_FIXED16
+//                offset   : Offset of YT_FIXED16
+//
+// Note        :  1. Encoded fields are decoded to "yt_grid::field_ftype" on access
+//
+// Method      :  yt_codec : Constructor
+//-------------------------------------------------------------------------------------------------------
+struct yt_codec
+{
+
+// data members
+// ===================================================================================
+   yt_encoding encoding;
+   double      scale;
+   double      offset;
+
+
+   //===================================================================================
+   // Method      :  yt_codec
+   // Description :  Constructor of the structure "yt_codec"
+   //
+   // Note        :  Initialize all data members
+   //
+   // Parameter   :  None
+   //===================================================================================
+   yt_codec()
+   {
+
+//    set defaults
+      encoding = YT_ENCODING_NONE;
+      scale    = 1.0;
+      offset   = 0.0;
+
+   } // METHOD : yt_codec
+
+}; // struct yt_codec
+
+
+
+//-------------------------------------------------------------------------------------------------------
+// Structure   :  yt_block8
+// Description :  Block of the YT_BLOCK8 encoding
+//
+// Data Member :  base : Base value of the block
+//                step : Quantization step of the block
+//                q    : Quantized residuals ==> value[i] = base + step*q[i]
+//
+// Note        :  1. Cells are grouped into blocks of 8 consecutive cells in memory order
+//                   ==> ceil(number of cells/8) blocks per field (16 bytes per 8 cells)
+//                   ==> residuals beyond the last cell of the last block are ignored
+//-------------------------------------------------------------------------------------------------------
+struct yt_block8
+{
+
+   float       base;
+   float       step;
+   signed char q[8];
+
+}; // struct yt_block8
+
+
+
+#endif // #ifndef __YT_TYPE_CODEC_H__
@@ -0,0 +1,127 @@
+#ifndef __YT_TYPE_DERIVED_FIELD_H__
+#define __YT_TYPE_DERIVED_FIELD_H__
+
+
+
+/*******************************************************************************
+/
+/  yt_derived_field structure
+/
+/  ==> included by yt_type.h
+/
+********************************************************************************/
+
+
+// include relevant headers/prototypes
+#include "yt_macro.h"
+
+
+
+//-------------------------------------------------------------------------------------------------------
+// Structure   :  yt_derived_field
+// Description :  Data structure describing a derived field computed by a native kernel
+//
+// Data Member :  name         : Name of the derived field
+//                num_inputs   : Number of input fields
+//                input_labels : Name of each input field (must match "yt_grid.field_labels")
+//                output_ftype : Floating-point type of the output ==> YT_FLOAT or YT_DOUBLE
+//                kernel       : Function computing the derived field of "ncells" cells
+//                               ==> inputs[v][i] is cell i of input field v (in the type of "yt_grid.field_ftype")
+//                                   output[i]    is cell i of the derived field (in the type of "output_ftype")
+//                               ==> Must be thread-safe since it may be called concurrently on different
+//                                   segments of the same grid
+//
+// Method      :  yt_derived_field : Constructor
+//               ~yt_derived_field : Destructor
+//                validate         : Check if all data members have been set properly by users
+//-------------------------------------------------------------------------------------------------------
+struct yt_derived_field
+{
+
+// data members
+// ===================================================================================
+   const char  *name;
+
+   int          num_inputs;
+   const char **input_labels;
+
+   yt_ftype     output_ftype;
+   void       (*kernel)( const void **inputs, void *output, const long ncells );
+
+
+   //===================================================================================
+   // Method      :  yt_derived_field
+   // Description :  Constructor of the structure "yt_derived_field"
+   //
+   // Note        :  Initialize all data members
+   //
+   // Parameter   :  None
+   //===================================================================================
+   yt_derived_field()
+   {
+
+//    set defaults
+      name         = NULL;
+
+      num_inputs   = INT_UNDEFINED;
+      input_labels = NULL;
+
+      output_ftype = YT_FTYPE_UNKNOWN;
+      kernel       = NULL;
+
+   } // METHOD : yt_derived_field
+
+
+   //===================================================================================
+   // Method      :  ~yt_derived_field
+   // Description :  Destructor of the structure "yt_derived_field"
+   //
+   // Note        :  1. Not used currently
+   //                2. We do not free the pointer array "input_labels" here
+   //                   ==> It must be free'd by users
+   //
+   // Parameter   :  None
+   //===================================================================================
+   ~yt_derived_field()
+   {
+
+   } // METHOD : ~yt_derived_field
+
+
+   //===================================================================================
+   // Method      :  validate
+   // Description :  Check if all data members have been set properly by users
+   //
+   // Note        :  None
+   //
+   // Parameter   :  None
+   //
+   // Return      :  YT_SUCCESS or YT_FAIL
+   //===================================================================================
+   int validate() const
+   {
+
+      if ( name         == NULL             )   YT_ABORT( "\"%s\" has not been set!\n", "name" );
+      if ( num_inputs   == INT_UNDEFINED    )   YT_ABORT( "\"%s\" has not been set for derived field \"%s\"!\n", "num_inputs",   name );
+      if ( num_inputs   >  0  &&  input_labels == NULL )
+                                                YT_ABORT( "\"%s\" has not been set for derived field \"%s\"!\n", "input_labels", name );
+      if ( output_ftype == YT_FTYPE_UNKNOWN )   YT_ABORT( "\"%s\" has not been set for derived field \"%s\"!\n", "output_ftype", name );
+      if ( kernel       == NULL             )   YT_ABORT( "\"%s\" has not been set for derived field \"%s\"!\n", "kernel",       name );
+
+//    additional checks
+      if ( num_inputs < 0 )   YT_ABORT( "\"%s\" == %d < 0 for derived field \"%s\"!\n", "num_inputs", num_inputs, name );
+      if ( output_ftype != YT_FLOAT  &&  output_ftype != YT_DOUBLE )
+         YT_ABORT( "Unknown \"%s\" == %d for derived field \"%s\"!\n", "output_ftype", output_ftype, name );
+
+      for (int v=0; v<num_inputs; v++) {
+      if ( input_labels[v] == NULL )   YT_ABORT( "\"%s[%d]\" has not been set for derived field \"%s\"!\n", "input_labels", v, name ); }
+
+      return YT_SUCCESS;
+
+   } // METHOD : validate
+
+}; // struct yt_derived_field
+
+
+
+#endif // #ifndef __YT_TYPE_DERIVED_FIELD_H__
@@ -0,0 +1,92 @@
+#ifndef __YT_TYPE_FIELD_H__
+#define __YT_TYPE_FIELD_H__
+
+
+
+/*******************************************************************************
+/
+/  yt_field structure
+/
+/  ==> included by yt_type.h
+/
+********************************************************************************/
+
+
+// include relevant headers/prototypes
+#include "yt_macro.h"
+
+
+
+//-------------------------------------------------------------------------------------------------------
+// Structure   :  yt_field
+// Description :  Data structure describing a field declared by yt_declare_fields()
+//
+// Note        :  All declared fields share the floating-point type passed to yt_declare_fields()
+//
+// Data Member :  field_name      : Name of the field (e.g., density, temperature, ...)
+//                field_unit      : Unit of the field (NULL ==> dimensionless or in code units)
+//                field_centering : Location of the data in each cell
+//                                  YT_CELL_CENTERED ==> dimensions[0] x dimensions[1] x dimensions[2]
+//                                  YT_NODE_CENTERED ==> ( dimensions[d] + 1 ) along all directions
+//                                  YT_FACE_CENTERED_X/Y/Z ==> ( dimensions[d] + 1 ) along the direction d
+//
+// Method      :  yt_field : Constructor
+//                validate : Check if all data members have been set properly by users
+//-------------------------------------------------------------------------------------------------------
+struct yt_field
+{
+
+// data members
+// ===================================================================================
+   const char  *field_name;
+   const char  *field_unit;
+   yt_centering field_centering;
+
+
+   //===================================================================================
+   // Method      :  yt_field
+   // Description :  Constructor of the structure "yt_field"
+   //
+   // Note        :  Initialize all data members
+   //
+   // Parameter   :  None
+   //===================================================================================
+   yt_field()
+   {
+
+//    set defaults
+      field_name      = NULL;
+      field_unit      = NULL;
+      field_centering = YT_CELL_CENTERED;
+
+   } // METHOD : yt_field
+
+
+   //===================================================================================
+   // Method      :  validate
+   // Description :  Check if all data members have been set properly by users
+   //
+   // Note        :  None
+   //
+   // Parameter   :  None
+   //
+   // Return      :  YT_SUCCESS or YT_FAIL
+   //===================================================================================
+   int validate() const
+   {
+
+      if ( field_name == NULL )   YT_ABORT( "\"%s\" has not been set!\n", "field_name" );
+
+//    additional checks
+      if ( field_centering < YT_CELL_CENTERED  ||  field_centering > YT_FACE_CENTERED_Z )
+         YT_ABORT( "Unknown \"%s\" == %d for field \"%s\"!\n", "field_centering", field_centering, field_name );
+
+      return YT_SUCCESS;
+
+   } // METHOD : validate
+
+}; // struct yt_field
+
+
+
+#endif // #ifndef __YT_TYPE_FIELD_H__
@@ -27,6 +27,9 @@
 //                field_labels   : Name of each field (e.g., density, temperature, ...)
 //                field_data     : Pointer arrays pointing to the data of each field
 //                field_ftype    : Floating-point type of "field_data" ==> YT_FLOAT or YT_DOUBLE
+//                                 ==> Type of the decoded data for encoded fields
+//                field_codec    : Encoding of each field (NULL ==> no field is encoded)
+//                                 ==> see yt_type_codec.h
 //
 // Method      :  yt_grid  : Constructor
 //               ~yt_grid  : Destructor
@@ -51,6 +54,7 @@ struct yt_grid
    const char **field_labels;
    void       **field_data;
    yt_ftype     field_ftype;
+   const yt_codec *field_codec;
 
 
    //===================================================================================
@@ -81,6 +85,7 @@ struct yt_grid
       field_labels   = NULL;
       field_data     = NULL;
       field_ftype    = YT_FTYPE_UNKNOWN;
+      field_codec    = NULL;
 
    } // METHOD : yt_grid
 
@@ -140,6 +145,11 @@ struct yt_grid
       if ( num_fields <= 0 )      YT_ABORT( "\"%s\" == %d <= 0 for grid [%ld]!\n", "num_fields", num_fields, id );
       if ( field_ftype != YT_FLOAT  &&  field_ftype != YT_DOUBLE )
          YT_ABORT( "Unknown \"%s\" == %d for grid [%ld]!\n", "field_ftype", field_ftype, id );
+      if ( field_codec != NULL ) {
+      for (int v=0; v<num_fields; v++) {
+      if ( field_codec[v].encoding != YT_ENCODING_NONE  &&  field_codec[v].encoding != YT_FIXED16  &&
+           field_codec[v].encoding != YT_BLOCK8 )
+         YT_ABORT( "Unknown \"%s[%d].encoding\" == %d for grid [%ld]!\n", "field_codec", v, field_codec[v].encoding, id ); }}
 
       return YT_SUCCESS;
 
@@ -0,0 +1,126 @@
+#ifndef __YT_TYPE_GRID_FILTER_H__
+#define __YT_TYPE_GRID_FILTER_H__
+
+
+
+/*******************************************************************************
+/
+/  yt_grid_filter structure
+/
+/  ==> included by yt_type.h
+/
+********************************************************************************/
+
+
+// include relevant headers/prototypes
+#include "yt_macro.h"
+
+
+
+//-------------------------------------------------------------------------------------------------------
+// Structure   :  yt_grid_filter
+// Description :  Data structure selecting the grids and fields passed to the analysis
+//
+// Data Member :  min_level         : Minimum AMR level to be analyzed
+//                max_level         : Maximum AMR level to be analyzed (-1 ==> no limit)
+//                region_left_edge  : Left  edge of the region to be analyzed (unset ==> entire domain)
+//                region_right_edge : Right edge of the region to be analyzed (unset ==> entire domain)
+//                num_fields        : Number of fields to be analyzed (0 ==> all fields of each grid)
+//                field_labels      : Name of each field to be analyzed
+//
+// Note        :  1. Grids overlapping with the region are selected
+//
+// Method      :  yt_grid_filter : Constructor
+//               ~yt_grid_filter : Destructor
+//                validate       : Check if all data members have been set properly by users
+//-------------------------------------------------------------------------------------------------------
+struct yt_grid_filter
+{
+
+// data members
+// ===================================================================================
+   int          min_level;
+   int          max_level;
+   double       region_left_edge[3];
+   double       region_right_edge[3];
+
+   int          num_fields;
+   const char **field_labels;
+
+
+   //===================================================================================
+   // Method      :  yt_grid_filter
+   // Description :  Constructor of the structure "yt_grid_filter"
+   //
+   // Note        :  Initialize all data members
+   //
+   // Parameter   :  None
+   //===================================================================================
+   yt_grid_filter()
+   {
+
+//    set defaults
+      min_level    = 0;
+      max_level    = -1;
+      for (int d=0; d<3; d++) {
+      region_left_edge [d] = FLT_UNDEFINED;
+      region_right_edge[d] = FLT_UNDEFINED; }
+
+      num_fields   = 0;
+      field_labels = NULL;
+
+   } // METHOD : yt_grid_filter
+
+
+   //===================================================================================
+   // Method      :  ~yt_grid_filter
+   // Description :  Destructor of the structure "yt_grid_filter"
+   //
+   // Note        :  1. Not used currently
+   //                2. We do not free the pointer array "field_labels" here
+   //                   ==> It must be free'd by users
+   //
+   // Parameter   :  None
+   //===================================================================================
+   ~yt_grid_filter()
+   {
+
+   } // METHOD : ~yt_grid_filter
+
+
+   //===================================================================================
+   // Method      :  validate
+   // Description :  Check if all data members have been set properly by users
+   //
+   // Note        :  None
+   //
+   // Parameter   :  None
+   //
+   // Return      :  YT_SUCCESS or YT_FAIL
+   //===================================================================================
+   int validate() const
+   {
+
+      if ( min_level    <  0    )    YT_ABORT( "\"%s\" == %d < 0!\n", "min_level", min_level );
+      if ( max_level    >= 0  &&  max_level < min_level )
+                                     YT_ABORT( "\"%s\" == %d < \"%s\" == %d!\n", "max_level", max_level, "min_level", min_level );
+      if ( num_fields   <  0    )    YT_ABORT( "\"%s\" == %d < 0!\n", "num_fields", num_fields );
+      if ( num_fields   >  0  &&  field_labels == NULL )
+                                     YT_ABORT( "\"%s\" has not been set!\n", "field_labels" );
+
+      for (int d=0; d<3; d++) {
+      if (  ( region_left_edge[d] == FLT_UNDEFINED ) != ( region_right_edge[d] == FLT_UNDEFINED )  )
+         YT_ABORT( "\"%s[%d]\" and \"%s[%d]\" must be set together!\n", "region_left_edge", d, "region_right_edge", d );
+      if ( region_left_edge[d] != FLT_UNDEFINED  &&  region_left_edge[d] >= region_right_edge[d] )
+         YT_ABORT( "\"%s[%d]\" == %13.7e >= \"%s[%d]\" == %13.7e!\n",
+                   "region_left_edge", d, region_left_edge[d], "region_right_edge", d, region_right_edge[d] ); }
+
+      return YT_SUCCESS;
+
+   } // METHOD : validate
+
+}; // struct yt_grid_filter
+
+
+
+#endif // #ifndef __YT_TYPE_GRID_FILTER_H__
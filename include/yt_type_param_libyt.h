@@ -12,18 +12,101 @@
 ********************************************************************************/
 
 
+// include relevant headers/prototypes
+#include "yt_macro.h"
+
+
+
 //-------------------------------------------------------------------------------------------------------
 // Structure   :  yt_param_libyt
 // Description :  Data structure of libyt runtime parameters
 //
 // Data Member :  [public ] ==> Set by users when calling yt_init()
-//                verbose : Verbose level
-//                script  : Name of the YT inline analysis script (without the .py extension)
+//                verbose                    : Verbose level
+//                script                     : Name of the YT inline analysis script (without the .py extension)
+//                capture                    : Name of the file recording all API calls for yt_replay()
+//                                             (NULL ==> no capture)
+//                analysis_interval_step     : Perform analysis every N steps            (0    ==> disabled)
+//                analysis_interval_time     : Perform analysis every dt simulation time (0.0  ==> disabled)
+//                analysis_interval_walltime : Perform analysis every dt wall-clock time (0.0  ==> disabled)
+//                                             in seconds
+//                analysis_predicate         : Perform analysis if it returns non-zero   (NULL ==> disabled)
+//                                             ==> Arguments: step (i.e., counter) and simulation time
+//                ==> Analysis is performed if any of the enabled criteria is satisfied, or at every step if
+//                    none of them is enabled
+//                analysis_time_budget       : Abort the analysis script with KeyboardInterrupt if a single
+//                                             yt_inline() call exceeds it in seconds (0.0 ==> disabled)
+//                analysis_overhead_target   : Skip due analyses to keep the analysis wall time below this
+//                                             fraction of the total wall time   (0.0 ==> disabled)
+//                analysis_slice_time        : Keep resuming a generator returned by yt_inline() in the script
+//                                             until a step has spent this many seconds in it
+//                                             (0.0 ==> resume it once per step)
+//                compact_hierarchy          : Store libyt.hierarchy with integer cell indices and narrow
+//                                             integer types (21 instead of 88 bytes per grid)
+//                                             ==> Grid edges must be aligned with the cells on their level
+//                                             ==> "grid_left_edge" and "grid_right_edge" are decoded on access
+//                output_threads             : Number of workers executing libyt.submit_output() tasks
+//                                             (0 ==> execute tasks immediately)
+//                output_queue_size          : Maximum number of tasks waiting in the queue of the workers
+//                gc_policy                  : Garbage collection at the end of yt_inline()
+//                                             YT_GC_FULL         ==> full collection
+//                                             YT_GC_GENERATIONAL ==> collect the youngest generation only
+//                                             YT_GC_NONE         ==> rely on the automatic collection
+//                                             YT_GC_FREEZE       ==> freeze the heap at the end of yt_init()
+//                                                                    (e.g., yt modules), then full collection
+//                view_check                 : Action if Python still refers to a NumPy array wrapping the
+//                                             simulation data at the end of yt_inline()
+//                                             YT_VIEW_CHECK_OFF/WARN/ERROR ==> ignore/warn/return YT_FAIL
+//                num_analysis_ranks         : Reserve the last N ranks of MPI_COMM_WORLD for analysis (0 ==> disabled)
+//                                             ==> Requires compiling libyt with -DSUPPORT_MPI
+//                shm_name                   : Publish each analysis step to tool/libyt_server.py in the POSIX
+//                                             shared-memory segments "/<shm_name>.*" instead of running Python
+//                                             in this process (NULL ==> disabled)
+//                shm_slots                  : Number of steps that can wait for or be under analysis by the
+//                                             server (further steps are dropped)
+//                decode_cache_mb            : Memory cap in MB of the encoded fields decoded on access to
+//                                             libyt.grid_data (least recently used ones are evicted first)
+//                grid_order                 : Order of the grids in libyt.hierarchy and libyt.grid_data
+//                                             YT_ORDER_HOST    ==> IDs passed to yt_add_grid()
+//                                             YT_ORDER_MORTON  ==> Morton curve of the left edges
+//                                             YT_ORDER_HILBERT ==> Hilbert curve of the left edges
+//                                             ==> see libyt.grid_permutation for the host IDs
+//                ring_buffer_depth          : Default number of steps kept by each libyt.ring_buffer()
+//                ring_buffer_mb             : Memory cap in MB of all ring buffers
+//                parallel_workers           : Default number of worker processes of libyt.parallel_map()
+//                                             (0 ==> number of cores this process may run on)
 //
 //                [private] ==> Set and used by libyt internally
-//                libyt_initialized : true ==> yt_init() has been called successfully
-//                param_yt_set      : true ==> yt_set_parameter() has been called successfully
-//                grid_set[x]       : true ==> grid[x] has been loaded into libyt successfully
+//                libyt_initialized      : true ==> yt_init() has been called successfully
+//                param_yt_set           : true ==> yt_set_parameter() has been called successfully
+//                grid_set[x]            : true ==> grid[x] has been loaded into libyt successfully
+//                grids_committed        : true ==> the staged grids have been committed by commit_grids() and
+//                                         can be read by the native routines of the libyt module
+//                counter                : Number of times yt_inline() has been called
+//                reduced_output_set     : true ==> yt_set_reduced_output() has been called successfully
+//                analysis_decided       : true ==> whether to perform analysis at this step has been decided
+//                analysis_due           : true ==> perform analysis at this step
+//                analysis_queries       : Number of times yt_analysis_due() has been called at this step
+//                last_analysis_time     : Simulation time of the last analysis (FLT_UNDEFINED ==> none)
+//                last_analysis_walltime : Wall-clock time of the last analysis (FLT_UNDEFINED ==> none)
+//                last_time              : Simulation time passed to the last yt_set_parameter()
+//                analysis_stride        : Minimum number of steps between two analyses set by the overhead
+//                                         control (see "analysis_overhead_target")
+//                last_analysis_step     : Step (i.e., counter) of the last analysis (-1 ==> none)
+//                analysis_start_walltime: Wall-clock time when the analysis of this step was decided
+//                last_step_walltime     : Wall-clock time at the end of the last step (FLT_UNDEFINED ==> none)
+//                analysis_cost          : Running average of the wall time per analysis
+//                host_step_time         : Running average of the wall time per step excluding analysis
+//                staging                : true ==> this is a compute rank in the staging mode, which sends its grids
+//                                         to the analysis ranks instead of running Python
+//                analysis_rank          : true ==> this is an analysis rank in the staging mode
+//                external               : true ==> analysis steps are published to the shared-memory server
+//                forked_worker          : true ==> this process is a worker forked by libyt.parallel_map()
+//                                         ==> OpenMP is disabled since the thread pool is not inherited
+//                grid_filter_set        : true ==> yt_set_grid_filter() has been called successfully
+//                uniform_set            : true ==> yt_set_uniform_decomposition() has been called successfully
+//                uniform_blocks         : Number of blocks of the uniform decomposition along each direction
+//                uniform_block_dims     : Number of cells of each block along each direction
 //
 // Method      :  yt_param_libyt : Constructor
 //               ~yt_param_libyt : Destructor
@@ -35,14 +118,58 @@ struct yt_param_libyt
 // ===================================================================================
    yt_verbose verbose;
    const char *script;
+   const char *capture;
+
+   long   analysis_interval_step;
+   double analysis_interval_time;
+   double analysis_interval_walltime;
+   int  (*analysis_predicate)( const long step, const double time );
+   double analysis_time_budget;
+   double analysis_overhead_target;
+   double analysis_slice_time;
+   int    compact_hierarchy;
+   int    output_threads;
+   int    output_queue_size;
+   yt_gc_policy  gc_policy;
+   yt_view_check view_check;
+   int    num_analysis_ranks;
+   const char *shm_name;
+   int    shm_slots;
+   double decode_cache_mb;
+   yt_grid_order grid_order;
+   int    ring_buffer_depth;
+   double ring_buffer_mb;
+   int    parallel_workers;
 
 
 // private data members
 // ===================================================================================
-   bool  libyt_initialized;
-   bool  param_yt_set;
-   bool *grid_set;
-   long  counter;
+   bool   libyt_initialized;
+   bool   param_yt_set;
+   bool  *grid_set;
+   bool   grids_committed;
+   long   counter;
+   bool   reduced_output_set;
+   bool   analysis_decided;
+   bool   analysis_due;
+   int    analysis_queries;
+   double last_analysis_time;
+   double last_analysis_walltime;
+   double last_time;
+   long   analysis_stride;
+   long   last_analysis_step;
+   double analysis_start_walltime;
+   double last_step_walltime;
+   double analysis_cost;
+   double host_step_time;
+   bool   staging;
+   bool   analysis_rank;
+   bool   external;
+   bool   forked_worker;
+   bool   grid_filter_set;
+   bool   uniform_set;
+   int    uniform_blocks[3];
+   int    uniform_block_dims[3];
 
 
    //===================================================================================
@@ -59,11 +186,59 @@ struct yt_param_libyt
 //    set defaults
       verbose = YT_VERBOSE_WARNING;
       script  = "yt_inline_script";
+      capture = NULL;
+
+      analysis_interval_step     = 0;
+      analysis_interval_time     = 0.0;
+      analysis_interval_walltime = 0.0;
+      analysis_predicate         = NULL;
+      analysis_time_budget       = 0.0;
+      analysis_overhead_target   = 0.0;
+      analysis_slice_time        = 0.0;
+      compact_hierarchy          = 0;
+      output_threads             = 1;
+      output_queue_size          = 16;
+      gc_policy                  = YT_GC_FULL;
+      view_check                 = YT_VIEW_CHECK_WARN;
+      num_analysis_ranks         = 0;
+      shm_name                   = NULL;
+      shm_slots                  = 2;
+      decode_cache_mb            = 256.0;
+      grid_order                 = YT_ORDER_HOST;
+      ring_buffer_depth          = 16;
+      ring_buffer_mb             = 256.0;
+      parallel_workers           = 0;
+
+      libyt_initialized  = false;
+      param_yt_set       = false;
+      grid_set           = NULL;
+      grids_committed    = false;
+      counter            = 0;
+      reduced_output_set = false;
+      analysis_decided   = false;
+      analysis_due       = false;
+      analysis_queries   = 0;
+
+      last_analysis_time     = FLT_UNDEFINED;
+      last_analysis_walltime = FLT_UNDEFINED;
+      last_time              = FLT_UNDEFINED;
+
+      analysis_stride         = 1;
+      last_analysis_step      = -1;
+      analysis_start_walltime = FLT_UNDEFINED;
+      last_step_walltime      = FLT_UNDEFINED;
+      analysis_cost           = FLT_UNDEFINED;
+      host_step_time          = FLT_UNDEFINED;
 
-      libyt_initialized = false;
-      param_yt_set      = false;
-      grid_set          = NULL;
-      counter           = 0;
+      staging                 = false;
+      analysis_rank           = false;
+      external                = false;
+      forked_worker           = false;
+      grid_filter_set         = false;
+      uniform_set             = false;
+      for (int d=0; d<3; d++) {
+      uniform_blocks    [d]   = INT_UNDEFINED;
+      uniform_block_dims[d]   = INT_UNDEFINED; }
 
    } // METHOD : yt_param_libyt
 
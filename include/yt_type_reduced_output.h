@@ -0,0 +1,149 @@
+#ifndef __YT_TYPE_REDUCED_OUTPUT_H__
+#define __YT_TYPE_REDUCED_OUTPUT_H__
+
+
+
+/*******************************************************************************
+/
+/  yt_reduced_output structure
+/
+/  ==> included by yt_type.h
+/
+********************************************************************************/
+
+
+// include relevant headers/prototypes
+#include "yt_macro.h"
+
+
+
+//-------------------------------------------------------------------------------------------------------
+// Structure   :  yt_reduced_output
+// Description :  Data structure describing the reduced data products dumped by the libyt output stage
+//
+// Data Member :  basename          : Base name of the output files
+//                                    ==> "basename.ldat" stores the data chunks
+//                                        "basename.lidx" stores the memory-mappable chunk index
+//                interval          : Dump data every "interval" steps (i.e., calls of yt_inline())
+//                                    ==> Only at analysis steps, since grids are skipped by yt_add_grid() on
+//                                        other steps (e.g., every 6 steps for interval = 2 and
+//                                        "analysis_interval_step" = 3)
+//                num_fields        : Number of fields to be dumped (0 ==> all fields of each grid)
+//                field_labels      : Name of each field to be dumped
+//                min_level         : Minimum AMR level to be dumped
+//                max_level         : Maximum AMR level to be dumped (-1 ==> no limit)
+//                region_left_edge  : Left  edge of the region to be dumped (unset ==> entire domain)
+//                region_right_edge : Right edge of the region to be dumped (unset ==> entire domain)
+//                downsample        : Each output cell is the average of downsample^3 input cells
+//                queue_size        : Maximum number of chunks waiting in the queue of the I/O thread
+//
+// Method      :  yt_reduced_output : Constructor
+//               ~yt_reduced_output : Destructor
+//                validate          : Check if all data members have been set properly by users
+//-------------------------------------------------------------------------------------------------------
+struct yt_reduced_output
+{
+
+// data members
+// ===================================================================================
+   const char  *basename;
+   long         interval;
+
+   int          num_fields;
+   const char **field_labels;
+
+   int          min_level;
+   int          max_level;
+   double       region_left_edge[3];
+   double       region_right_edge[3];
+
+   int          downsample;
+   int          queue_size;
+
+
+   //===================================================================================
+   // Method      :  yt_reduced_output
+   // Description :  Constructor of the structure "yt_reduced_output"
+   //
+   // Note        :  Initialize all data members
+   //
+   // Parameter   :  None
+   //===================================================================================
+   yt_reduced_output()
+   {
+
+//    set defaults
+      basename     = "libyt_reduced";
+      interval     = 1;
+
+      num_fields   = 0;
+      field_labels = NULL;
+
+      min_level    = 0;
+      max_level    = -1;
+      for (int d=0; d<3; d++) {
+      region_left_edge [d] = FLT_UNDEFINED;
+      region_right_edge[d] = FLT_UNDEFINED; }
+
+      downsample   = 1;
+      queue_size   = 64;
+
+   } // METHOD : yt_reduced_output
+
+
+   //===================================================================================
+   // Method      :  ~yt_reduced_output
+   // Description :  Destructor of the structure "yt_reduced_output"
+   //
+   // Note        :  1. Not used currently
+   //                2. We do not free the pointer array "field_labels" here
+   //                   ==> It must be free'd by users
+   //
+   // Parameter   :  None
+   //===================================================================================
+   ~yt_reduced_output()
+   {
+
+   } // METHOD : ~yt_reduced_output
+
+
+   //===================================================================================
+   // Method      :  validate
+   // Description :  Check if all data members have been set properly by users
+   //
+   // Note        :  None
+   //
+   // Parameter   :  None
+   //
+   // Return      :  YT_SUCCESS or YT_FAIL
+   //===================================================================================
+   int validate() const
+   {
+
+      if ( basename     == NULL )    YT_ABORT( "\"%s\" has not been set!\n", "basename" );
+      if ( interval     <= 0    )    YT_ABORT( "\"%s\" == %ld <= 0!\n", "interval", interval );
+      if ( num_fields   <  0    )    YT_ABORT( "\"%s\" == %d < 0!\n", "num_fields", num_fields );
+      if ( num_fields   >  0  &&  field_labels == NULL )
+                                     YT_ABORT( "\"%s\" has not been set!\n", "field_labels" );
+      if ( min_level    <  0    )    YT_ABORT( "\"%s\" == %d < 0!\n", "min_level", min_level );
+      if ( max_level    >= 0  &&  max_level < min_level )
+                                     YT_ABORT( "\"%s\" == %d < \"%s\" == %d!\n", "max_level", max_level, "min_level", min_level );
+      if ( downsample   <= 0    )    YT_ABORT( "\"%s\" == %d <= 0!\n", "downsample", downsample );
+      if ( queue_size   <= 0    )    YT_ABORT( "\"%s\" == %d <= 0!\n", "queue_size", queue_size );
+
+      for (int d=0; d<3; d++) {
+      if (  ( region_left_edge[d] == FLT_UNDEFINED ) != ( region_right_edge[d] == FLT_UNDEFINED )  )
+         YT_ABORT( "\"%s[%d]\" and \"%s[%d]\" must be set together!\n", "region_left_edge", d, "region_right_edge", d );
+      if ( region_left_edge[d] != FLT_UNDEFINED  &&  region_left_edge[d] >= region_right_edge[d] )
+         YT_ABORT( "\"%s[%d]\" == %13.7e >= \"%s[%d]\" == %13.7e!\n",
+                   "region_left_edge", d, region_left_edge[d], "region_right_edge", d, region_right_edge[d] ); }
+
+      return YT_SUCCESS;
+
+   } // METHOD : validate
+
+}; // struct yt_reduced_output
+
+
+
+#endif // #ifndef __YT_TYPE_REDUCED_OUTPUT_H__
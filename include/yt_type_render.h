@@ -0,0 +1,133 @@
+#ifndef __YT_TYPE_RENDER_H__
+#define __YT_TYPE_RENDER_H__
+
+
+
+/*******************************************************************************
+/
+/  yt_render structure
+/
+/  ==> included by yt_type.h
+/
+********************************************************************************/
+
+
+// include relevant headers/prototypes
+#include "yt_macro.h"
+
+
+
+//-------------------------------------------------------------------------------------------------------
+// Structure   :  yt_render
+// Description :  Data structure describing an off-axis image rendered by ray_cast()
+//
+// Data Member :  center     : Center of the image plane
+//                normal     : Line of sight pointing toward the viewer ==> rays travel along -normal
+//                north      : Up direction of the image (made orthogonal to "normal")
+//                width      : Width of the rendered box along east, north, and normal
+//                resolution : Number of pixels along east and north
+//                field      : Name of the rendered field (a field passed to yt_add_grid() or a derived field)
+//                weight     : Name of the weight field (NULL ==> unweighted line integral)
+//                num_tf     : Number of bins of the transfer function (0 ==> line integral)
+//                tf_bounds  : Field range mapped to the transfer function
+//                tf_rgba    : Emission (r,g,b) and absorption (a) per unit length of each bin [num_tf][4]
+//                tf_log     : true ==> map log10 of the field to the transfer function
+//
+// Note        :  1. Line integral: image = int f dl or int f*w dl / int w dl
+//                2. Transfer function: front-to-back emission/absorption
+//                   ==> image = (r,g,b,alpha) with alpha = 1 - transmittance
+//
+// Method      :  yt_render : Constructor
+//                validate  : Check if all data members have been set properly
+//-------------------------------------------------------------------------------------------------------
+struct yt_render
+{
+
+// data members
+// ===================================================================================
+   double        center[3];
+   double        normal[3];
+   double        north[3];
+   double        width[3];
+   int           resolution[2];
+
+   const char   *field;
+   const char   *weight;
+
+   int           num_tf;
+   double        tf_bounds[2];
+   const double *tf_rgba;
+   bool          tf_log;
+
+
+   //===================================================================================
+   // Method      :  yt_render
+   // Description :  Constructor of the structure "yt_render"
+   //
+   // Note        :  Initialize all data members
+   //
+   // Parameter   :  None
+   //===================================================================================
+   yt_render()
+   {
+
+//    set defaults
+      for (int d=0; d<3; d++) {
+      center[d]     = FLT_UNDEFINED;
+      normal[d]     = FLT_UNDEFINED;
+      north [d]     = FLT_UNDEFINED;
+      width [d]     = FLT_UNDEFINED; }
+      for (int d=0; d<2; d++) {
+      resolution[d] = INT_UNDEFINED; }
+
+      field         = NULL;
+      weight        = NULL;
+
+      num_tf        = 0;
+      tf_bounds[0]  = FLT_UNDEFINED;
+      tf_bounds[1]  = FLT_UNDEFINED;
+      tf_rgba       = NULL;
+      tf_log        = false;
+
+   } // METHOD : yt_render
+
+
+   //===================================================================================
+   // Method      :  validate
+   // Description :  Check if all data members have been set properly
+   //
+   // Note        :  None
+   //
+   // Parameter   :  None
+   //
+   // Return      :  YT_SUCCESS or YT_FAIL
+   //===================================================================================
+   int validate() const
+   {
+
+      for (int d=0; d<3; d++) {
+      if ( center[d]     == FLT_UNDEFINED )   YT_ABORT( "\"%s[%d]\" has not been set!\n", "center", d );
+      if ( normal[d]     == FLT_UNDEFINED )   YT_ABORT( "\"%s[%d]\" has not been set!\n", "normal", d );
+      if ( north [d]     == FLT_UNDEFINED )   YT_ABORT( "\"%s[%d]\" has not been set!\n", "north",  d );
+      if ( width [d]     <= 0.0           )   YT_ABORT( "\"%s[%d]\" == %13.7e <= 0!\n", "width", d, width[d] ); }
+      for (int d=0; d<2; d++) {
+      if ( resolution[d] <= 0             )   YT_ABORT( "\"%s[%d]\" == %d <= 0!\n", "resolution", d, resolution[d] ); }
+      if ( field         == NULL          )   YT_ABORT( "\"%s\" has not been set!\n", "field" );
+
+      if ( num_tf < 0 )                       YT_ABORT( "\"%s\" == %d < 0!\n", "num_tf", num_tf );
+      if ( num_tf > 0 )
+      {
+         if ( tf_rgba == NULL )               YT_ABORT( "\"%s\" has not been set!\n", "tf_rgba" );
+         if ( !( tf_bounds[0] < tf_bounds[1] ) )
+            YT_ABORT( "\"%s\" == [%13.7e, %13.7e] is empty!\n", "tf_bounds", tf_bounds[0], tf_bounds[1] );
+      }
+
+      return YT_SUCCESS;
+
+   } // METHOD : validate
+
+}; // struct yt_render
+
+
+
+#endif // #ifndef __YT_TYPE_RENDER_H__
@@ -9,6 +9,7 @@
 //
 // Note        :  1. Called by yt_set_parameter()
 //                2. These NumPy array will be set when calling yt_add_grid()
+//                3. Use a compact representation if "g_param_libyt.compact_hierarchy" is on
 //
 // Parameter   :  None
 //
@@ -23,9 +24,6 @@ int allocate_hierarchy()
    {
       PyDict_Clear( g_py_hierarchy );
       log_warning( "Removing existing key-value pairs in libyt.hierarchy ... done\n" );
-
-//    also delete the grid status table allocated previously
-      delete [] g_param_libyt.grid_set;
    }
 
 
@@ -47,22 +45,33 @@ int allocate_hierarchy()
       Py_DECREF( py_obj );                                                             \
    }
 
+// compact representation (21 bytes per grid): integer offsets of the left edges from the parent grids in
+// units of the cell size on the level of each grid instead of double edges
+// ==> "grid_left_index", "grid_left_edge", and "grid_right_edge" are decoded only when they are accessed
+//     (see decode_hierarchy())
+   if ( g_param_libyt.compact_hierarchy )
+   {
+   ADD_DICT( 3, "grid_parent_offset",  NPY_UINT16 );
+   ADD_DICT( 3, "grid_dimensions",     NPY_UINT16 );
+   ADD_DICT( 1, "grid_particle_count", NPY_INT32  );
+   ADD_DICT( 1, "grid_parent_id",      NPY_INT32  );
+   ADD_DICT( 1, "grid_levels",         NPY_INT8   );
+   }
+
+// default representation (88 bytes per grid)
+   else
+   {
    ADD_DICT( 3, "grid_left_edge",      NPY_DOUBLE );
    ADD_DICT( 3, "grid_right_edge",     NPY_DOUBLE );
    ADD_DICT( 3, "grid_dimensions",     NPY_LONG );
    ADD_DICT( 1, "grid_particle_count", NPY_LONG );
    ADD_DICT( 1, "grid_parent_id",      NPY_LONG );
    ADD_DICT( 1, "grid_levels",         NPY_LONG );
+   }
 
 #  undef ADD_DICT
 
 
-// allocate and initialize the table recording the status of each grid
-   g_param_libyt.grid_set = new bool [ g_param_yt.num_grids ];
-
-   for (int g=0; g<g_param_yt.num_grids; g++)   g_param_libyt.grid_set[g] = false;
-
-
    return YT_SUCCESS;
 
 } // FUNCTION : allocate_hierarchy
@@ -0,0 +1,166 @@
+#define NO_PYTHON
+#include "yt_combo.h"
+#undef NO_PYTHON
+#include <math.h>
+
+
+// weight of the latest measurement in the running averages of the analysis cost and host step time
+static const double AverageWeight = 0.3;
+
+
+
+
+//-------------------------------------------------------------------------------------------------------
+// Function    :  decide_analysis
+// Description :  Decide whether to perform analysis at this step
+//
+// Note        :  1. Called by yt_analysis_due() and yt_set_parameter()
+//                2. The decision is made only once per step and is reset by yt_inline()
+//                   ==> yt_set_parameter(), yt_add_user_parameter_*(), yt_add_grid(), and yt_inline()
+//                       become no-ops on the steps without analysis
+//                   ==> yt_inline() must therefore be called on every step, including the steps without
+//                       analysis, otherwise the decision and the step counter are never renewed
+//                3. Analysis is due if any of the enabled criteria in "g_param_libyt" is satisfied, or at
+//                   every step if none of them is enabled
+//                4. If "time" is unknown (i.e., called by yt_analysis_due() before yt_set_parameter()),
+//                   the simulation time passed to the last yt_set_parameter() is used instead
+//                5. A due analysis is postponed if fewer than "g_param_libyt.analysis_stride" steps have passed
+//                   since the last analysis (see end_analysis_step())
+//
+// Parameter   :  time : Current simulation time (FLT_UNDEFINED ==> unknown)
+//
+// Return      :  true/false ==> perform/skip analysis at this step
+//-------------------------------------------------------------------------------------------------------
+bool decide_analysis( const double time )
+{
+
+   if ( g_param_libyt.analysis_decided )   return g_param_libyt.analysis_due;
+
+   const long   step     = g_param_libyt.counter;
+   const double sim_time = ( time == FLT_UNDEFINED ) ? g_param_libyt.last_time : time;
+   bool enabled = false, due = false;
+
+// 1. every N steps
+   if ( g_param_libyt.analysis_interval_step > 0 )
+   {
+      enabled = true;
+      if ( step % g_param_libyt.analysis_interval_step == 0 )   due = true;
+   }
+
+// 2. every dt simulation time
+   if ( g_param_libyt.analysis_interval_time > 0.0 )
+   {
+      enabled = true;
+      if ( g_param_libyt.last_analysis_time == FLT_UNDEFINED  ||  sim_time == FLT_UNDEFINED  ||
+           sim_time >= g_param_libyt.last_analysis_time + g_param_libyt.analysis_interval_time )   due = true;
+   }
+
+// 3. every dt wall-clock time
+   if ( g_param_libyt.analysis_interval_walltime > 0.0 )
+   {
+      enabled = true;
+      if ( g_param_libyt.last_analysis_walltime == FLT_UNDEFINED  ||
+           get_wall_time() >= g_param_libyt.last_analysis_walltime + g_param_libyt.analysis_interval_walltime )   due = true;
+   }
+
+// 4. user-provided predicate
+   if ( g_param_libyt.analysis_predicate != NULL )
+   {
+      enabled = true;
+      if ( g_param_libyt.analysis_predicate( step, sim_time ) )   due = true;
+   }
+
+   if ( !enabled )   due = true;
+
+// 5. throttled by the overhead control
+   if ( due  &&  g_param_libyt.last_analysis_step >= 0  &&
+        step - g_param_libyt.last_analysis_step < g_param_libyt.analysis_stride )
+   {
+      due = false;
+      log_debug( "Analysis at step [%ld] is postponed by the overhead control (stride = %ld)\n",
+                 step, g_param_libyt.analysis_stride );
+   }
+
+// 6. all compute ranks must agree in the staging mode
+#  ifdef SUPPORT_MPI
+   if ( g_param_libyt.staging )   due = staging_agree( due );
+#  endif
+
+   g_param_libyt.analysis_decided = true;
+   g_param_libyt.analysis_due     = due;
+
+   if ( due )   g_param_libyt.analysis_start_walltime = get_wall_time();
+
+   log_debug( "Analysis at step [%ld] ... %s\n", step, due ? "due" : "skipped" );
+
+   return due;
+
+} // FUNCTION : decide_analysis
+
+
+
+//-------------------------------------------------------------------------------------------------------
+// Function    :  end_analysis_step
+// Description :  Record the analysis of this step and reset the decision for the next step
+//
+// Note        :  1. Called by yt_inline() on every step, with or without analysis
+//                2. Measure the analysis cost and host step time, and adjust "g_param_libyt.analysis_stride"
+//                   so that analysis_cost / ( stride*host_step_time + analysis_cost ) stays below
+//                   "g_param_libyt.analysis_overhead_target"
+//                   ==> The stride is doubled at least if an analysis exceeds "analysis_time_budget"
+//
+// Parameter   :  None
+//
+// Return      :  None
+//-------------------------------------------------------------------------------------------------------
+void end_analysis_step()
+{
+
+   const double now  = get_wall_time();
+   const double cost = ( g_param_libyt.analysis_due ) ? now - g_param_libyt.analysis_start_walltime : 0.0;
+
+#  define AVERAGE( avg, value )   (  ( (avg) == FLT_UNDEFINED ) ? (value) : (1.0-AverageWeight)*(avg) + AverageWeight*(value)  )
+
+// host step time excluding analysis
+   if ( g_param_libyt.last_step_walltime != FLT_UNDEFINED )
+      g_param_libyt.host_step_time = AVERAGE( g_param_libyt.host_step_time,
+                                              MAX( 0.0, now - g_param_libyt.last_step_walltime - cost ) );
+
+   g_param_libyt.last_step_walltime = now;
+
+   if ( g_param_libyt.analysis_due )
+   {
+      g_param_libyt.last_analysis_time     = g_param_libyt.last_time;
+      g_param_libyt.last_analysis_walltime = now;
+      g_param_libyt.last_analysis_step     = g_param_libyt.counter;
+      g_param_libyt.analysis_cost          = AVERAGE( g_param_libyt.analysis_cost, cost );
+
+//    adjust the stride
+      const double target = g_param_libyt.analysis_overhead_target;
+      long         stride = 1;
+
+      if ( target > 0.0  &&  g_param_libyt.host_step_time != FLT_UNDEFINED  &&  g_param_libyt.host_step_time > 0.0 )
+         stride = MAX( 1L, (long)ceil( g_param_libyt.analysis_cost*(1.0-target) / (target*g_param_libyt.host_step_time) ) );
+
+      if ( g_param_libyt.analysis_time_budget > 0.0  &&  cost > g_param_libyt.analysis_time_budget )
+         stride = MAX( stride, 2*g_param_libyt.analysis_stride );
+
+      g_param_libyt.analysis_stride = stride;
+
+      if ( g_param_libyt.host_step_time == FLT_UNDEFINED )
+         log_info( "Analysis at step [%ld] took %.3f s\n", g_param_libyt.counter, cost );
+      else
+         log_info( "Analysis at step [%ld] took %.3f s (average %.3f s, host step %.3f s, overhead %.1f%%) ==> stride = %ld\n",
+                   g_param_libyt.counter, cost, g_param_libyt.analysis_cost, g_param_libyt.host_step_time,
+                   100.0*g_param_libyt.analysis_cost / ( g_param_libyt.analysis_stride*g_param_libyt.host_step_time +
+                                                         g_param_libyt.analysis_cost ),
+                   g_param_libyt.analysis_stride );
+   }
+
+#  undef AVERAGE
+
+   g_param_libyt.analysis_decided = false;
+   g_param_libyt.analysis_due     = false;
+   g_param_libyt.analysis_queries = 0;
+
+} // FUNCTION : end_analysis_step
@@ -0,0 +1,213 @@
+#include "yt_combo.h"
+
+
+
+
+// generator returned by yt_inline() in the script and its progress
+static PyObject *Task         = NULL;
+static long      Task_Steps   = 0;
+static long      Task_Slices  = 0;
+static double    Task_Time    = 0.0;
+
+static void set_task_status( PyObject *py_progress, PyObject *py_slice_times, const double step_time );
+
+
+
+
+//-------------------------------------------------------------------------------------------------------
+// Function    :  run_analysis_task
+// Description :  Call yt_inline() in the analysis script, or resume the generator it returned at an
+//                earlier step
+//
+// Note        :  1. Called by yt_inline() with the GIL held
+//                2. If yt_inline() in the script is a generator function, the returned generator is kept
+//                   across steps and each step runs only a slice of it:
+//
+//                   def yt_inline():
+//                      level = 0
+//                      while True:
+//                         ds = yt.frontends.libyt.libytDataset()    # rebuild after every yield
+//                         # ... part of the work, results copied out of the grid data
+//                         level += 1
+//                         yield level                               # progress
+//
+//                   ==> The generator is resumed once per step, or until "g_param_libyt.analysis_slice_time"
+//                       seconds have been spent in it at this step
+//                   ==> Each slice sees the grids of the step it runs at, since libyt.hierarchy, libyt.grid_data,
+//                       and the grid IDs are rebuilt at every step
+//                   ==> Local variables of the generator persist across steps, but must not hold a dataset,
+//                       grid IDs, or arrays of libyt.grid_data across a yield (see release_views())
+//                   ==> A new generator is created at the step after the previous one is exhausted
+//                3. Progress (the last yielded value) and timing are stored in libyt.analysis_task
+//                4. An exception raised by the script (including the KeyboardInterrupt of the watchdog)
+//                   drops the generator
+//
+// Parameter   :  None
+//
+// Return      :  0 on success, or -1 if the script raised an exception (already printed)
+//-------------------------------------------------------------------------------------------------------
+int run_analysis_task()
+{
+
+   const double start = get_wall_time();
+
+// call yt_inline() in the script
+   if ( Task == NULL )
+   {
+      PyObject *py_script = PyImport_ImportModule( g_param_libyt.script );
+      PyObject *py_result = ( py_script == NULL ) ? NULL : PyObject_CallMethod( py_script, (char*)"yt_inline", NULL );
+
+      Py_XDECREF( py_script );
+
+      if ( py_result == NULL )
+      {
+         PyErr_Print();
+         return -1;
+      }
+
+      if ( !PyGen_Check( py_result ) )
+      {
+         Py_DECREF( py_result );
+         return 0;
+      }
+
+      Task        = py_result;
+      Task_Steps  = 0;
+      Task_Slices = 0;
+      Task_Time   = 0.0;
+
+      log_info( "Starting the incremental analysis task ...\n" );
+   }
+
+
+// resume the generator until it yields after the slice time or is exhausted
+   PyObject *py_progress    = NULL;
+   PyObject *py_slice_times = PyList_New( 0 );
+   bool      finished       = false;
+   int       status         = 0;
+
+   while ( true )
+   {
+      const double slice_start = get_wall_time();
+      PyObject    *py_item     = PyIter_Next( Task );
+
+      PyObject *py_slice_time = PyFloat_FromDouble( get_wall_time() - slice_start );
+      PyList_Append( py_slice_times, py_slice_time );
+      Py_DECREF( py_slice_time );
+
+      if ( py_item == NULL )
+      {
+         finished = true;
+
+         if ( PyErr_Occurred() )
+         {
+            PyErr_Print();
+            status = -1;
+         }
+
+         break;
+      }
+
+      Py_XDECREF( py_progress );
+      py_progress = py_item;
+      Task_Slices ++;
+
+      if ( g_param_libyt.analysis_slice_time <= 0.0  ||
+           get_wall_time() - start >= g_param_libyt.analysis_slice_time )   break;
+   }
+
+   const double step_time = get_wall_time() - start;
+
+   Task_Steps ++;
+   Task_Time += step_time;
+
+   if ( finished )
+   {
+      Py_CLEAR( Task );
+
+      log_info( "Incremental analysis task %s after %ld step(s), %ld slice(s), %.3f s\n",
+                ( status == 0 ) ? "finished" : "failed", Task_Steps, Task_Slices, Task_Time );
+   }
+   else
+      log_debug( "Resuming the incremental analysis task ... %ld slice(s) in %.3f s\n",
+                 PyList_GET_SIZE( py_slice_times ), step_time );
+
+   set_task_status( py_progress, py_slice_times, step_time );
+
+   Py_XDECREF( py_progress );
+   Py_DECREF( py_slice_times );
+
+   return status;
+
+} // FUNCTION : run_analysis_task
+
+
+
+//-------------------------------------------------------------------------------------------------------
+// Function    :  set_task_status
+// Description :  Store the progress of the incremental analysis task in the dictionary libyt.analysis_task
+//
+// Note        :  1. Keys:
+//                   "active"      : True if the generator will be resumed at the next step
+//                   "progress"    : Last value yielded by the generator (None if not yielded yet)
+//                   "steps"       : Number of steps the generator has run
+//                   "slices"      : Number of slices (i.e., yields) so far
+//                   "slice_times" : Wall time of each slice at this step in seconds
+//                   "step_time"   : Wall time spent in the generator at this step in seconds
+//                   "total_time"  : Wall time spent in the generator so far in seconds
+//
+// Parameter   :  py_progress    : Last yielded value (NULL ==> None)
+//                py_slice_times : List of the wall time of each slice at this step
+//                step_time      : Wall time spent at this step
+//
+// Return      :  None
+//-------------------------------------------------------------------------------------------------------
+static void set_task_status( PyObject *py_progress, PyObject *py_slice_times, const double step_time )
+{
+
+   PyObject *py_status = PyObject_GetAttrString( PyImport_AddModule( "libyt" ), "analysis_task" );
+
+   if ( py_status == NULL )
+   {
+      PyErr_Clear();
+      return;
+   }
+
+   PyObject *py_value;
+
+   PyDict_SetItemString( py_status, "active",      ( Task != NULL ) ? Py_True : Py_False );
+   PyDict_SetItemString( py_status, "progress",    ( py_progress != NULL ) ? py_progress : Py_None );
+   PyDict_SetItemString( py_status, "slice_times", py_slice_times );
+
+   py_value = PyLong_FromLong( Task_Steps );      PyDict_SetItemString( py_status, "steps",      py_value );   Py_DECREF( py_value );
+   py_value = PyLong_FromLong( Task_Slices );     PyDict_SetItemString( py_status, "slices",     py_value );   Py_DECREF( py_value );
+   py_value = PyFloat_FromDouble( step_time );    PyDict_SetItemString( py_status, "step_time",  py_value );   Py_DECREF( py_value );
+   py_value = PyFloat_FromDouble( Task_Time );    PyDict_SetItemString( py_status, "total_time", py_value );   Py_DECREF( py_value );
+
+   Py_DECREF( py_status );
+
+} // FUNCTION : set_task_status
+
+
+
+//-------------------------------------------------------------------------------------------------------
+// Function    :  analysis_task_free
+// Description :  Drop the unfinished incremental analysis task
+//
+// Note        :  1. Called by yt_finalize() before Py_Finalize()
+//                2. The generator is closed, so "finally" blocks and context managers in it are executed
+//
+// Parameter   :  None
+//
+// Return      :  None
+//-------------------------------------------------------------------------------------------------------
+void analysis_task_free()
+{
+
+   if ( Task == NULL )   return;
+
+   log_info( "Dropping the unfinished incremental analysis task after %ld step(s) ...\n", Task_Steps );
+
+   Py_CLEAR( Task );
+
+} // FUNCTION : analysis_task_free
@@ -0,0 +1,138 @@
+#include "yt_combo.h"
+#include <pthread.h>
+#include <errno.h>
+#include <math.h>
+
+
+
+
+// internal states of the watchdog
+// ==> lock order: GIL first, then "Watchdog_Mutex"
+static pthread_t       Watchdog;
+static pthread_mutex_t Watchdog_Mutex   = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t  Watchdog_Cond    = PTHREAD_COND_INITIALIZER;
+static bool            Watchdog_Active  = false;   // watchdog thread has been launched
+static bool            Script_Running   = false;   // analysis script is still running
+static bool            Watchdog_Fired   = false;   // async exception has been raised
+static long            Main_Thread_ID   = 0;
+static double          Deadline         = 0.0;
+
+static void *watchdog_main( void *arg );
+
+
+
+
+//-------------------------------------------------------------------------------------------------------
+// Function    :  watchdog_start
+// Description :  Launch a watchdog aborting the analysis script if it exceeds the time budget
+//
+// Note        :  1. Called by yt_inline() right before executing the analysis script, with the GIL held
+//                2. Do nothing if "g_param_libyt.analysis_time_budget" is disabled
+//                3. The budget is measured from the beginning of yt_inline()
+//
+// Parameter   :  start : Wall-clock time when yt_inline() was called
+//
+// Return      :  YT_SUCCESS or YT_FAIL
+//-------------------------------------------------------------------------------------------------------
+int watchdog_start( const double start )
+{
+
+   if ( g_param_libyt.analysis_time_budget <= 0.0 )   return YT_SUCCESS;
+
+   Main_Thread_ID  = PyThreadState_Get()->thread_id;
+   Deadline        = start + g_param_libyt.analysis_time_budget;
+   Script_Running  = true;
+   Watchdog_Fired  = false;
+
+   if ( pthread_create( &Watchdog, NULL, watchdog_main, NULL ) != 0 )
+      YT_ABORT( "Launching the analysis watchdog ... failed!\n" );
+
+   Watchdog_Active = true;
+
+   return YT_SUCCESS;
+
+} // FUNCTION : watchdog_start
+
+
+
+//-------------------------------------------------------------------------------------------------------
+// Function    :  watchdog_stop
+// Description :  Terminate the watchdog launched by watchdog_start()
+//
+// Note        :  1. Called by yt_inline() right after executing the analysis script, with the GIL held
+//                2. Clear the async exception if it has been raised but not delivered yet
+//
+// Parameter   :  None
+//
+// Return      :  true ==> the watchdog has aborted the analysis script
+//-------------------------------------------------------------------------------------------------------
+bool watchdog_stop()
+{
+
+   if ( !Watchdog_Active )   return false;
+
+   pthread_mutex_lock( &Watchdog_Mutex );
+   Script_Running = false;
+   pthread_cond_signal( &Watchdog_Cond );
+   pthread_mutex_unlock( &Watchdog_Mutex );
+
+// release the GIL since the watchdog may be waiting for it
+   Py_BEGIN_ALLOW_THREADS
+   pthread_join( Watchdog, NULL );
+   Py_END_ALLOW_THREADS
+
+   Watchdog_Active = false;
+
+   if ( Watchdog_Fired )   PyThreadState_SetAsyncExc( Main_Thread_ID, NULL );
+
+   return Watchdog_Fired;
+
+} // FUNCTION : watchdog_stop
+
+
+
+//-------------------------------------------------------------------------------------------------------
+// Function    :  watchdog_main
+// Description :  Main routine of the watchdog thread
+//
+// Note        :  1. Sleep until the deadline or until the script finishes
+//                2. At the deadline, raise KeyboardInterrupt asynchronously in the main thread
+//                   ==> It is delivered at the next Python bytecode boundary. Long-running C extensions
+//                       (e.g., a single NumPy call) cannot be interrupted.
+//
+// Parameter   :  arg : Not used
+//
+// Return      :  NULL
+//-------------------------------------------------------------------------------------------------------
+static void *watchdog_main( void *arg )
+{
+
+   timespec deadline;
+   deadline.tv_sec  = (time_t)Deadline;
+   deadline.tv_nsec = (long)( ( Deadline - floor(Deadline) )*1.0e9 );
+
+// wait until the deadline
+   bool timeout = false;
+
+   pthread_mutex_lock( &Watchdog_Mutex );
+   while ( Script_Running  &&  !timeout )
+      timeout = ( pthread_cond_timedwait( &Watchdog_Cond, &Watchdog_Mutex, &deadline ) == ETIMEDOUT );
+   pthread_mutex_unlock( &Watchdog_Mutex );
+
+   if ( !timeout )   return NULL;
+
+
+// abort the script if it is still running
+   yt_gil_guard gil;
+
+   pthread_mutex_lock( &Watchdog_Mutex );
+   if ( Script_Running )
+   {
+      PyThreadState_SetAsyncExc( Main_Thread_ID, PyExc_KeyboardInterrupt );
+      Watchdog_Fired = true;
+   }
+   pthread_mutex_unlock( &Watchdog_Mutex );
+
+   return NULL;
+
+} // FUNCTION : watchdog_main
@@ -0,0 +1,235 @@
+#include "yt_combo.h"
+#include <string.h>
+
+
+// block pools registered by yt_add_block_pool() at this step
+// ==> "field_data" stores num_blocks*num_fields pointers derived from the strides and is owned by libyt
+struct block_pool_entry
+{
+   yt_block_pool   pool;
+   char          **field_labels;
+   void          **field_data;
+};
+
+static block_pool_entry *Pools     = NULL;
+static int               NPool     = 0;
+static int               NPoolSize = 0;
+
+
+
+
+//-------------------------------------------------------------------------------------------------------
+// Function    :  block_pool_register
+// Description :  Store a block pool and derive the pointer of each field of each block
+//
+// Note        :  1. Called by yt_add_block_pool()
+//                2. Not thread-safe
+//                3. Pools of the previous steps are released by begin_step() and reset_step()
+//                4. Field labels are copied, while the data and the per-block metadata are not
+//
+// Parameter   :  pool : Target block pool
+//
+// Return      :  Pointer array of size num_blocks*num_fields
+//                ==> Pointers of block "b" start at index b*num_fields
+//-------------------------------------------------------------------------------------------------------
+void **block_pool_register( const yt_block_pool *pool )
+{
+
+   if ( NPool == NPoolSize )
+   {
+      NPoolSize = ( NPoolSize == 0 ) ? 4 : 2*NPoolSize;
+      Pools     = (block_pool_entry*)realloc( Pools, NPoolSize*sizeof(block_pool_entry) );
+   }
+
+   block_pool_entry *entry = Pools + NPool;
+   NPool ++;
+
+   const long cells        = (long)pool->block_dims[0]*pool->block_dims[1]*pool->block_dims[2];
+   const long field_stride = ( pool->field_stride > 0 ) ? pool->field_stride : cells;
+   const long block_stride = ( pool->block_stride > 0 ) ? pool->block_stride : pool->num_fields*cells;
+   const int  elem_size    = ( pool->field_ftype == YT_FLOAT ) ? sizeof(float) : sizeof(double);
+
+   entry->pool              = *pool;
+   entry->pool.field_stride = field_stride;
+   entry->pool.block_stride = block_stride;
+
+   entry->field_labels = new char* [pool->num_fields];
+   for (int v=0; v<pool->num_fields; v++)
+   {
+      entry->field_labels[v] = new char [ strlen( pool->field_labels[v] ) + 1 ];
+      strcpy( entry->field_labels[v], pool->field_labels[v] );
+   }
+   entry->pool.field_labels = (const char**)entry->field_labels;
+
+   entry->field_data = new void* [ pool->num_blocks*pool->num_fields ];
+   for (long b=0; b<pool->num_blocks; b++)
+   for (int  v=0; v<pool->num_fields; v++)
+      entry->field_data[ b*pool->num_fields + v ] = (char*)pool->data + ( b*block_stride + v*field_stride )*elem_size;
+
+   return entry->field_data;
+
+} // FUNCTION : block_pool_register
+
+
+
+//-------------------------------------------------------------------------------------------------------
+// Function    :  block_pool_labels
+// Description :  Return the field labels copied by the last call to block_pool_register()
+//
+// Note        :  1. Called by yt_add_block_pool() so that the grids do not refer to the user array
+//
+// Parameter   :  None
+//
+// Return      :  Field labels of the last registered pool
+//-------------------------------------------------------------------------------------------------------
+const char **block_pool_labels()
+{
+
+   return ( NPool > 0 ) ? Pools[NPool-1].pool.field_labels : NULL;
+
+} // FUNCTION : block_pool_labels
+
+
+
+//-------------------------------------------------------------------------------------------------------
+// Function    :  export_block_pools
+// Description :  Export the block pools of this step to libyt.block_pools
+//
+// Note        :  1. Called by commit_grids()
+//                2. libyt.block_pools is a list with one dictionary per pool:
+//                   "data"         : Array of shape ( num_blocks, num_fields, dims[0], dims[1], dims[2] )
+//                                    wrapping the pool with its strides ==> no data are copied
+//                   "field_labels" : Tuple of the field names along the second axis of "data"
+//                   "grid_id"      : ID of each block in libyt.hierarchy (-1 if discarded by the grid filter)
+//                3. Per-block views (e.g., data[b]) are created by Python on demand
+//
+// Parameter   :  None
+//
+// Return      :  YT_SUCCESS or YT_FAIL
+//-------------------------------------------------------------------------------------------------------
+int export_block_pools()
+{
+
+   PyObject *py_libyt = PyImport_AddModule( "libyt" );   // borrowed reference
+   PyObject *py_pools = PyList_New( 0 );
+
+   for (int p=0; p<NPool; p++)
+   {
+      const yt_block_pool *pool = &Pools[p].pool;
+
+//    wrap the pool
+      const int elem_size = ( pool->field_ftype == YT_FLOAT ) ? sizeof(float) : sizeof(double);
+      npy_intp  np_dim[5]     = { pool->num_blocks, pool->num_fields,
+                                  pool->block_dims[0], pool->block_dims[1], pool->block_dims[2] };
+      npy_intp  np_stride[5]  = { pool->block_stride*elem_size, pool->field_stride*elem_size,
+                                  (npy_intp)pool->block_dims[1]*pool->block_dims[2]*elem_size,
+                                  (npy_intp)pool->block_dims[2]*elem_size, elem_size };
+      PyObject *py_data = PyArray_New( &PyArray_Type, 5, np_dim, ( pool->field_ftype == YT_FLOAT ) ? NPY_FLOAT : NPY_DOUBLE,
+                                       np_stride, pool->data, 0, NPY_ARRAY_ALIGNED | NPY_ARRAY_WRITEABLE, NULL );
+      if ( py_data == NULL )
+      {
+         Py_DECREF( py_pools );
+         PyErr_Print();
+         YT_ABORT( "Wrapping block pool [%d] ... failed!\n", p );
+      }
+
+      track_view( pool->first_id, pool->field_labels[0], py_data );
+
+//    field labels
+      PyObject *py_labels = PyTuple_New( pool->num_fields );
+      for (int v=0; v<pool->num_fields; v++)
+         PyTuple_SET_ITEM( py_labels, v, PyString_FromString( pool->field_labels[v] ) );
+
+//    map the blocks to the grids after the grid filter and the grid ordering
+      npy_intp  np_dim_id[1] = { pool->num_blocks };
+      PyObject *py_grid_id   = PyArray_SimpleNew( 1, np_dim_id, NPY_LONG );
+      npy_long *grid_id      = (npy_long*)PyArray_DATA( (PyArrayObject*)py_grid_id );
+
+      for (long b=0; b<pool->num_blocks; b++)   grid_id[b] = -1;
+      for (long g=0; g<g_param_yt.num_grids; g++)
+      {
+         const long b = grid_host_id( g ) - pool->first_id;
+         if ( b >= 0  &&  b < pool->num_blocks )   grid_id[b] = g;
+      }
+
+      PyObject *py_pool = PyDict_New();
+      PyDict_SetItemString( py_pool, "data",         py_data    );
+      PyDict_SetItemString( py_pool, "field_labels", py_labels  );
+      PyDict_SetItemString( py_pool, "grid_id",      py_grid_id );
+      PyList_Append( py_pools, py_pool );
+
+      Py_DECREF( py_data );
+      Py_DECREF( py_labels );
+      Py_DECREF( py_grid_id );
+      Py_DECREF( py_pool );
+   }
+
+   const int status = PyObject_SetAttrString( py_libyt, "block_pools", py_pools );
+   Py_DECREF( py_pools );
+
+   if ( status != 0 )
+   {
+      PyErr_Print();
+      YT_ABORT( "Setting libyt.block_pools ... failed!\n" );
+   }
+
+   return YT_SUCCESS;
+
+} // FUNCTION : export_block_pools
+
+
+
+//-------------------------------------------------------------------------------------------------------
+// Function    :  block_pool_free
+// Description :  Release all block pools
+//
+// Note        :  1. Called by begin_step(), reset_step(), and yt_finalize()
+//                2. Does not touch any Python object and can thus be called without the GIL
+//                   ==> libyt.block_pools is reset by clear_block_pools()
+//
+// Parameter   :  None
+//
+// Return      :  None
+//-------------------------------------------------------------------------------------------------------
+void block_pool_free()
+{
+
+   for (int p=0; p<NPool; p++)
+   {
+      for (int v=0; v<Pools[p].pool.num_fields; v++)   delete [] Pools[p].field_labels[v];
+      delete [] Pools[p].field_labels;
+      delete [] Pools[p].field_data;
+   }
+
+   free( Pools );
+   Pools     = NULL;
+   NPool     = 0;
+   NPoolSize = 0;
+
+} // FUNCTION : block_pool_free
+
+
+
+//-------------------------------------------------------------------------------------------------------
+// Function    :  clear_block_pools
+// Description :  Reset libyt.block_pools to an empty list
+//
+// Note        :  1. Called by yt_set_parameter() and yt_inline() with the GIL held
+//                   ==> Drop the arrays wrapping the pools of the last step, which may have been freed by
+//                       the simulation
+//
+// Parameter   :  None
+//
+// Return      :  None
+//-------------------------------------------------------------------------------------------------------
+void clear_block_pools()
+{
+
+   PyObject *py_libyt = PyImport_AddModule( "libyt" );   // borrowed reference
+   PyObject *py_pools = PyList_New( 0 );
+
+   if ( py_libyt != NULL  &&  PyObject_SetAttrString( py_libyt, "block_pools", py_pools ) != 0 )   PyErr_Clear();
+
+   Py_DECREF( py_pools );
+
+} // FUNCTION : clear_block_pools
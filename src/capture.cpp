@@ -0,0 +1,525 @@
+#define NO_PYTHON
+#include "yt_combo.h"
+#undef NO_PYTHON
+#include "libyt.h"
+#include <string.h>
+#include <stdint.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <typeinfo>
+
+
+
+
+// magic string and version of the capture format
+static const char    CaptureMagic[8] = "LIBYTCP";
+static const int32_t FormatVersion   = 1;
+
+// all record payloads are padded to multiples of "Alignment" bytes so that the field data of a
+// memory-mapped capture file are properly aligned
+static const int64_t Alignment = 8;
+
+
+// record types
+enum capture_kind { CAPTURE_PARAM_YT=1, CAPTURE_USER_PARAM=2, CAPTURE_GRID=3, CAPTURE_INLINE=4 };
+
+
+//-------------------------------------------------------------------------------------------------------
+// Structure   :  capture_file_header / capture_record_header / capture_user_param_header
+// Description :  Layout of the capture file
+//
+// Note        :  1. File layout: [capture_file_header] [capture_record_header + payload] ...
+//                2. Payload of each record type:
+//                   CAPTURE_PARAM_YT   : yt_param_yt + frontend + '\0' + fig_basename + '\0'
+//                   CAPTURE_USER_PARAM : capture_user_param_header + key + '\0' + [padding] + data
+//                   CAPTURE_GRID       : yt_grid + num_fields*(label + '\0') + [padding] + num_fields*(data + [padding])
+//                   CAPTURE_INLINE     : None
+//                3. Structures are stored in the native binary layout
+//                   ==> capture files are only portable between identical builds of libyt, which is checked
+//                       by the structure sizes stored in the file header
+//-------------------------------------------------------------------------------------------------------
+struct capture_file_header
+{
+   char    magic[8];
+   int32_t version;
+   int32_t size_param_yt;
+   int32_t size_grid;
+   int32_t padding;
+};
+
+struct capture_record_header
+{
+   int32_t kind;
+   int32_t padding;
+   int64_t nbytes;      // payload size in bytes including padding
+};
+
+struct capture_user_param_header
+{
+   int32_t type;        // yt_add_user_parameter_type() ==> see USER_PARAM_* below
+   int32_t n;           // number of elements (string length + 1 for strings)
+   int32_t key_size;    // key length + 1
+   int32_t data_size;   // data size in bytes
+};
+
+enum { USER_PARAM_INT=0, USER_PARAM_LONG=1, USER_PARAM_UINT=2, USER_PARAM_ULONG=3,
+       USER_PARAM_FLOAT=4, USER_PARAM_DOUBLE=5, USER_PARAM_STRING=6 };
+
+
+static FILE *Capture_File = NULL;
+
+static int64_t padded( const int64_t nbytes ) { return ( nbytes + Alignment - 1 ) / Alignment * Alignment; }
+static int write_record_header( const capture_kind kind, const int64_t nbytes );
+static int write_padding( const int64_t nbytes );
+static int write_user_param( const char *key, const int type, const int n, const void *input, const int data_size );
+
+
+
+
+//-------------------------------------------------------------------------------------------------------
+// Function    :  capture_open
+// Description :  Open the capture file and write the file header
+//
+// Note        :  1. Called by yt_init() when "param_libyt.capture" is set
+//
+// Parameter   :  filename : Name of the capture file
+//
+// Return      :  YT_SUCCESS or YT_FAIL
+//-------------------------------------------------------------------------------------------------------
+int capture_open( const char *filename )
+{
+
+   if (  ( Capture_File = fopen( filename, "wb" ) ) == NULL  )
+      YT_ABORT( "Opening the capture file \"%s\" ... failed!\n", filename );
+
+   capture_file_header header;
+   memset( &header, 0, sizeof(capture_file_header) );
+   memcpy( header.magic, CaptureMagic, 8 );
+   header.version       = FormatVersion;
+   header.size_param_yt = sizeof(yt_param_yt);
+   header.size_grid     = sizeof(yt_grid);
+
+   if ( fwrite( &header, sizeof(capture_file_header), 1, Capture_File ) != 1 )
+      YT_ABORT( "Writing the header of the capture file \"%s\" ... failed!\n", filename );
+
+   log_debug( "Opening the capture file \"%s\" ... done\n", filename );
+
+   return YT_SUCCESS;
+
+} // FUNCTION : capture_open
+
+
+
+//-------------------------------------------------------------------------------------------------------
+// Function    :  capture_close
+// Description :  Close the capture file
+//
+// Note        :  1. Called by yt_finalize()
+//
+// Parameter   :  None
+//
+// Return      :  YT_SUCCESS or YT_FAIL
+//-------------------------------------------------------------------------------------------------------
+int capture_close()
+{
+
+   if ( Capture_File == NULL )   return YT_SUCCESS;
+
+   if ( fclose( Capture_File ) != 0 )   YT_ABORT( "Closing the capture file ... failed!\n" );
+
+   Capture_File = NULL;
+
+   return YT_SUCCESS;
+
+} // FUNCTION : capture_close
+
+
+
+//-------------------------------------------------------------------------------------------------------
+// Function    :  capture_param_yt / capture_user_param / capture_user_param_string / capture_grid / capture_inline
+// Description :  Record the input of yt_set_parameter(), yt_add_user_parameter_*(), yt_add_grid(), and
+//                yt_inline(), respectively
+//
+// Note        :  1. Called by the corresponding APIs after the input has been validated
+//                2. Do nothing if capture is disabled
+//
+// Return      :  YT_SUCCESS or YT_FAIL
+//-------------------------------------------------------------------------------------------------------
+int capture_param_yt( const yt_param_yt *param_yt )
+{
+
+   if ( Capture_File == NULL )   return YT_SUCCESS;
+
+   const char   *frontend     = ( param_yt->frontend     == NULL ) ? "" : param_yt->frontend;
+   const char   *fig_basename = ( param_yt->fig_basename == NULL ) ? "" : param_yt->fig_basename;
+   const int64_t nbytes       = sizeof(yt_param_yt) + strlen(frontend) + 1 + strlen(fig_basename) + 1;
+
+   if ( !write_record_header( CAPTURE_PARAM_YT, padded(nbytes) ) )                   return YT_FAIL;
+   if ( fwrite( param_yt,     sizeof(yt_param_yt),    1, Capture_File ) != 1 )       YT_ABORT( "Capturing YT parameters ... failed!\n" );
+   if ( fwrite( frontend,     strlen(frontend)+1,     1, Capture_File ) != 1 )       YT_ABORT( "Capturing YT parameters ... failed!\n" );
+   if ( fwrite( fig_basename, strlen(fig_basename)+1, 1, Capture_File ) != 1 )       YT_ABORT( "Capturing YT parameters ... failed!\n" );
+   if ( !write_padding( padded(nbytes) - nbytes ) )                                  return YT_FAIL;
+
+   return YT_SUCCESS;
+
+} // FUNCTION : capture_param_yt
+
+
+template <typename T>
+int capture_user_param( const char *key, const int n, const T *input )
+{
+
+   if ( Capture_File == NULL )   return YT_SUCCESS;
+
+   int type;
+   if      ( typeid(T) == typeid(   int) )   type = USER_PARAM_INT;
+   else if ( typeid(T) == typeid(  long) )   type = USER_PARAM_LONG;
+   else if ( typeid(T) == typeid(  uint) )   type = USER_PARAM_UINT;
+   else if ( typeid(T) == typeid( ulong) )   type = USER_PARAM_ULONG;
+   else if ( typeid(T) == typeid( float) )   type = USER_PARAM_FLOAT;
+   else if ( typeid(T) == typeid(double) )   type = USER_PARAM_DOUBLE;
+   else
+      YT_ABORT( "Unsupported data type (only support float, double, int, long, unit, ulong)!\n" );
+
+   return write_user_param( key, type, n, input, n*sizeof(T) );
+
+} // FUNCTION : capture_user_param
+
+
+int capture_user_param_string( const char *key, const char *input )
+{
+
+   if ( Capture_File == NULL )   return YT_SUCCESS;
+
+   return write_user_param( key, USER_PARAM_STRING, strlen(input)+1, input, strlen(input)+1 );
+
+} // FUNCTION : capture_user_param_string
+
+
+int capture_grid( const yt_grid *grid )
+{
+
+   if ( Capture_File == NULL )   return YT_SUCCESS;
+
+   const size_t  type_size = ( grid->field_ftype == YT_FLOAT ) ? sizeof(float) : sizeof(double);
+   const int64_t data_size = (int64_t)grid->dimensions[0]*grid->dimensions[1]*grid->dimensions[2]*type_size;
+
+   int64_t head_size = sizeof(yt_grid);
+   for (int v=0; v<grid->num_fields; v++)   head_size += strlen( grid->field_labels[v] ) + 1;
+
+   if ( !write_record_header( CAPTURE_GRID, padded(head_size) + grid->num_fields*padded(data_size) ) )   return YT_FAIL;
+
+   if ( fwrite( grid, sizeof(yt_grid), 1, Capture_File ) != 1 )
+      YT_ABORT( "Capturing grid [%ld] ... failed!\n", grid->id );
+
+   for (int v=0; v<grid->num_fields; v++)
+      if ( fwrite( grid->field_labels[v], strlen( grid->field_labels[v] ) + 1, 1, Capture_File ) != 1 )
+         YT_ABORT( "Capturing grid [%ld] ... failed!\n", grid->id );
+
+   if ( !write_padding( padded(head_size) - head_size ) )   return YT_FAIL;
+
+   for (int v=0; v<grid->num_fields; v++)
+   {
+      if ( fwrite( grid->field_data[v], data_size, 1, Capture_File ) != 1 )
+         YT_ABORT( "Capturing grid [%ld] field \"%s\" ... failed!\n", grid->id, grid->field_labels[v] );
+
+      if ( !write_padding( padded(data_size) - data_size ) )   return YT_FAIL;
+   }
+
+   return YT_SUCCESS;
+
+} // FUNCTION : capture_grid
+
+
+int capture_inline()
+{
+
+   if ( Capture_File == NULL )   return YT_SUCCESS;
+
+   if ( !write_record_header( CAPTURE_INLINE, 0 ) )   return YT_FAIL;
+
+// flush at the end of each step so that the capture file remains usable even if the simulation crashes
+   fflush( Capture_File );
+
+   return YT_SUCCESS;
+
+} // FUNCTION : capture_inline
+
+
+
+//-------------------------------------------------------------------------------------------------------
+// Function    :  replay_capture
+// Description :  Feed all API calls recorded in a capture file back into libyt
+//
+// Note        :  1. Called by yt_replay()
+//                2. The capture file is memory-mapped privately (copy-on-write)
+//                   ==> Field data are passed to yt_add_grid() without copying
+//                3. Field pointer arrays of all grids added since the last yt_inline() are freed right
+//                   after yt_inline() returns
+//
+// Parameter   :  filename : Name of the capture file
+//
+// Return      :  YT_SUCCESS or YT_FAIL
+//-------------------------------------------------------------------------------------------------------
+int replay_capture( const char *filename )
+{
+
+// all failures below jump to "cleanup" to release the file, the mapping, and the replayed grids
+// ==> everything released there must be declared before the first jump
+#  define REPLAY_ABORT( ... )                                          \
+   {                                                                    \
+      log_error( __VA_ARGS__ );                                         \
+      fprintf( stderr, "%13s==> file <%s>, line <%d>, function <%s>\n", \
+               "", __FILE__, __LINE__, __FUNCTION__ );                  \
+      status = YT_FAIL;                                                 \
+      goto cleanup;                                                     \
+   }
+
+   int          status    = YT_SUCCESS;
+   int          fd        = -1;
+   int64_t      file_size = 0;
+   char        *buffer    = (char*)MAP_FAILED;
+   int64_t      offset    = sizeof(capture_file_header);
+   long         num_grids = 0, num_steps = 0, max_grids = 1024;
+   yt_grid     *grids     = NULL;
+   struct stat  file_stat;
+   const capture_file_header *file_header;
+
+
+// map the capture file
+   if (  ( fd = open( filename, O_RDONLY ) ) < 0  )
+      REPLAY_ABORT( "Opening the capture file \"%s\" ... failed!\n", filename );
+
+   if ( fstat( fd, &file_stat ) != 0 )
+      REPLAY_ABORT( "Querying the size of the capture file \"%s\" ... failed!\n", filename );
+
+   file_size = file_stat.st_size;
+
+   if ( file_size < (int64_t)sizeof(capture_file_header) )
+      REPLAY_ABORT( "\"%s\" is not a capture file!\n", filename );
+
+   buffer = (char*)mmap( NULL, file_size, PROT_READ|PROT_WRITE, MAP_PRIVATE, fd, 0 );
+
+   if ( buffer == MAP_FAILED )
+      REPLAY_ABORT( "Memory-mapping the capture file \"%s\" ... failed!\n", filename );
+
+
+// check the file header
+   file_header = (const capture_file_header*)buffer;
+
+   if ( memcmp( file_header->magic, CaptureMagic, 8 ) != 0 )
+      REPLAY_ABORT( "\"%s\" is not a capture file!\n", filename );
+
+   if ( file_header->version != FormatVersion )
+      REPLAY_ABORT( "Unsupported capture format version [%d] (expect [%d])!\n", file_header->version, FormatVersion );
+
+   if ( file_header->size_param_yt != (int32_t)sizeof(yt_param_yt)  ||  file_header->size_grid != (int32_t)sizeof(yt_grid) )
+      REPLAY_ABORT( "Capture file \"%s\" was created by an incompatible build of libyt!\n", filename );
+
+
+// replay all records
+   grids = new yt_grid [max_grids];
+
+   while ( offset + (int64_t)sizeof(capture_record_header) <= file_size )
+   {
+      const capture_record_header *record = (const capture_record_header*)( buffer + offset );
+      char *payload = buffer + offset + sizeof(capture_record_header);
+
+      offset += sizeof(capture_record_header) + record->nbytes;
+
+//    incomplete record at the end of file (e.g., the simulation crashed during capture)
+      if ( offset > file_size )
+      {
+         log_warning( "Ignoring the incomplete record at the end of the capture file \"%s\"\n", filename );
+         break;
+      }
+
+      switch ( record->kind )
+      {
+         case CAPTURE_PARAM_YT :
+         {
+            yt_param_yt *param_yt = (yt_param_yt*)payload;
+            param_yt->frontend     = payload + sizeof(yt_param_yt);
+            param_yt->fig_basename = param_yt->frontend + strlen( param_yt->frontend ) + 1;
+            if ( param_yt->fig_basename[0] == '\0' )   param_yt->fig_basename = NULL;
+
+            if ( yt_set_parameter( param_yt ) != YT_SUCCESS )   REPLAY_ABORT( "Replaying yt_set_parameter() ... failed!\n" );
+         }
+         break;
+
+         case CAPTURE_USER_PARAM :
+         {
+            const capture_user_param_header *param = (const capture_user_param_header*)payload;
+            const char *key  = payload + sizeof(capture_user_param_header);
+            const void *data = payload + padded( sizeof(capture_user_param_header) + param->key_size );
+
+            switch ( param->type )
+            {
+               case USER_PARAM_INT    : status = yt_add_user_parameter_int   ( key, param->n, (const int   *)data );   break;
+               case USER_PARAM_LONG   : status = yt_add_user_parameter_long  ( key, param->n, (const long  *)data );   break;
+               case USER_PARAM_UINT   : status = yt_add_user_parameter_uint  ( key, param->n, (const uint  *)data );   break;
+               case USER_PARAM_ULONG  : status = yt_add_user_parameter_ulong ( key, param->n, (const ulong *)data );   break;
+               case USER_PARAM_FLOAT  : status = yt_add_user_parameter_float ( key, param->n, (const float *)data );   break;
+               case USER_PARAM_DOUBLE : status = yt_add_user_parameter_double( key, param->n, (const double*)data );   break;
+               case USER_PARAM_STRING : status = yt_add_user_parameter_string( key,           (const char  *)data );   break;
+               default                : REPLAY_ABORT( "Unknown user parameter type [%d] for key \"%s\"!\n", param->type, key );
+            }
+
+            if ( status != YT_SUCCESS )   REPLAY_ABORT( "Replaying user parameter \"%s\" ... failed!\n", key );
+         }
+         break;
+
+         case CAPTURE_GRID :
+         {
+            if ( num_grids == max_grids )
+            {
+               yt_grid *grids_old = grids;
+               grids = new yt_grid [ 2*max_grids ];
+               for (long g=0; g<num_grids; g++)   grids[g] = grids_old[g];
+
+               delete [] grids_old;
+               max_grids *= 2;
+            }
+
+            yt_grid *grid = grids + num_grids;
+            *grid = *(const yt_grid*)payload;
+
+            const size_t  type_size = ( grid->field_ftype == YT_FLOAT ) ? sizeof(float) : sizeof(double);
+            const int64_t data_size = (int64_t)grid->dimensions[0]*grid->dimensions[1]*grid->dimensions[2]*type_size;
+
+            grid->field_labels = new const char* [ grid->num_fields ];
+            grid->field_data   = new void*       [ grid->num_fields ];
+            grid->field_codec  = NULL;
+
+            char *ptr = payload + sizeof(yt_grid);
+            for (int v=0; v<grid->num_fields; v++)
+            {
+               grid->field_labels[v] = ptr;
+               ptr += strlen( ptr ) + 1;
+            }
+
+            ptr = payload + padded( ptr - payload );
+            for (int v=0; v<grid->num_fields; v++)
+            {
+               grid->field_data[v] = ptr;
+               ptr += padded( data_size );
+            }
+
+            num_grids ++;
+
+            if ( yt_add_grid( grid ) != YT_SUCCESS )   REPLAY_ABORT( "Replaying yt_add_grid() for grid [%ld] ... failed!\n", grid->id );
+         }
+         break;
+
+         case CAPTURE_INLINE :
+         {
+            if ( yt_inline() != YT_SUCCESS )   REPLAY_ABORT( "Replaying yt_inline() at step [%ld] ... failed!\n", num_steps );
+
+            for (long g=0; g<num_grids; g++)
+            {
+               delete [] grids[g].field_labels;
+               delete [] grids[g].field_data;
+            }
+
+            num_grids = 0;
+            num_steps ++;
+         }
+         break;
+
+         default :
+            REPLAY_ABORT( "Unknown record type [%d] in the capture file \"%s\"!\n", record->kind, filename );
+      } // switch ( record->kind )
+   } // while ( offset + (int64_t)sizeof(capture_record_header) <= file_size )
+
+   log_info( "Replaying %ld steps from \"%s\" ... done\n", num_steps, filename );
+
+
+// free resources (grids added after the last yt_inline() are never analyzed)
+cleanup:
+   for (long g=0; g<num_grids; g++)
+   {
+      delete [] grids[g].field_labels;
+      delete [] grids[g].field_data;
+   }
+   delete [] grids;
+
+   if ( buffer != MAP_FAILED )   munmap( buffer, file_size );
+   if ( fd >= 0 )                close( fd );
+
+#  undef REPLAY_ABORT
+
+
+   return status;
+
+} // FUNCTION : replay_capture
+
+
+
+//-------------------------------------------------------------------------------------------------------
+// Function    :  write_record_header / write_padding / write_user_param
+// Description :  Auxiliary functions for writing the record header, zero padding, and a user parameter
+//
+// Return      :  YT_SUCCESS or YT_FAIL
+//-------------------------------------------------------------------------------------------------------
+static int write_record_header( const capture_kind kind, const int64_t nbytes )
+{
+
+   capture_record_header header;
+   header.kind    = kind;
+   header.padding = 0;
+   header.nbytes  = nbytes;
+
+   if ( fwrite( &header, sizeof(capture_record_header), 1, Capture_File ) != 1 )
+      YT_ABORT( "Writing a record header of type [%d] to the capture file ... failed!\n", kind );
+
+   return YT_SUCCESS;
+
+} // FUNCTION : write_record_header
+
+
+static int write_padding( const int64_t nbytes )
+{
+
+   const char zero[Alignment] = { 0 };
+
+   if ( nbytes > 0  &&  fwrite( zero, nbytes, 1, Capture_File ) != 1 )
+      YT_ABORT( "Writing padding to the capture file ... failed!\n" );
+
+   return YT_SUCCESS;
+
+} // FUNCTION : write_padding
+
+
+static int write_user_param( const char *key, const int type, const int n, const void *input, const int data_size )
+{
+
+   capture_user_param_header param;
+   param.type      = type;
+   param.n         = n;
+   param.key_size  = strlen(key) + 1;
+   param.data_size = data_size;
+
+   const int64_t head_size = sizeof(capture_user_param_header) + param.key_size;
+
+   if ( !write_record_header( CAPTURE_USER_PARAM, padded(head_size) + padded(data_size) ) )   return YT_FAIL;
+   if ( fwrite( &param, sizeof(capture_user_param_header), 1, Capture_File ) != 1 )          YT_ABORT( "Capturing parameter \"%s\" ... failed!\n", key );
+   if ( fwrite( key,    param.key_size,                    1, Capture_File ) != 1 )          YT_ABORT( "Capturing parameter \"%s\" ... failed!\n", key );
+   if ( !write_padding( padded(head_size) - head_size ) )                                    return YT_FAIL;
+   if ( fwrite( input,  data_size,                         1, Capture_File ) != 1 )          YT_ABORT( "Capturing parameter \"%s\" ... failed!\n", key );
+   if ( !write_padding( padded(data_size) - data_size ) )                                    return YT_FAIL;
+
+   return YT_SUCCESS;
+
+} // FUNCTION : write_user_param
+
+
+
+// explicit template instantiation
+template int capture_user_param <float > ( const char *key, const int n, const float  *input );
+template int capture_user_param <double> ( const char *key, const int n, const double *input );
+template int capture_user_param <int   > ( const char *key, const int n, const int    *input );
+template int capture_user_param <long  > ( const char *key, const int n, const long   *input );
+template int capture_user_param <uint  > ( const char *key, const int n, const uint   *input );
+template int capture_user_param <ulong > ( const char *key, const int n, const ulong  *input );
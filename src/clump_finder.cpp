@@ -0,0 +1,350 @@
+#define NO_PYTHON
+#include "yt_combo.h"
+#undef NO_PYTHON
+#include <math.h>
+
+
+
+
+// cell states
+enum cell_state { CELL_BELOW=0, CELL_ACTIVE=1, CELL_COVERED=2 };
+
+static long find_root( long *parent, long x );
+static void union_roots( long *parent, long a, long b );
+static void mark_cells( const yt_grid *grid, const void *data, const yt_ftype ftype, const double threshold,
+                        char *state );
+
+
+
+
+//-------------------------------------------------------------------------------------------------------
+// Function    :  find_clumps
+// Description :  Find all connected regions (clumps) of leaf cells with field values above a threshold
+//
+// Note        :  1. Only leaf cells (i.e., cells not covered by any child grid found through "parent_id")
+//                   are considered
+//                2. Cells are connected through faces. Neighbors across grid faces and refinement levels
+//                   are found with the spatial index built by grid_index_build().
+//                3. Use a lock-free union-find (union by linking the larger root to the smaller root,
+//                   find with path halving), so that all grids can be labeled in parallel with OpenMP
+//                   if libyt is compiled with -DOPENMP
+//                4. "mass" is the sum of field value times cell volume (i.e., assuming a density field)
+//                5. Output arrays are allocated here and must be free'd by the caller with delete []
+//                6. Does not touch any Python object ==> can be called without holding the GIL
+//
+// Parameter   :  field      : Name of the target field (a field passed to yt_add_grid() or a derived field)
+//                threshold  : Cells with field values > threshold belong to clumps
+//                min_cells  : Discard clumps with fewer cells
+//                num_clumps : Number of clumps to be returned
+//                cell_count : Number of cells in each clump           [num_clumps]
+//                mass       : Mass of each clump                      [num_clumps]
+//                left_edge  : Left  edge of the bounding box of each clump [num_clumps][3]
+//                right_edge : Right edge of the bounding box of each clump [num_clumps][3]
+//
+// Return      :  YT_SUCCESS or YT_FAIL
+//-------------------------------------------------------------------------------------------------------
+int find_clumps( const char *field, const double threshold, const long min_cells, long *num_clumps,
+                 long **cell_count, double **mass, double **left_edge, double **right_edge )
+{
+
+   const long num_grids = g_param_yt.num_grids;
+
+   if ( g_grids == NULL )   YT_ABORT( "No grid has been staged!\n" );
+
+
+// get field data and cell offsets of all grids
+   void    **data      = new void*    [num_grids];
+   yt_ftype *ftype     = new yt_ftype [num_grids];
+   bool     *allocated = new bool     [num_grids];
+   long     *offset    = new long     [num_grids+1];
+   bool      found     = true;
+
+   offset[0] = 0;
+   for (long g=0; g<num_grids; g++)
+      offset[g+1] = offset[g] + (long)g_grids[g].dimensions[0]*g_grids[g].dimensions[1]*g_grids[g].dimensions[2];
+
+#  ifdef OPENMP
+#  pragma omp parallel for schedule( dynamic ) if ( !g_param_libyt.forked_worker )
+#  endif
+   for (long g=0; g<num_grids; g++)
+      if (  ( data[g] = get_field_data( g_grids + g, field, ftype + g, allocated + g ) ) == NULL  )   found = false;
+
+   if ( !found )
+   {
+      for (long g=0; g<num_grids; g++)   if ( allocated[g] )   delete [] (char*)data[g];
+      delete [] data;   delete [] ftype;   delete [] allocated;   delete [] offset;
+
+      YT_ABORT( "Field \"%s\" is not found in all grids!\n", field );
+   }
+
+
+// label cells
+   const long ncells = offset[num_grids];
+   char *state  = new char [ncells];
+   long *parent = new long [ncells];
+
+   grid_index_build();
+
+#  ifdef OPENMP
+#  pragma omp parallel if ( !g_param_libyt.forked_worker )
+#  endif
+   {
+//    mark active cells
+#     ifdef OPENMP
+#     pragma omp for schedule( dynamic )
+#     endif
+      for (long g=0; g<num_grids; g++)
+      {
+         mark_cells( g_grids + g, data[g], ftype[g], threshold, state + offset[g] );
+
+         grid_index_mark_covered( g, state + offset[g], CELL_COVERED );
+
+         for (long c=offset[g]; c<offset[g+1]; c++)   parent[c] = c;
+      }
+
+//    merge neighboring active cells
+#     ifdef OPENMP
+#     pragma omp for schedule( dynamic )
+#     endif
+      for (long g=0; g<num_grids; g++)
+      {
+         const yt_grid *grid = g_grids + g;
+         const int     *dim  = grid->dimensions;
+         const char    *st   = state + offset[g];
+         double dh[3];
+
+         for (int d=0; d<3; d++)   dh[d] = ( grid->right_edge[d] - grid->left_edge[d] ) / dim[d];
+
+         for (int i=0; i<dim[0]; i++)
+         for (int j=0; j<dim[1]; j++)
+         for (int k=0; k<dim[2]; k++)
+         {
+            const long c = ( (long)i*dim[1] + j )*dim[2] + k;
+
+            if ( st[c] != CELL_ACTIVE )   continue;
+
+            for (int side=0; side<6; side++)
+            {
+               const int d    = side/2;
+               const int sign = ( side%2 == 0 ) ? -1 : +1;
+               int idx[3] = { i, j, k };
+               idx[d] += sign;
+
+//             neighbor inside the same grid and not covered ==> visit it only from one side
+               if ( idx[d] >= 0  &&  idx[d] < dim[d] )
+               {
+                  const long n = ( (long)idx[0]*dim[1] + idx[1] )*dim[2] + idx[2];
+
+                  if ( st[n] != CELL_COVERED )
+                  {
+                     if ( sign > 0  &&  st[n] == CELL_ACTIVE )   union_roots( parent, offset[g] + c, offset[g] + n );
+                     continue;
+                  }
+               }
+
+//             neighbor in another grid or covered by a child grid ==> find the leaf cell with the spatial index
+               double pos[3];
+               for (int t=0; t<3; t++)   pos[t] = grid->left_edge[t] + ( idx[t] + 0.5 )*dh[t];
+
+               const long h = grid_index_find( pos );
+               if ( h < 0  ||  h == g )   continue;
+
+               const yt_grid *nbr = g_grids + h;
+               int nidx[3];
+               for (int t=0; t<3; t++)
+               {
+                  nidx[t] = (int)floor( ( pos[t] - nbr->left_edge[t] ) / ( nbr->right_edge[t] - nbr->left_edge[t] )
+                                        * nbr->dimensions[t] );
+                  nidx[t] = MAX( 0, MIN( nbr->dimensions[t]-1, nidx[t] ) );
+               }
+
+               const long n = ( (long)nidx[0]*nbr->dimensions[1] + nidx[1] )*nbr->dimensions[2] + nidx[2];
+
+               if ( state[ offset[h] + n ] == CELL_ACTIVE )   union_roots( parent, offset[g] + c, offset[h] + n );
+            }
+         }
+      } // for (long g=0; g<num_grids; g++)
+   } // OpenMP parallel region
+
+
+// assign clump IDs to roots
+   long *clump_id = new long [ncells];
+   long  nroots   = 0;
+
+   for (long c=0; c<ncells; c++)
+      clump_id[c] = ( state[c] == CELL_ACTIVE  &&  parent[c] == c ) ? nroots++ : -1;
+
+
+// accumulate clump properties
+   long   *count = new long   [nroots];
+   double *m     = new double [nroots];
+   double *le    = new double [nroots*3];
+   double *re    = new double [nroots*3];
+
+   for (long r=0; r<nroots; r++)
+   {
+      count[r] = 0;
+      m    [r] = 0.0;
+      for (int d=0; d<3; d++)   {  le[3*r+d] = +HUGE_VAL;   re[3*r+d] = -HUGE_VAL;  }
+   }
+
+   for (long g=0; g<num_grids; g++)
+   {
+      const yt_grid *grid = g_grids + g;
+      const int     *dim  = grid->dimensions;
+      double dh[3];
+
+      for (int d=0; d<3; d++)   dh[d] = ( grid->right_edge[d] - grid->left_edge[d] ) / dim[d];
+
+      const double dv = dh[0]*dh[1]*dh[2];
+
+      for (int i=0; i<dim[0]; i++)
+      for (int j=0; j<dim[1]; j++)
+      for (int k=0; k<dim[2]; k++)
+      {
+         const long c = ( (long)i*dim[1] + j )*dim[2] + k;
+
+         if ( state[ offset[g] + c ] != CELL_ACTIVE )   continue;
+
+         const long   r     = clump_id[ find_root( parent, offset[g] + c ) ];
+         const double value = ( ftype[g] == YT_FLOAT ) ? ( (float*)data[g] )[c] : ( (double*)data[g] )[c];
+         const int    idx[3] = { i, j, k };
+
+         count[r] ++;
+         m    [r] += value*dv;
+
+         for (int d=0; d<3; d++)
+         {
+            le[3*r+d] = MIN( le[3*r+d], grid->left_edge[d] +  idx[d]     *dh[d] );
+            re[3*r+d] = MAX( re[3*r+d], grid->left_edge[d] + (idx[d] + 1)*dh[d] );
+         }
+      }
+   }
+
+
+// remove small clumps
+   *num_clumps = 0;
+   for (long r=0; r<nroots; r++)   if ( count[r] >= min_cells )   (*num_clumps) ++;
+
+   *cell_count = new long   [*num_clumps];
+   *mass       = new double [*num_clumps];
+   *left_edge  = new double [*num_clumps*3];
+   *right_edge = new double [*num_clumps*3];
+
+   for (long r=0, t=0; r<nroots; r++)
+   {
+      if ( count[r] < min_cells )   continue;
+
+      (*cell_count)[t] = count[r];
+      (*mass      )[t] = m[r];
+      for (int d=0; d<3; d++)
+      {
+         (*left_edge )[3*t+d] = le[3*r+d];
+         (*right_edge)[3*t+d] = re[3*r+d];
+      }
+      t ++;
+   }
+
+   log_debug( "Finding clumps of \"%s\" > %13.7e ... done (%ld clumps)\n", field, threshold, *num_clumps );
+
+
+// free resources
+   for (long g=0; g<num_grids; g++)   if ( allocated[g] )   delete [] (char*)data[g];
+
+   delete [] data;         delete [] ftype;        delete [] allocated;   delete [] offset;
+   delete [] state;        delete [] parent;       delete [] clump_id;
+   delete [] count;        delete [] m;            delete [] le;          delete [] re;
+
+   return YT_SUCCESS;
+
+} // FUNCTION : find_clumps
+
+
+
+//-------------------------------------------------------------------------------------------------------
+// Function    :  find_root
+// Description :  Return the root of the target cell in the union-find forest
+//
+// Note        :  1. Lock-free path halving ==> each cell is redirected to its grandparent with a CAS
+//                   ==> A failed CAS is harmless since parents only move toward the root
+//
+// Parameter   :  parent : Parent of each cell
+//                x      : Target cell
+//
+// Return      :  Root of x
+//-------------------------------------------------------------------------------------------------------
+static long find_root( long *parent, long x )
+{
+
+   while ( true )
+   {
+      long p = __atomic_load_n( parent + x, __ATOMIC_RELAXED );
+      if ( p == x )   return x;
+
+      const long gp = __atomic_load_n( parent + p, __ATOMIC_RELAXED );
+      if ( gp == p )   return p;
+
+      __atomic_compare_exchange_n( parent + x, &p, gp, false, __ATOMIC_RELAXED, __ATOMIC_RELAXED );
+      x = gp;
+   }
+
+} // FUNCTION : find_root
+
+
+
+//-------------------------------------------------------------------------------------------------------
+// Function    :  union_roots
+// Description :  Merge the trees of two cells in the union-find forest
+//
+// Note        :  1. Always link the larger root to the smaller root so that no cycle can be formed when
+//                   called concurrently
+//                2. Retry if another thread has linked the larger root in between
+//
+// Parameter   :  parent : Parent of each cell
+//                a, b   : Target cells
+//
+// Return      :  None
+//-------------------------------------------------------------------------------------------------------
+static void union_roots( long *parent, long a, long b )
+{
+
+   while ( true )
+   {
+      a = find_root( parent, a );
+      b = find_root( parent, b );
+
+      if ( a == b )   return;
+      if ( a <  b )   {  const long t = a;   a = b;   b = t;  }
+
+      long expected = a;
+      if ( __atomic_compare_exchange_n( parent + a, &expected, b, false, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED ) )   return;
+   }
+
+} // FUNCTION : union_roots
+
+
+
+//-------------------------------------------------------------------------------------------------------
+// Function    :  mark_cells
+// Description :  Mark cells with field values above the threshold as active
+//
+// Parameter   :  grid      : Target grid
+//                data      : Field data of this grid
+//                ftype     : Floating-point type of "data"
+//                threshold : Cells with field values > threshold are active
+//                state     : Cell states to be returned
+//
+// Return      :  state
+//-------------------------------------------------------------------------------------------------------
+static void mark_cells( const yt_grid *grid, const void *data, const yt_ftype ftype, const double threshold,
+                        char *state )
+{
+
+   const long ncells = (long)grid->dimensions[0]*grid->dimensions[1]*grid->dimensions[2];
+
+   if ( ftype == YT_FLOAT )
+      for (long c=0; c<ncells; c++)   state[c] = ( ( (const float *)data )[c] > threshold ) ? CELL_ACTIVE : CELL_BELOW;
+   else
+      for (long c=0; c<ncells; c++)   state[c] = ( ( (const double*)data )[c] > threshold ) ? CELL_ACTIVE : CELL_BELOW;
+
+} // FUNCTION : mark_cells
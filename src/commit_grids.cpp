@@ -0,0 +1,265 @@
+#include "yt_combo.h"
+
+
+
+
+//-------------------------------------------------------------------------------------------------------
+// Function    :  commit_grids
+// Description :  Export all grids staged by yt_add_grid() to libyt.hierarchy and libyt.grid_data
+//
+// Note        :  1. Called by yt_inline() after all grids have been added
+//                2. Must be called by the thread holding the Python GIL (i.e., the one calling yt_inline())
+//                3. All grids are exported in bulk so that yt_add_grid() does not need to touch any Python
+//                   object and can thus be called concurrently
+//                4. libyt.grid_data[grid_id] is created on access by get_grid_data()
+//                   ==> Only the hierarchy arrays are filled here
+//                5. Set "g_param_libyt.grids_committed" on success, which is checked by all native routines
+//                   of the libyt module before reading the grids
+//
+// Parameter   :  None
+//
+// Return      :  YT_SUCCESS or YT_FAIL
+//-------------------------------------------------------------------------------------------------------
+int commit_grids()
+{
+
+// record all grids for yt_replay()
+// ==> done here instead of in yt_add_grid() since the capture file is not thread-safe
+   for (long g=0; g<g_param_yt.num_grids; g++)
+      if ( capture_grid( &g_grids[g] ) == YT_FAIL )   return YT_FAIL;
+
+
+// shrink libyt.hierarchy to the grids selected by the grid filter (see compact_grids())
+   PyObject  *py_key, *py_value;
+   Py_ssize_t pos = 0;
+
+   while ( PyDict_Next( g_py_hierarchy, &pos, &py_key, &py_value ) )
+   {
+      PyArrayObject *py_array = (PyArrayObject*)py_value;
+
+      if ( PyArray_DIM( py_array, 0 ) == g_param_yt.num_grids )   continue;
+
+      npy_intp      np_dim[2] = { g_param_yt.num_grids, PyArray_DIM( py_array, 1 ) };
+      PyArray_Dims  np_shape  = { np_dim, 2 };
+      PyObject     *py_result = PyArray_Resize( py_array, &np_shape, 0, NPY_CORDER );
+
+      if ( py_result == NULL )
+      {
+         PyErr_Print();
+         YT_ABORT( "Shrinking libyt.hierarchy to %ld grids ... failed!\n", g_param_yt.num_grids );
+      }
+
+      Py_DECREF( py_result );
+   }
+
+
+// export grid info to libyt.hierarchy
+// note that PyDict_GetItemString() returns a **borrowed** reference ==> no need to call Py_DECREF
+#  define GET_ARRAY( KEY, PY_ARRAY )                                                              \
+   {                                                                                              \
+      if (  ( PY_ARRAY = (PyArrayObject*)PyDict_GetItemString( g_py_hierarchy, KEY ) ) == NULL )  \
+         YT_ABORT( "Accessing the key \"%s\" from libyt.hierarchy ... failed!\n", KEY );          \
+   }
+
+   if ( g_param_libyt.compact_hierarchy )
+   {
+      PyArrayObject *py_parent_offset, *py_dimensions, *py_particle_count, *py_parent_id, *py_levels;
+
+      GET_ARRAY( "grid_parent_offset",  py_parent_offset  );
+      GET_ARRAY( "grid_dimensions",     py_dimensions     );
+      GET_ARRAY( "grid_particle_count", py_particle_count );
+      GET_ARRAY( "grid_parent_id",      py_parent_id      );
+      GET_ARRAY( "grid_levels",         py_levels         );
+
+      npy_uint16 *parent_offset  = (npy_uint16*)PyArray_DATA( py_parent_offset  );
+      npy_uint16 *dimensions     = (npy_uint16*)PyArray_DATA( py_dimensions     );
+      npy_int32  *particle_count = (npy_int32 *)PyArray_DATA( py_particle_count );
+      npy_int32  *parent_id      = (npy_int32 *)PyArray_DATA( py_parent_id      );
+      npy_int8   *levels         = (npy_int8  *)PyArray_DATA( py_levels         );
+
+      for (long g=0; g<g_param_yt.num_grids; g++)
+      {
+         const yt_grid *grid = g_grids + g;
+         long offset[3];
+
+         if ( get_parent_offset( grid, offset ) != YT_SUCCESS )
+            YT_ABORT( "Grid [%ld] cannot be stored in the compact hierarchy!\n", grid->id );
+
+         for (int d=0; d<3; d++)
+         {
+            parent_offset[ 3*g + d ] = offset[d];
+            dimensions   [ 3*g + d ] = grid->dimensions[d];
+         }
+
+         particle_count[g] = grid->particle_count;
+         parent_id     [g] = grid->parent_id;
+         levels        [g] = grid->level;
+      }
+   }
+
+   else
+   {
+      PyArrayObject *py_left_edge, *py_right_edge, *py_dimensions, *py_particle_count, *py_parent_id, *py_levels;
+
+      GET_ARRAY( "grid_left_edge",      py_left_edge      );
+      GET_ARRAY( "grid_right_edge",     py_right_edge     );
+      GET_ARRAY( "grid_dimensions",     py_dimensions     );
+      GET_ARRAY( "grid_particle_count", py_particle_count );
+      GET_ARRAY( "grid_parent_id",      py_parent_id      );
+      GET_ARRAY( "grid_levels",         py_levels         );
+
+      npy_double *left_edge      = (npy_double*)PyArray_DATA( py_left_edge      );
+      npy_double *right_edge     = (npy_double*)PyArray_DATA( py_right_edge     );
+      npy_long   *dimensions     = (npy_long  *)PyArray_DATA( py_dimensions     );
+      npy_long   *particle_count = (npy_long  *)PyArray_DATA( py_particle_count );
+      npy_long   *parent_id      = (npy_long  *)PyArray_DATA( py_parent_id      );
+      npy_long   *levels         = (npy_long  *)PyArray_DATA( py_levels         );
+
+      for (long g=0; g<g_param_yt.num_grids; g++)
+      {
+         const yt_grid *grid = g_grids + g;
+
+         for (int d=0; d<3; d++)
+         {
+            left_edge [ 3*g + d ] = grid->left_edge [d];
+            right_edge[ 3*g + d ] = grid->right_edge[d];
+            dimensions[ 3*g + d ] = grid->dimensions[d];
+         }
+
+         particle_count[g] = grid->particle_count;
+         parent_id     [g] = grid->parent_id;
+         levels        [g] = grid->level;
+      }
+   }
+
+#  undef GET_ARRAY
+
+   log_debug( "Inserting %ld grids to libyt.hierarchy ... done\n", g_param_yt.num_grids );
+
+
+// export the host IDs of the renumbered grids
+   if ( export_grid_order() != YT_SUCCESS )
+      YT_ABORT( "Exporting libyt.grid_permutation ... failed!\n" );
+
+
+// export grid data to libyt.grid_data
+// ==> only the number of grids is set here, and libyt.grid_data[grid_id] is created by get_grid_data() on access
+   PyObject *py_num_grids = PyLong_FromLong( g_param_yt.num_grids );
+   const int status       = PyObject_SetAttrString( g_py_grid_data, "_num_grids", py_num_grids );
+   Py_DECREF( py_num_grids );
+
+   if ( status != 0 )
+   {
+      PyErr_Print();
+      YT_ABORT( "Inserting %ld grids to libyt.grid_data ... failed!\n", g_param_yt.num_grids );
+   }
+
+   log_debug( "Inserting %ld grids to libyt.grid_data ... done\n", g_param_yt.num_grids );
+
+
+// export the declared fields
+   if ( export_field_list() != YT_SUCCESS )
+      YT_ABORT( "Exporting libyt.field_list ... failed!\n" );
+
+
+// export the block pools as single arrays
+   if ( export_block_pools() != YT_SUCCESS )
+      YT_ABORT( "Exporting libyt.block_pools ... failed!\n" );
+
+
+// allow the native routines to read the grids from now on until the end of this step
+   g_param_libyt.grids_committed = true;
+
+
+   return YT_SUCCESS;
+
+} // FUNCTION : commit_grids
+
+
+
+//-------------------------------------------------------------------------------------------------------
+// Function    :  get_grid_data
+// Description :  Create libyt.grid_data[grid_id] as "libyt.grid_data[grid_id][field_label][field_data]"
+//
+// Note        :  1. Python usage: libyt._grid_data( grid_id )
+//                   ==> Called by libyt._grid_data_dict.__missing__() when a grid is accessed for the first
+//                       time at this step, so that the number of Python objects created does not depend on
+//                       the number of grids registered
+//                2. Use libyt._grid_dict for grids with encoded fields, which are decoded on access
+//                3. Fields rejected by the grid filter are skipped
+//                4. Fields that are not cell-centered are wrapped with their own dimensions (see field_dimensions())
+//
+// Parameter   :  self : Not used
+//                args : Tuple of grid ID
+//
+// Return      :  Dictionary of all fields of the grid (new reference), or NULL with a Python exception set
+//-------------------------------------------------------------------------------------------------------
+PyObject *get_grid_data( PyObject *self, PyObject *args )
+{
+
+   long grid_id;
+
+   if ( !PyArg_ParseTuple( args, "l", &grid_id ) )   return NULL;
+
+   if ( !g_param_libyt.grids_committed  ||  grid_id < 0  ||  grid_id >= g_param_yt.num_grids )
+   {
+      PyErr_Format( PyExc_KeyError, "grid [%ld] is not available", grid_id );
+      return NULL;
+   }
+
+   const yt_grid *grid = g_grids + grid_id;
+
+   int      grid_ftype   = (grid->field_ftype == YT_FLOAT ) ? NPY_FLOAT : NPY_DOUBLE;
+   PyObject *py_field_labels, *py_field_data;
+
+// allocate [grid_id][field_label]
+   int num_encoded = 0;
+   for (int v=0; v<grid->num_fields; v++)
+      if ( field_encoding( grid, v ) != YT_ENCODING_NONE  &&  grid_filter_field( grid->field_labels[v] ) )
+         num_encoded ++;
+
+   if ( num_encoded > 0 )
+   {
+      PyObject *py_encoded = PyTuple_New( num_encoded );
+
+      for (int v=0, e=0; v<grid->num_fields; v++)
+         if ( field_encoding( grid, v ) != YT_ENCODING_NONE  &&  grid_filter_field( grid->field_labels[v] ) )
+            PyTuple_SET_ITEM( py_encoded, e++, PyString_FromString( grid->field_labels[v] ) );
+
+      py_field_labels = PyObject_CallFunction( g_py_grid_dict, (char*)"lN", grid->id, py_encoded );
+      if ( py_field_labels == NULL )   return NULL;
+   }
+   else
+      py_field_labels = PyDict_New();
+
+// fill [grid_id][field_label][field_data]
+   for (int v=0; v<grid->num_fields; v++)
+   {
+//    skip the fields decoded on access or rejected by the grid filter
+      if ( field_encoding( grid, v ) != YT_ENCODING_NONE  ||  !grid_filter_field( grid->field_labels[v] ) )
+         continue;
+
+//    PyArray_SimpleNewFromData simply creates an array wrapper and does note allocate and own the array
+      int      field_dims[3];
+      field_dimensions( grid, v, field_dims );
+
+      npy_intp np_dims[3] = { field_dims[0], field_dims[1], field_dims[2] };
+      py_field_data = PyArray_SimpleNewFromData( 3, np_dims, grid_ftype, grid->field_data[v] );
+
+//    add the field data to "libyt.grid_data[grid_id][field_label]"
+//    ==> use the interned key of the declared fields if available
+      PyObject *py_key = field_key( grid, v );
+
+      if ( py_key != NULL )   PyDict_SetItem( py_field_labels, py_key, py_field_data );
+      else                    PyDict_SetItemString( py_field_labels, grid->field_labels[v], py_field_data );
+
+//    track the wrapper to detect views still alive after yt_inline()
+      track_view( grid->id, grid->field_labels[v], py_field_data );
+
+//    call decref since PyDict_SetItemString() returns a new reference
+      Py_DECREF( py_field_data );
+   }
+
+   return py_field_labels;
+
+} // FUNCTION : get_grid_data
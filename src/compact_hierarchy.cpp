@@ -0,0 +1,231 @@
+#include "yt_combo.h"
+#include <math.h>
+#include <string.h>
+
+
+// relative tolerance for checking whether grid edges are aligned with the cells on their level
+static const double EdgeTolerance = 1.0e-6;
+
+
+
+
+//-------------------------------------------------------------------------------------------------------
+// Function    :  get_left_index
+// Description :  Convert the left edge of a grid to the integer cell index on the level of this grid
+//
+// Note        :  1. Used by the compact hierarchy (i.e., "g_param_libyt.compact_hierarchy")
+//                2. Also check whether the grid can be represented by the compact hierarchy
+//                   ==> Edges must be aligned with the cells on the level of this grid, and all data members
+//                       must fit in the integer types of the compact hierarchy
+//                3. Thread-safe
+//
+// Parameter   :  grid       : Target grid
+//                left_index : Cell index of the left edge to be returned
+//
+// Return      :  YT_SUCCESS or YT_FAIL
+//-------------------------------------------------------------------------------------------------------
+int get_left_index( const yt_grid *grid, long left_index[3] )
+{
+
+   if ( grid->level > 127 )
+      YT_ABORT( "Grid [%ld] level [%d] > 127 is not supported by the compact hierarchy!\n", grid->id, grid->level );
+
+   if ( grid->id > INT_UNDEFINED  ||  grid->parent_id > INT_UNDEFINED  ||  grid->particle_count > INT_UNDEFINED )
+      YT_ABORT( "Grid [%ld] ID, parent ID, or particle count exceeds the range of int32 in the compact hierarchy!\n", grid->id );
+
+   for (int d=0; d<3; d++)
+   {
+      if ( grid->dimensions[d] > 65535 )
+         YT_ABORT( "Grid [%ld] dimensions[%d] = %d > 65535 is not supported by the compact hierarchy!\n",
+                   grid->id, d, grid->dimensions[d] );
+
+      const double dh    = ( g_param_yt.domain_right_edge[d] - g_param_yt.domain_left_edge[d] )
+                           / ( g_param_yt.domain_dimensions[d]*pow( (double)g_param_yt.refine_by, grid->level ) );
+      const double index = ( grid->left_edge[d] - g_param_yt.domain_left_edge[d] ) / dh;
+      const double width = ( grid->right_edge[d] - grid->left_edge[d] ) / dh;
+
+      left_index[d] = lround( index );
+
+      if ( fabs( index - left_index[d] ) > EdgeTolerance*MAX( 1.0, fabs(index) )  ||
+           fabs( width - grid->dimensions[d] ) > EdgeTolerance*grid->dimensions[d] )
+         YT_ABORT( "Grid [%ld] edges are not aligned with the cells on level [%d] along the dimension [%d]"
+                   " ==> please disable the compact hierarchy!\n", grid->id, grid->level, d );
+   }
+
+   return YT_SUCCESS;
+
+} // FUNCTION : get_left_index
+
+
+
+//-------------------------------------------------------------------------------------------------------
+// Function    :  get_parent_offset
+// Description :  Get the offset of the left edge of a grid from the left edge of its parent grid, in units of
+//                the cell size on the level of this grid
+//
+// Note        :  1. Called by commit_grids() for the compact hierarchy, after all grids have been staged
+//                   and renumbered
+//                2. Offsets of the grids without parent (e.g., those whose parent is discarded by the grid
+//                   filter) are taken from the domain left edge
+//                3. Offsets must fit in uint16 ==> fail otherwise
+//
+// Parameter   :  grid   : Target grid
+//                offset : Offset to be returned
+//
+// Return      :  YT_SUCCESS or YT_FAIL
+//-------------------------------------------------------------------------------------------------------
+int get_parent_offset( const yt_grid *grid, long offset[3] )
+{
+
+   long left_index[3], parent_index[3] = { 0, 0, 0 }, factor = 1;
+
+   if ( get_left_index( grid, left_index ) != YT_SUCCESS )   return YT_FAIL;
+
+   if ( grid->parent_id >= 0 )
+   {
+      const yt_grid *parent = g_grids + grid->parent_id;
+
+      if ( parent->level >= grid->level )
+         YT_ABORT( "Grid [%ld] level [%d] <= parent grid [%ld] level [%d]!\n",
+                   grid->id, grid->level, parent->id, parent->level );
+
+      if ( get_left_index( parent, parent_index ) != YT_SUCCESS )   return YT_FAIL;
+
+      for (int lv=parent->level; lv<grid->level; lv++)   factor *= g_param_yt.refine_by;
+   }
+
+   for (int d=0; d<3; d++)
+   {
+      offset[d] = left_index[d] - factor*parent_index[d];
+
+      if ( offset[d] < 0  ||  offset[d] > 65535 )
+         YT_ABORT( "Grid [%ld] offset [%ld] from its parent along the dimension [%d] is out of the range [0, 65535]"
+                   " ==> please disable the compact hierarchy!\n", grid->id, offset[d], d );
+   }
+
+   return YT_SUCCESS;
+
+} // FUNCTION : get_parent_offset
+
+
+
+//-------------------------------------------------------------------------------------------------------
+// Function    :  decode_hierarchy
+// Description :  Method "libyt._decode_hierarchy( key )" decoding the left indices and the double edges from
+//                the compact hierarchy
+//
+// Note        :  1. Invoked by libyt.hierarchy.__missing__(), which is called when a key is not found
+//                   ==> "grid_left_index", "grid_left_edge", and "grid_right_edge" are decoded only if Python
+//                       asks for them
+//                2. Left indices are accumulated from the parent offsets level by level, since parent grids
+//                   are always on coarser levels (see get_parent_offset())
+//                3. The decoded array is also inserted into libyt.hierarchy so that it is decoded only once
+//                   per step
+//                4. Raise KeyError for all other keys or if the compact hierarchy is disabled
+//
+// Parameter   :  self : Not used
+//                args : Key to be decoded
+//
+// Return      :  NumPy array [num_grids][3] of the decoded indices or edges, or NULL on error
+//-------------------------------------------------------------------------------------------------------
+PyObject *decode_hierarchy( PyObject *self, PyObject *args )
+{
+
+   PyObject   *py_key;
+   const char *key;
+
+   if ( !PyArg_ParseTuple( args, "O", &py_key ) )   return NULL;
+
+   if ( !PyString_Check( py_key )  ||  !g_param_libyt.compact_hierarchy  ||
+        (  strcmp( key = PyString_AsString( py_key ), "grid_left_index" ) != 0  &&
+           strcmp( key,                               "grid_left_edge"  ) != 0  &&
+           strcmp( key,                               "grid_right_edge" ) != 0     )  )
+   {
+      PyErr_SetObject( PyExc_KeyError, py_key );
+      return NULL;
+   }
+
+
+// get the compact hierarchy (borrowed references)
+   PyArrayObject *py_offset     = (PyArrayObject*)PyDict_GetItemString( g_py_hierarchy, "grid_parent_offset" );
+   PyArrayObject *py_dimensions = (PyArrayObject*)PyDict_GetItemString( g_py_hierarchy, "grid_dimensions"    );
+   PyArrayObject *py_parent_id  = (PyArrayObject*)PyDict_GetItemString( g_py_hierarchy, "grid_parent_id"     );
+   PyArrayObject *py_levels     = (PyArrayObject*)PyDict_GetItemString( g_py_hierarchy, "grid_levels"        );
+
+   if ( py_offset == NULL  ||  py_dimensions == NULL  ||  py_parent_id == NULL  ||  py_levels == NULL )
+   {
+      PyErr_SetString( PyExc_RuntimeError, "libyt.hierarchy has not been set!" );
+      return NULL;
+   }
+
+   const npy_uint16 *offset     = (const npy_uint16*)PyArray_DATA( py_offset     );
+   const npy_uint16 *dimensions = (const npy_uint16*)PyArray_DATA( py_dimensions );
+   const npy_int32  *parent_id  = (const npy_int32 *)PyArray_DATA( py_parent_id  );
+   const npy_int8   *levels     = (const npy_int8  *)PyArray_DATA( py_levels     );
+
+
+// accumulate the left indices from the coarsest level
+   const long num_grids = PyArray_DIM( py_levels, 0 );
+   npy_intp   np_dim[2] = { num_grids, 3 };
+   PyObject  *py_index  = PyArray_SimpleNew( 2, np_dim, NPY_LONG );
+   npy_long  *index     = (npy_long*)PyArray_DATA( (PyArrayObject*)py_index );
+   int        max_level = 0;
+
+   for (long g=0; g<num_grids; g++)   max_level = MAX( max_level, (int)levels[g] );
+
+   for (int lv=0; lv<=max_level; lv++)
+   for (long g=0; g<num_grids; g++)
+   {
+      if ( levels[g] != lv )   continue;
+
+      const long p = parent_id[g];
+      long factor  = 1;
+
+      if ( p >= 0 )
+         for (int l=levels[p]; l<lv; l++)   factor *= g_param_yt.refine_by;
+
+      for (int d=0; d<3; d++)
+         index[ 3*g + d ] = offset[ 3*g + d ] + ( ( p >= 0 ) ? factor*index[ 3*p + d ] : 0 );
+   }
+
+
+// decode edges
+   PyObject *py_result = py_index;
+
+   if ( strcmp( key, "grid_left_index" ) != 0 )
+   {
+      const bool  is_left = ( strcmp( key, "grid_left_edge" ) == 0 );
+      py_result           = PyArray_SimpleNew( 2, np_dim, NPY_DOUBLE );
+      npy_double *edge    = (npy_double*)PyArray_DATA( (PyArrayObject*)py_result );
+
+      double dh0[3];
+      for (int d=0; d<3; d++)
+         dh0[d] = ( g_param_yt.domain_right_edge[d] - g_param_yt.domain_left_edge[d] ) / g_param_yt.domain_dimensions[d];
+
+      for (long g=0; g<num_grids; g++)
+      {
+         const double refine = pow( (double)g_param_yt.refine_by, levels[g] );
+
+         for (int d=0; d<3; d++)
+         {
+            const long cell = index[ 3*g + d ] + ( (is_left) ? 0 : dimensions[ 3*g + d ] );
+            edge[ 3*g + d ] = g_param_yt.domain_left_edge[d] + cell*dh0[d]/refine;
+         }
+      }
+
+      Py_DECREF( py_index );
+   }
+
+
+// cache the decoded array
+   if ( PyDict_SetItem( g_py_hierarchy, py_key, py_result ) != 0 )
+   {
+      Py_DECREF( py_result );
+      return NULL;
+   }
+
+   log_debug( "Decoding \"%s\" from the compact hierarchy ... done\n", key );
+
+   return py_result;
+
+} // FUNCTION : decode_hierarchy
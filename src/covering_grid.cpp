@@ -0,0 +1,322 @@
+#define NO_PYTHON
+#include "yt_combo.h"
+#undef NO_PYTHON
+#include <math.h>
+
+
+
+
+static void   atomic_add( double *target, const double value );
+
+
+
+
+//-------------------------------------------------------------------------------------------------------
+// Function    :  covering_grid
+// Description :  Resample a field onto a uniform grid at the target level
+//
+// Note        :  1. Output cell size = root cell size / refine_by^level
+//                2. Each output cell is the volume-weighted average of
+//                   (a) Data on levels <= target level: the finest grid containing the output cell center is
+//                       prolonged with piecewise-constant or trilinear interpolation
+//                       ==> Trilinear interpolation uses cells of the same grid only and is clamped at grid
+//                           boundaries
+//                   (b) Data on levels  > target level: leaf cells inside the output cell are restricted by
+//                       averaging, and replace (a) in the volume they cover
+//                3. Only grids overlapping the output region are visited (see grid_index_query())
+//                   ==> Grids on the same level are processed in parallel with OpenMP if libyt is compiled
+//                       with -DOPENMP
+//                4. Output cells outside all grids are set to NaN
+//                5. Does not touch any Python object ==> can be called without holding the GIL
+//
+// Parameter   :  level     : Target level
+//                left      : Left edge of the output region
+//                dims      : Number of output cells along each direction
+//                field     : Name of the target field (a field passed to yt_add_grid() or a derived field)
+//                linear    : true  ==> trilinear interpolation when prolonging coarser data
+//                            false ==> piecewise-constant interpolation
+//                out_ftype : Floating-point type of "out"
+//                out       : Output array [dims[0]][dims[1]][dims[2]]
+//
+// Return      :  YT_SUCCESS or YT_FAIL
+//-------------------------------------------------------------------------------------------------------
+int covering_grid( const int level, const double left[3], const int dims[3], const char *field, const bool linear,
+                   const yt_ftype out_ftype, void *out )
+{
+
+   if ( g_grids == NULL )   YT_ABORT( "No grid has been staged!\n" );
+
+   if ( grid_index_build() != YT_SUCCESS )   YT_ABORT( "Building the spatial index ... failed!\n" );
+
+
+// output geometry
+   const long ncells = (long)dims[0]*dims[1]*dims[2];
+   double dh[3], right[3];
+
+   for (int d=0; d<3; d++)
+   {
+      dh   [d] = ( g_param_yt.domain_right_edge[d] - g_param_yt.domain_left_edge[d] )
+               / ( g_param_yt.domain_dimensions[d]*pow( (double)g_param_yt.refine_by, level ) );
+      right[d] = left[d] + dims[d]*dh[d];
+   }
+
+
+// find all overlapping grids and sort them by level
+   long *grid_ids  = new long [ g_param_yt.num_grids ];
+   long  num_found = grid_index_query( left, right, grid_ids );
+   int   max_level = 0;
+
+   for (long t=0; t<num_found; t++)   max_level = MAX( max_level, g_grids[ grid_ids[t] ].level );
+
+   long *level_start = new long [ max_level + 2 ];
+   long *sorted      = new long [ num_found ];
+
+   for (int lv=0; lv<=max_level+1; lv++)   level_start[lv] = 0;
+   for (long t=0; t<num_found; t++)        level_start[ g_grids[ grid_ids[t] ].level + 1 ] ++;
+   for (int lv=0; lv<=max_level; lv++)     level_start[lv+1] += level_start[lv];
+
+   long *fill = new long [ max_level + 1 ];
+   for (int lv=0; lv<=max_level; lv++)     fill[lv] = level_start[lv];
+   for (long t=0; t<num_found; t++)        sorted[ fill[ g_grids[ grid_ids[t] ].level ] ++ ] = grid_ids[t];
+
+   delete [] fill;
+   delete [] grid_ids;
+
+
+// allocate buffers
+   double *base  = new double [ncells];   // prolonged data from levels <= target level
+   double *accum = NULL;                  // restricted data from levels > target level (volume-weighted)
+   double *frac  = NULL;                  // volume fraction covered by levels > target level
+
+   for (long c=0; c<ncells; c++)   base[c] = NAN;
+
+   if ( max_level > level )
+   {
+      accum = new double [ncells];
+      frac  = new double [ncells];
+
+      for (long c=0; c<ncells; c++)   {  accum[c] = 0.0;   frac[c] = 0.0;  }
+   }
+
+   const double out_volume = dh[0]*dh[1]*dh[2];
+   bool         found      = true;
+
+
+// fill output level by level
+   for (int lv=0; lv<=max_level; lv++)
+   {
+#     ifdef OPENMP
+#     pragma omp parallel for schedule( dynamic ) if ( !g_param_libyt.forked_worker )
+#     endif
+      for (long t=level_start[lv]; t<level_start[lv+1]; t++)
+      {
+         const yt_grid *grid = g_grids + sorted[t];
+         yt_ftype ftype;
+         bool     allocated;
+         void    *data = get_field_data( grid, field, &ftype, &allocated );
+
+         if ( data == NULL )
+         {
+            found = false;
+            continue;
+         }
+
+//       range of output cells overlapping with this grid
+         int lo[3], hi[3];
+         for (int d=0; d<3; d++)
+         {
+            lo[d] = MAX( 0,       (int)floor( ( grid->left_edge [d] - left[d] )/dh[d] ) );
+            hi[d] = MIN( dims[d], (int)ceil ( ( grid->right_edge[d] - left[d] )/dh[d] ) );
+         }
+
+//       (a) prolong coarser data ==> grids on finer levels overwrite cells they contain
+         if ( lv <= level )
+         {
+            for (int i=lo[0]; i<hi[0]; i++)
+            for (int j=lo[1]; j<hi[1]; j++)
+            for (int k=lo[2]; k<hi[2]; k++)
+            {
+               const double pos[3] = { left[0] + (i+0.5)*dh[0], left[1] + (j+0.5)*dh[1], left[2] + (k+0.5)*dh[2] };
+
+               if ( pos[0] <  grid->left_edge[0]  ||  pos[1] <  grid->left_edge[1]  ||  pos[2] <  grid->left_edge[2]  ||
+                    pos[0] >= grid->right_edge[0] ||  pos[1] >= grid->right_edge[1] ||  pos[2] >= grid->right_edge[2]    )
+                  continue;
+
+               base[ ( (long)i*dims[1] + j )*dims[2] + k ] = sample_grid( grid, data, ftype, pos, linear );
+            }
+         }
+
+//       (b) restrict finer leaf cells
+         else
+         {
+            const int *gdim = grid->dimensions;
+            char      *leaf = new char [ (long)gdim[0]*gdim[1]*gdim[2] ];
+            double     gdh[3];
+
+            for (long c=0; c<(long)gdim[0]*gdim[1]*gdim[2]; c++)   leaf[c] = true;
+            grid_index_mark_covered( grid->id, leaf, false );
+
+            for (int d=0; d<3; d++)   gdh[d] = ( grid->right_edge[d] - grid->left_edge[d] ) / gdim[d];
+
+            const double weight = gdh[0]*gdh[1]*gdh[2] / out_volume;
+
+            for (int i=0; i<gdim[0]; i++)
+            for (int j=0; j<gdim[1]; j++)
+            for (int k=0; k<gdim[2]; k++)
+            {
+               const long c = ( (long)i*gdim[1] + j )*gdim[2] + k;
+
+               if ( !leaf[c] )   continue;
+
+               const int idx[3] = { (int)floor( ( grid->left_edge[0] + (i+0.5)*gdh[0] - left[0] )/dh[0] ),
+                                    (int)floor( ( grid->left_edge[1] + (j+0.5)*gdh[1] - left[1] )/dh[1] ),
+                                    (int)floor( ( grid->left_edge[2] + (k+0.5)*gdh[2] - left[2] )/dh[2] ) };
+
+               if ( idx[0] < 0  ||  idx[0] >= dims[0]  ||  idx[1] < 0  ||  idx[1] >= dims[1]  ||
+                    idx[2] < 0  ||  idx[2] >= dims[2] )
+                  continue;
+
+               const long   o     = ( (long)idx[0]*dims[1] + idx[1] )*dims[2] + idx[2];
+               const double value = ( ftype == YT_FLOAT ) ? ( (float*)data )[c] : ( (double*)data )[c];
+
+               atomic_add( accum + o, value*weight );
+               atomic_add( frac  + o,       weight );
+            }
+
+            delete [] leaf;
+         }
+
+         if ( allocated )   delete [] (char*)data;
+      } // for (long t=level_start[lv]; t<level_start[lv+1]; t++)
+   } // for (int lv=0; lv<=max_level; lv++)
+
+
+// combine and store the results
+   if ( found )
+   {
+#     ifdef OPENMP
+#     pragma omp parallel for schedule( static ) if ( !g_param_libyt.forked_worker )
+#     endif
+      for (long c=0; c<ncells; c++)
+      {
+         double value = base[c];
+
+         if ( accum != NULL  &&  frac[c] > 0.0 )
+         {
+            const double f = MIN( 1.0, frac[c] );
+            value = ( f < 1.0 ) ? accum[c] + ( 1.0 - f )*base[c] : accum[c]/frac[c];
+         }
+
+         if ( out_ftype == YT_FLOAT )   ( (float *)out )[c] = (float)value;
+         else                           ( (double*)out )[c] = value;
+      }
+   }
+
+   delete [] level_start;
+   delete [] sorted;
+   delete [] base;
+   delete [] accum;
+   delete [] frac;
+
+   if ( !found )   YT_ABORT( "Field \"%s\" is not found in all grids!\n", field );
+
+   log_debug( "Resampling \"%s\" onto a covering grid at level %d with %d x %d x %d cells ... done\n",
+              field, level, dims[0], dims[1], dims[2] );
+
+   return YT_SUCCESS;
+
+} // FUNCTION : covering_grid
+
+
+
+//-------------------------------------------------------------------------------------------------------
+// Function    :  sample_grid
+// Description :  Interpolate the field of a grid at the target point
+//
+// Note        :  1. Piecewise-constant: value of the cell containing the point
+//                   Trilinear           : interpolate the 8 nearest cell centers of this grid, with indices
+//                                         clamped at grid boundaries
+//                2. Also used by sample_points()
+//
+// Parameter   :  grid   : Target grid
+//                data   : Field data of this grid
+//                ftype  : Floating-point type of "data"
+//                pos    : Target point (must lie inside this grid)
+//                linear : true ==> trilinear interpolation
+//
+// Return      :  Interpolated value
+//-------------------------------------------------------------------------------------------------------
+double sample_grid( const yt_grid *grid, const void *data, const yt_ftype ftype, const double pos[3],
+                    const bool linear )
+{
+
+   const int *dim = grid->dimensions;
+
+#  define VALUE( i, j, k )                                                            \
+   (  ( ftype == YT_FLOAT ) ? (double)( (const float *)data )[ ( (long)(i)*dim[1] + (j) )*dim[2] + (k) ]   \
+                            :         ( (const double*)data )[ ( (long)(i)*dim[1] + (j) )*dim[2] + (k) ]  )
+
+   double x[3];
+   for (int d=0; d<3; d++)
+      x[d] = ( pos[d] - grid->left_edge[d] ) / ( grid->right_edge[d] - grid->left_edge[d] ) * dim[d];
+
+   if ( !linear )
+   {
+      const int i = MIN( dim[0]-1, (int)x[0] );
+      const int j = MIN( dim[1]-1, (int)x[1] );
+      const int k = MIN( dim[2]-1, (int)x[2] );
+
+      return VALUE( i, j, k );
+   }
+
+   int    idx[3][2];
+   double w  [3][2];
+
+   for (int d=0; d<3; d++)
+   {
+      const double f  = x[d] - 0.5;
+      const int    i0 = (int)floor( f );
+      const double t  = f - i0;
+
+      idx[d][0] = MAX( 0, MIN( dim[d]-1, i0   ) );
+      idx[d][1] = MAX( 0, MIN( dim[d]-1, i0+1 ) );
+      w  [d][0] = 1.0 - t;
+      w  [d][1] = t;
+   }
+
+   double value = 0.0;
+   for (int a=0; a<2; a++)
+   for (int b=0; b<2; b++)
+   for (int c=0; c<2; c++)
+      value += w[0][a]*w[1][b]*w[2][c]*VALUE( idx[0][a], idx[1][b], idx[2][c] );
+
+#  undef VALUE
+
+   return value;
+
+} // FUNCTION : sample_grid
+
+
+
+//-------------------------------------------------------------------------------------------------------
+// Function    :  atomic_add
+// Description :  Atomically add a value to a double
+//
+// Note        :  1. Implemented with a CAS loop since there is no atomic floating-point addition
+//
+// Parameter   :  target : Target double
+//                value  : Value to be added
+//
+// Return      :  target
+//-------------------------------------------------------------------------------------------------------
+static void atomic_add( double *target, const double value )
+{
+
+   double expected, desired;
+
+   __atomic_load( target, &expected, __ATOMIC_RELAXED );
+
+   do    desired = expected + value;
+   while (  !__atomic_compare_exchange( target, &expected, &desired, false, __ATOMIC_RELAXED, __ATOMIC_RELAXED )  );
+
+} // FUNCTION : atomic_add
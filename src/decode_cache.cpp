@@ -0,0 +1,252 @@
+#include "yt_combo.h"
+#include <string.h>
+
+
+// decoded fields ordered from the most to the least recently used
+// ==> also chained in a hash table keyed on (grid_id, field) so that a cache hit does not scan the list
+struct cache_entry
+{
+   long         grid_id;
+   int          field;      // index of the field in the grid
+   PyObject    *array;      // decoded NumPy array (new reference)
+   long         nbytes;
+   cache_entry *prev;
+   cache_entry *next;
+   cache_entry *hash_next;  // next entry in the same hash bucket
+};
+
+static cache_entry  *Head     = NULL;
+static cache_entry  *Tail     = NULL;
+static long          NBytes   = 0;
+static cache_entry **Buckets  = NULL;   // [NBuckets]
+static long          NBuckets = 0;      // power of two
+static long          NEntries = 0;
+
+static void         cache_unlink( cache_entry *entry );
+static void         cache_push_front( cache_entry *entry );
+static cache_entry *cache_find( const long grid_id, const int field );
+
+
+
+
+//-------------------------------------------------------------------------------------------------------
+// Function    :  get_decoded_field
+// Description :  Decode an encoded field of a grid on access
+//
+// Note        :  1. Python usage: libyt._decode_field( grid_id, field_label )
+//                   ==> Called by libyt._grid_dict.__missing__() for the encoded fields of each grid in
+//                       libyt.grid_data (see commit_grids())
+//                2. Decoded arrays are kept in a least-recently-used cache bounded by
+//                   "g_param_libyt.decode_cache_mb"
+//                   ==> Arrays evicted from the cache stay valid as long as Python refers to them
+//                3. Decoding releases the GIL
+//
+// Parameter   :  self : Not used
+//                args : Tuple of grid ID and field label
+//
+// Return      :  Decoded field as a NumPy array of "field_ftype" (new reference), or NULL with a Python
+//                exception set
+//-------------------------------------------------------------------------------------------------------
+PyObject *get_decoded_field( PyObject *self, PyObject *args )
+{
+
+   long        grid_id;
+   const char *label;
+
+   if ( !PyArg_ParseTuple( args, "ls", &grid_id, &label ) )   return NULL;
+
+   if ( !g_param_libyt.grids_committed  ||  grid_id < 0  ||  grid_id >= g_param_yt.num_grids )
+   {
+      PyErr_Format( PyExc_IndexError, "grid [%ld] is not available", grid_id );
+      return NULL;
+   }
+
+   const yt_grid *grid = g_grids + grid_id;
+   int field = -1;
+
+   for (int v=0; v<grid->num_fields; v++)
+   {
+      if ( strcmp( grid->field_labels[v], label ) == 0  &&  field_encoding( grid, v ) != YT_ENCODING_NONE )
+      {
+         field = v;
+         break;
+      }
+   }
+
+   if ( field < 0 )
+   {
+      PyErr_Format( PyExc_KeyError, "encoded field \"%s\" is not found in grid [%ld]", label, grid_id );
+      return NULL;
+   }
+
+
+// cache hit
+   cache_entry *hit = cache_find( grid_id, field );
+
+   if ( hit != NULL )
+   {
+      cache_unlink( hit );
+      cache_push_front( hit );
+
+      Py_INCREF( hit->array );
+      return hit->array;
+   }
+
+
+// cache miss ==> decode
+   npy_intp  grid_dims[3] = { grid->dimensions[0], grid->dimensions[1], grid->dimensions[2] };
+   PyObject *py_array     = PyArray_SimpleNew( 3, grid_dims, ( grid->field_ftype == YT_FLOAT ) ? NPY_FLOAT : NPY_DOUBLE );
+   if ( py_array == NULL )   return NULL;
+
+   {
+      yt_nogil_guard nogil;
+      decode_field( grid, field, PyArray_DATA( (PyArrayObject*)py_array ) );
+   }
+
+   const long   nbytes = PyArray_NBYTES( (PyArrayObject*)py_array );
+   const double cap    = g_param_libyt.decode_cache_mb*1024.0*1024.0;
+
+   if ( nbytes > cap )   return py_array;
+
+
+// insert to the cache and evict the least recently used arrays
+   cache_entry *entry = new cache_entry;
+   entry->grid_id = grid_id;
+   entry->field   = field;
+   entry->array   = py_array;
+   entry->nbytes  = nbytes;
+
+   Py_INCREF( py_array );
+   cache_push_front( entry );
+
+   while ( NBytes > cap )
+   {
+      cache_entry *victim = Tail;
+
+      cache_unlink( victim );
+      Py_DECREF( victim->array );
+      delete victim;
+   }
+
+   return py_array;
+
+} // FUNCTION : get_decoded_field
+
+
+
+//-------------------------------------------------------------------------------------------------------
+// Function    :  decode_cache_clear
+// Description :  Release all decoded fields in the cache
+//
+// Note        :  1. Called by yt_inline() at the end of each analysis since grid IDs are only valid within
+//                   a single step
+//
+// Parameter   :  None
+//
+// Return      :  None
+//-------------------------------------------------------------------------------------------------------
+void decode_cache_clear()
+{
+
+   while ( Head != NULL )
+   {
+      cache_entry *entry = Head;
+
+      cache_unlink( entry );
+      Py_DECREF( entry->array );
+      delete entry;
+   }
+
+   delete [] Buckets;
+   Buckets  = NULL;
+   NBuckets = 0;
+
+} // FUNCTION : decode_cache_clear
+
+
+
+//-------------------------------------------------------------------------------------------------------
+// Function    :  cache_unlink / cache_push_front / cache_find
+// Description :  Remove an entry from the cache / insert an entry as the most recently used one / find the
+//                entry of a field of a grid
+//
+// Note        :  1. The hash table is doubled once the number of entries exceeds the number of buckets
+//-------------------------------------------------------------------------------------------------------
+static inline long cache_bucket( const long grid_id, const int field )
+{
+
+   const unsigned long key = (unsigned long)grid_id*2654435761UL + (unsigned long)field*40503UL;
+
+   return (long)( ( key ^ ( key >> 16 ) ) & (unsigned long)( NBuckets - 1 ) );
+
+} // FUNCTION : cache_bucket
+
+
+static void cache_unlink( cache_entry *entry )
+{
+
+   if ( entry->prev != NULL )   entry->prev->next = entry->next;
+   else                         Head              = entry->next;
+
+   if ( entry->next != NULL )   entry->next->prev = entry->prev;
+   else                         Tail              = entry->prev;
+
+   cache_entry **link = Buckets + cache_bucket( entry->grid_id, entry->field );
+   while ( *link != entry )   link = &(*link)->hash_next;
+   *link = entry->hash_next;
+
+   NBytes -= entry->nbytes;
+   NEntries --;
+
+} // FUNCTION : cache_unlink
+
+
+static void cache_push_front( cache_entry *entry )
+{
+
+   entry->prev = NULL;
+   entry->next = Head;
+
+   if ( Head != NULL )   Head->prev = entry;
+   else                  Tail       = entry;
+
+   Head    = entry;
+   NBytes += entry->nbytes;
+   NEntries ++;
+
+// rehash all entries into twice as many buckets
+   if ( NEntries > NBuckets )
+   {
+      delete [] Buckets;
+      NBuckets = ( NBuckets == 0 ) ? 64 : 2*NBuckets;
+      Buckets  = new cache_entry* [NBuckets];
+      for (long b=0; b<NBuckets; b++)   Buckets[b] = NULL;
+
+      for (cache_entry *e=Head; e!=NULL; e=e->next)
+      {
+         const long b = cache_bucket( e->grid_id, e->field );
+         e->hash_next = Buckets[b];
+         Buckets[b]   = e;
+      }
+   }
+   else
+   {
+      const long b = cache_bucket( entry->grid_id, entry->field );
+      entry->hash_next = Buckets[b];
+      Buckets[b]       = entry;
+   }
+
+} // FUNCTION : cache_push_front
+
+
+static cache_entry *cache_find( const long grid_id, const int field )
+{
+
+   if ( NBuckets == 0 )   return NULL;
+
+   for (cache_entry *entry=Buckets[ cache_bucket( grid_id, field ) ]; entry!=NULL; entry=entry->hash_next)
+      if ( entry->grid_id == grid_id  &&  entry->field == field )   return entry;
+
+   return NULL;
+
+} // FUNCTION : cache_find
@@ -0,0 +1,183 @@
+#define NO_PYTHON
+#include "yt_combo.h"
+#include <string.h>
+
+
+// number of cells passed to each kernel call
+// ==> large enough to amortize the call overhead and let the compiler vectorize the kernel loop,
+//     small enough for the inputs and output of a segment to stay in cache
+static const long SegmentSize = 4096;
+
+
+
+
+//-------------------------------------------------------------------------------------------------------
+// Function    :  find_derived_field
+// Description :  Return the derived field registered by yt_add_derived_field() with the target name
+//
+// Note        :  None
+//
+// Parameter   :  name : Name of the target derived field
+//
+// Return      :  Pointer to the derived field or NULL if not found
+//-------------------------------------------------------------------------------------------------------
+const yt_derived_field *find_derived_field( const char *name )
+{
+
+   for (int f=0; f<g_num_derived_fields; f++)
+      if ( strcmp( g_derived_fields[f].name, name ) == 0 )   return g_derived_fields + f;
+
+   return NULL;
+
+} // FUNCTION : find_derived_field
+
+
+
+//-------------------------------------------------------------------------------------------------------
+// Function    :  evaluate_derived_field
+// Description :  Compute a derived field of a single grid by calling its native kernel
+//
+// Note        :  1. Cells are split into segments of "SegmentSize" cells, each of which is passed to
+//                   a separate kernel call
+//                   ==> Segments are processed in parallel with OpenMP if libyt is compiled with -DOPENMP
+//                2. Does not touch any Python object ==> can be called without holding the GIL
+//
+// Parameter   :  field  : Target derived field
+//                grid   : Target grid
+//                inputs : Data of each input field of this grid (in the order of "field->input_labels")
+//                output : Output array with "grid->dimensions" cells
+//
+// Return      :  None
+//-------------------------------------------------------------------------------------------------------
+void evaluate_derived_field( const yt_derived_field *field, const yt_grid *grid, const void **inputs, void *output )
+{
+
+   const long   ncells      = (long)grid->dimensions[0]*grid->dimensions[1]*grid->dimensions[2];
+   const long   nsegments   = ( ncells + SegmentSize - 1 ) / SegmentSize;
+   const size_t input_size  = ( grid->field_ftype  == YT_FLOAT ) ? sizeof(float) : sizeof(double);
+   const size_t output_size = ( field->output_ftype == YT_FLOAT ) ? sizeof(float) : sizeof(double);
+
+#  ifdef OPENMP
+#  pragma omp parallel if ( !g_param_libyt.forked_worker )
+#  endif
+   {
+      const void **segment_inputs = new const void* [ field->num_inputs ];
+
+#     ifdef OPENMP
+#     pragma omp for schedule( static )
+#     endif
+      for (long s=0; s<nsegments; s++)
+      {
+         const long start = s*SegmentSize;
+         const long size  = MIN( SegmentSize, ncells - start );
+
+         for (int v=0; v<field->num_inputs; v++)
+            segment_inputs[v] = (const char*)inputs[v] + start*input_size;
+
+         field->kernel( segment_inputs, (char*)output + start*output_size, size );
+      }
+
+      delete [] segment_inputs;
+   } // OpenMP parallel region
+
+} // FUNCTION : evaluate_derived_field
+
+
+
+//-------------------------------------------------------------------------------------------------------
+// Function    :  find_field_data
+// Description :  Return the data of a field stored in a grid
+//
+// Note        :  1. Only search the fields passed to yt_add_grid() (i.e., not derived fields)
+//                2. Encoded fields are not returned since their data cannot be used directly
+//                3. Fields that are not cell-centered are not returned since they do not match the grid
+//                   dimensions
+//
+// Parameter   :  grid  : Target grid
+//                label : Name of the target field
+//
+// Return      :  Pointer to the field data or NULL if not found
+//-------------------------------------------------------------------------------------------------------
+void *find_field_data( const yt_grid *grid, const char *label )
+{
+
+   for (int v=0; v<grid->num_fields; v++)
+      if ( strcmp( grid->field_labels[v], label ) == 0  &&  field_encoding( grid, v ) == YT_ENCODING_NONE  &&
+           field_centering( grid, v ) == YT_CELL_CENTERED )
+         return grid->field_data[v];
+
+   return NULL;
+
+} // FUNCTION : find_field_data
+
+
+
+//-------------------------------------------------------------------------------------------------------
+// Function    :  get_field_data
+// Description :  Return the data of either a field stored in a grid or a derived field
+//
+// Note        :  1. Derived fields and encoded fields are computed into a new buffer, which must be free'd by
+//                   the caller with "delete [] (char*)data" if "allocated" is set to true
+//                2. Used by native analysis routines (e.g., find_clumps())
+//                3. Thread-safe
+//
+// Parameter   :  grid      : Target grid
+//                label     : Name of the target field
+//                ftype     : Floating-point type of the returned data
+//                allocated : true ==> the returned data must be free'd by the caller
+//
+// Return      :  Pointer to the field data or NULL if not found
+//-------------------------------------------------------------------------------------------------------
+void *get_field_data( const yt_grid *grid, const char *label, yt_ftype *ftype, bool *allocated )
+{
+
+// field stored in the grid
+   void *data = find_field_data( grid, label );
+
+   *allocated = false;
+   *ftype     = grid->field_ftype;
+
+   if ( data != NULL )   return data;
+
+
+// encoded field stored in the grid
+   const long ncells = (long)grid->dimensions[0]*grid->dimensions[1]*grid->dimensions[2];
+
+   for (int v=0; v<grid->num_fields; v++)
+   {
+      if ( strcmp( grid->field_labels[v], label ) != 0  ||  field_encoding( grid, v ) == YT_ENCODING_NONE )   continue;
+
+      data       = new char [ ncells*( ( grid->field_ftype == YT_FLOAT ) ? sizeof(float) : sizeof(double) ) ];
+      *allocated = true;
+
+      decode_field( grid, v, data );
+
+      return data;
+   }
+
+
+// derived field
+   const yt_derived_field *field = find_derived_field( label );
+
+   if ( field == NULL )   return NULL;
+
+   const void **inputs = new const void* [ field->num_inputs ];
+   bool found = true;
+
+   for (int v=0; v<field->num_inputs; v++)
+      if (  ( inputs[v] = find_field_data( grid, field->input_labels[v] ) ) == NULL  )   found = false;
+
+   if ( found )
+   {
+      data       = new char [ ncells*( ( field->output_ftype == YT_FLOAT ) ? sizeof(float) : sizeof(double) ) ];
+      *allocated = true;
+      *ftype     = field->output_ftype;
+
+      evaluate_derived_field( field, grid, inputs, data );
+   }
+
+   delete [] inputs;
+
+   return data;
+
+} // FUNCTION : get_field_data
@@ -0,0 +1,87 @@
+#define NO_PYTHON
+#include "yt_combo.h"
+#undef NO_PYTHON
+
+
+
+
+//-------------------------------------------------------------------------------------------------------
+// Function    :  field_encoding
+// Description :  Return the encoding of a field stored in a grid
+//
+// Parameter   :  grid : Target grid
+//                v    : Index of the target field
+//
+// Return      :  YT_ENCODING_NONE, YT_FIXED16, or YT_BLOCK8
+//-------------------------------------------------------------------------------------------------------
+yt_encoding field_encoding( const yt_grid *grid, const int v )
+{
+
+   return ( grid->field_codec == NULL ) ? YT_ENCODING_NONE : grid->field_codec[v].encoding;
+
+} // FUNCTION : field_encoding
+
+
+
+//-------------------------------------------------------------------------------------------------------
+// Function    :  decode_field
+// Description :  Decode an encoded field of a grid
+//
+// Note        :  1. Decoded to "grid->field_ftype"
+//                2. Thread-safe
+//
+// Parameter   :  grid   : Target grid
+//                v      : Index of the target field
+//                output : Output buffer of (number of cells) elements of "grid->field_ftype"
+//
+// Return      :  YT_SUCCESS or YT_FAIL
+//-------------------------------------------------------------------------------------------------------
+template <typename T>
+static void decode( const yt_grid *grid, const int v, T *output )
+{
+
+   const long ncells = (long)grid->dimensions[0]*grid->dimensions[1]*grid->dimensions[2];
+
+   switch ( grid->field_codec[v].encoding )
+   {
+      case YT_FIXED16 :
+      {
+         const unsigned short *input  = (const unsigned short*)grid->field_data[v];
+         const double          scale  = grid->field_codec[v].scale;
+         const double          offset = grid->field_codec[v].offset;
+
+         for (long t=0; t<ncells; t++)   output[t] = (T)( offset + scale*input[t] );
+         break;
+      }
+
+      case YT_BLOCK8 :
+      {
+         const yt_block8 *input = (const yt_block8*)grid->field_data[v];
+
+         for (long t=0; t<ncells; t++)
+         {
+            const yt_block8 *block = input + t/8;
+            output[t] = (T)block->base + (T)block->step*block->q[ t%8 ];
+         }
+         break;
+      }
+
+      default :
+         break;
+   }
+
+} // FUNCTION : decode
+
+
+int decode_field( const yt_grid *grid, const int v, void *output )
+{
+
+   if ( field_encoding( grid, v ) == YT_ENCODING_NONE )
+      YT_ABORT( "Field \"%s\" of grid [%ld] is not encoded!\n", grid->field_labels[v], grid->id );
+
+   if ( grid->field_ftype == YT_FLOAT )   decode( grid, v, (float *)output );
+   else                                   decode( grid, v, (double*)output );
+
+   return YT_SUCCESS;
+
+} // FUNCTION : decode_field
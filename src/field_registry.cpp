@@ -0,0 +1,288 @@
+#include "yt_combo.h"
+#include <string.h>
+
+
+// copy of the names and units of "g_fields"
+static char **Field_Names = NULL;
+static char **Field_Units = NULL;
+
+// interned Python keys of "g_fields" (rebuilt by export_field_list() after each declaration)
+static PyObject **Field_Keys = NULL;
+static int        NKey       = 0;
+static bool       KeyStale   = false;
+
+// true ==> all declared fields are cell-centered
+static bool CellOnly = true;
+
+static const char *CenteringName[] = { "cell", "node", "face_x", "face_y", "face_z" };
+
+
+
+
+//-------------------------------------------------------------------------------------------------------
+// Function    :  field_registry_init / field_registry_free
+// Description :  Store the declared fields to "g_fields" / release them
+//
+// Note        :  1. Called by yt_declare_fields()
+//                2. Names and units are copied since the input array may be free'd after
+//                   yt_declare_fields() returns
+//                3. The interned Python keys are released by export_field_list(), which holds the GIL
+//
+// Parameter   :  num_fields  : Number of fields
+//                fields      : Array of fields
+//                field_ftype : Floating-point type of all fields
+//
+// Return      :  YT_SUCCESS or YT_FAIL
+//-------------------------------------------------------------------------------------------------------
+int field_registry_init( const int num_fields, const yt_field *fields, const yt_ftype field_ftype )
+{
+
+// yt_grid stores a single floating-point type for all fields
+   if ( field_ftype != YT_FLOAT  &&  field_ftype != YT_DOUBLE )
+      YT_ABORT( "Unknown \"%s\" == %d!\n", "field_ftype", field_ftype );
+
+   for (int v=0; v<num_fields; v++)
+   {
+      if ( fields[v].validate() != YT_SUCCESS )
+         YT_ABORT( "Validating field [%d] ... failed\n", v );
+
+      for (int u=0; u<v; u++)
+         if ( strcmp( fields[u].field_name, fields[v].field_name ) == 0 )
+            YT_ABORT( "Field \"%s\" has been declared already!\n", fields[v].field_name );
+   }
+
+   field_registry_free();
+
+   g_num_fields   = num_fields;
+   g_fields_ftype = field_ftype;
+   g_fields       = new yt_field [num_fields];
+   Field_Names  = new char*    [num_fields];
+   Field_Units  = new char*    [num_fields];
+   CellOnly     = true;
+
+   for (int v=0; v<num_fields; v++)
+   {
+      const char *unit = ( fields[v].field_unit == NULL ) ? "" : fields[v].field_unit;
+
+      Field_Names[v] = new char [ strlen( fields[v].field_name ) + 1 ];
+      Field_Units[v] = new char [ strlen( unit ) + 1 ];
+      strcpy( Field_Names[v], fields[v].field_name );
+      strcpy( Field_Units[v], unit );
+
+      g_fields[v]            = fields[v];
+      g_fields[v].field_name = Field_Names[v];
+      g_fields[v].field_unit = Field_Units[v];
+
+      if ( fields[v].field_centering != YT_CELL_CENTERED )   CellOnly = false;
+   }
+
+   return YT_SUCCESS;
+
+} // FUNCTION : field_registry_init
+
+
+void field_registry_free()
+{
+
+   for (int v=0; v<g_num_fields; v++)
+   {
+      delete [] Field_Names[v];
+      delete [] Field_Units[v];
+   }
+
+   delete [] Field_Names;
+   delete [] Field_Units;
+   delete [] g_fields;
+
+   Field_Names  = NULL;
+   Field_Units  = NULL;
+   g_fields       = NULL;
+   g_num_fields   = 0;
+   g_fields_ftype = YT_FTYPE_UNKNOWN;
+   CellOnly       = true;
+   KeyStale     = true;
+
+// Python objects cannot be released after Py_Finalize() (i.e., in yt_finalize())
+   if ( !Py_IsInitialized() )
+   {
+      delete [] Field_Keys;
+      Field_Keys = NULL;
+      NKey       = 0;
+   }
+
+} // FUNCTION : field_registry_free
+
+
+
+//-------------------------------------------------------------------------------------------------------
+// Function    :  field_registry_labels
+// Description :  Return the names of all declared fields
+//
+// Note        :  1. Used as "yt_grid::field_labels" of the grids that do not set their own labels
+//                   ==> Field "v" of these grids is the declared field "v"
+//
+// Parameter   :  None
+//
+// Return      :  Pointer array of field names (NULL if no field is declared)
+//-------------------------------------------------------------------------------------------------------
+const char **field_registry_labels()
+{
+
+   return (const char**)Field_Names;
+
+} // FUNCTION : field_registry_labels
+
+
+
+//-------------------------------------------------------------------------------------------------------
+// Function    :  field_registry_find
+// Description :  Return the index of a declared field
+//
+// Parameter   :  label : Name of the target field
+//
+// Return      :  Index in "g_fields" or -1 if not declared
+//-------------------------------------------------------------------------------------------------------
+int field_registry_find( const char *label )
+{
+
+   for (int v=0; v<g_num_fields; v++)
+      if ( strcmp( Field_Names[v], label ) == 0 )   return v;
+
+   return -1;
+
+} // FUNCTION : field_registry_find
+
+
+
+//-------------------------------------------------------------------------------------------------------
+// Function    :  field_centering
+// Description :  Return the centering of a field of a grid
+//
+// Note        :  1. O(1) if all declared fields are cell-centered or the grid uses the declared labels
+//                2. Fields that are not declared are cell-centered
+//
+// Parameter   :  grid : Target grid
+//                v    : Index of the target field in the grid
+//
+// Return      :  Centering of the field
+//-------------------------------------------------------------------------------------------------------
+yt_centering field_centering( const yt_grid *grid, const int v )
+{
+
+   if ( CellOnly )   return YT_CELL_CENTERED;
+
+   if ( grid->field_labels == field_registry_labels() )   return g_fields[v].field_centering;
+
+   const int f = field_registry_find( grid->field_labels[v] );
+
+   return ( f < 0 ) ? YT_CELL_CENTERED : g_fields[f].field_centering;
+
+} // FUNCTION : field_centering
+
+
+
+//-------------------------------------------------------------------------------------------------------
+// Function    :  field_dimensions
+// Description :  Return the array dimensions of a field of a grid
+//
+// Note        :  1. Node-centered fields have one more point along all directions, and face-centered
+//                   fields have one more point along their direction
+//
+// Parameter   :  grid : Target grid
+//                v    : Index of the target field in the grid
+//                dims : Array dimensions to be returned
+//
+// Return      :  dims
+//-------------------------------------------------------------------------------------------------------
+void field_dimensions( const yt_grid *grid, const int v, int dims[3] )
+{
+
+   const yt_centering centering = field_centering( grid, v );
+
+   for (int d=0; d<3; d++)
+   {
+      dims[d] = grid->dimensions[d];
+
+      if ( centering == YT_NODE_CENTERED  ||  centering == YT_FACE_CENTERED_X + d )   dims[d] ++;
+   }
+
+} // FUNCTION : field_dimensions
+
+
+
+//-------------------------------------------------------------------------------------------------------
+// Function    :  export_field_list
+// Description :  Export the declared fields to libyt.field_list and intern their names
+//
+// Note        :  1. Called by commit_grids()
+//                2. Only done again after yt_declare_fields() is called again
+//                3. libyt.field_list[name] = { "dtype": ..., "unit": ..., "centering": ... }
+//
+// Parameter   :  None
+//
+// Return      :  YT_SUCCESS or YT_FAIL
+//-------------------------------------------------------------------------------------------------------
+int export_field_list()
+{
+
+   if ( !KeyStale )   return YT_SUCCESS;
+
+   for (int v=0; v<NKey; v++)   Py_XDECREF( Field_Keys[v] );
+   delete [] Field_Keys;
+
+   NKey       = g_num_fields;
+   Field_Keys = ( NKey > 0 ) ? new PyObject* [NKey] : NULL;
+
+   PyObject *py_libyt = PyImport_AddModule( "libyt" );   // borrowed reference
+   PyObject *py_list  = PyDict_New();
+
+   for (int v=0; v<NKey; v++)
+   {
+      Field_Keys[v] = PyString_InternFromString( g_fields[v].field_name );
+
+      PyObject *py_field = Py_BuildValue( "{s:s,s:s,s:s}",
+                                          "dtype",     ( g_fields_ftype == YT_FLOAT ) ? "float32" : "float64",
+                                          "unit",      g_fields[v].field_unit,
+                                          "centering", CenteringName[ g_fields[v].field_centering ] );
+      PyDict_SetItem( py_list, Field_Keys[v], py_field );
+      Py_DECREF( py_field );
+   }
+
+   const int status = PyObject_SetAttrString( py_libyt, "field_list", py_list );
+   Py_DECREF( py_list );
+
+   if ( status != 0 )
+   {
+      PyErr_Print();
+      YT_ABORT( "Setting libyt.field_list ... failed!\n" );
+   }
+
+   KeyStale = false;
+
+   log_debug( "Exporting %d declared field(s) to libyt.field_list ... done\n", NKey );
+
+   return YT_SUCCESS;
+
+} // FUNCTION : export_field_list
+
+
+
+//-------------------------------------------------------------------------------------------------------
+// Function    :  field_key
+// Description :  Return the interned Python key of a field of a grid
+//
+// Note        :  1. Called by get_grid_data() to avoid creating and hashing a new key for each grid
+//
+// Parameter   :  grid : Target grid
+//                v    : Index of the target field in the grid
+//
+// Return      :  Borrowed reference, or NULL if the grid does not use the declared labels
+//-------------------------------------------------------------------------------------------------------
+PyObject *field_key( const yt_grid *grid, const int v )
+{
+
+   if ( KeyStale  ||  grid->field_labels == NULL  ||  grid->field_labels != field_registry_labels() )   return NULL;
+
+   return Field_Keys[v];
+
+} // FUNCTION : field_key
@@ -0,0 +1,76 @@
+#include "yt_combo.h"
+
+
+
+
+//-------------------------------------------------------------------------------------------------------
+// Function    :  init_gc_policy
+// Description :  Set up the garbage collection policy "g_param_libyt.gc_policy"
+//
+// Note        :  1. Called by yt_init() after importing the analysis script
+//                2. YT_GC_FREEZE moves all objects allocated so far (e.g., yt and its dependencies) to a
+//                   permanent generation ignored by all future collections
+//                   ==> Requires gc.freeze() (Python >= 3.7). Fall back to YT_GC_GENERATIONAL otherwise.
+//
+// Parameter   :  None
+//
+// Return      :  YT_SUCCESS or YT_FAIL
+//-------------------------------------------------------------------------------------------------------
+int init_gc_policy()
+{
+
+   switch ( g_param_libyt.gc_policy )
+   {
+      case YT_GC_FULL:
+      case YT_GC_GENERATIONAL:
+      case YT_GC_NONE:
+         break;
+
+      case YT_GC_FREEZE:
+         if ( PyRun_SimpleString( "gc.collect()\n"
+                                  "if not hasattr( gc, 'freeze' ):   raise AttributeError( 'gc.freeze' )\n"
+                                  "gc.freeze()\n" ) == 0 )
+            log_debug( "Freezing the Python heap ... done\n" );
+         else
+         {
+            log_warning( "gc.freeze() is not supported by this Python ==> use YT_GC_GENERATIONAL instead\n" );
+            g_param_libyt.gc_policy = YT_GC_GENERATIONAL;
+         }
+         break;
+
+      default:
+         YT_ABORT( "Unknown \"%s\" == %d!\n", "gc_policy", g_param_libyt.gc_policy );
+   }
+
+   return YT_SUCCESS;
+
+} // FUNCTION : init_gc_policy
+
+
+
+//-------------------------------------------------------------------------------------------------------
+// Function    :  collect_garbage
+// Description :  Collect garbage at the end of yt_inline() according to "g_param_libyt.gc_policy"
+//
+// Note        :  1. Must be called with the GIL held
+//
+// Parameter   :  None
+//
+// Return      :  None
+//-------------------------------------------------------------------------------------------------------
+void collect_garbage()
+{
+
+   const double start = get_wall_time();
+
+   switch ( g_param_libyt.gc_policy )
+   {
+      case YT_GC_FULL:
+      case YT_GC_FREEZE:         PyRun_SimpleString( "gc.collect()"  );   break;
+      case YT_GC_GENERATIONAL:   PyRun_SimpleString( "gc.collect(0)" );   break;
+      case YT_GC_NONE:                                                    break;
+   }
+
+   log_debug( "Collecting garbage with policy %d ... done (%.3f s)\n", g_param_libyt.gc_policy, get_wall_time() - start );
+
+} // FUNCTION : collect_garbage
@@ -0,0 +1,87 @@
+#include "yt_combo.h"
+
+
+
+
+//-------------------------------------------------------------------------------------------------------
+// Function    :  get_clumps
+// Description :  Method "libyt.find_clumps( field, threshold, min_cells=1 )" finding connected regions of
+//                leaf cells with field values above a threshold
+//
+// Note        :  1. See find_clumps() for details
+//                2. Release the GIL when finding clumps
+//
+// Parameter   :  self : Not used
+//                args : Field name, threshold, and the minimum number of cells of each clump
+//
+// Return      :  Dictionary with the keys "cell_count" [N], "mass" [N], "left_edge" [N][3], and
+//                "right_edge" [N][3], or NULL on error
+//-------------------------------------------------------------------------------------------------------
+PyObject *get_clumps( PyObject *self, PyObject *args )
+{
+
+   const char *field;
+   double      threshold;
+   long        min_cells = 1;
+
+   if ( !PyArg_ParseTuple( args, "sd|l", &field, &threshold, &min_cells ) )   return NULL;
+
+   if ( !g_param_libyt.grids_committed )
+   {
+      PyErr_SetString( PyExc_RuntimeError, "find_clumps() can only be called during yt_inline()" );
+      return NULL;
+   }
+
+
+// find clumps
+   long    num_clumps;
+   long   *cell_count;
+   double *mass, *left_edge, *right_edge;
+   int     status;
+
+   {
+      yt_nogil_guard nogil;
+      status = find_clumps( field, threshold, min_cells, &num_clumps, &cell_count, &mass, &left_edge, &right_edge );
+   }
+
+   if ( status != YT_SUCCESS )
+   {
+      PyErr_Format( PyExc_KeyError, "finding clumps of field \"%s\" failed", field );
+      return NULL;
+   }
+
+
+// copy results to NumPy arrays
+   npy_intp  dim1[1] = { num_clumps };
+   npy_intp  dim2[2] = { num_clumps, 3 };
+   PyObject *py_cell_count = PyArray_SimpleNew( 1, dim1, NPY_LONG   );
+   PyObject *py_mass       = PyArray_SimpleNew( 1, dim1, NPY_DOUBLE );
+   PyObject *py_left_edge  = PyArray_SimpleNew( 2, dim2, NPY_DOUBLE );
+   PyObject *py_right_edge = PyArray_SimpleNew( 2, dim2, NPY_DOUBLE );
+
+   memcpy( PyArray_DATA( (PyArrayObject*)py_cell_count ), cell_count, num_clumps*sizeof(long)     );
+   memcpy( PyArray_DATA( (PyArrayObject*)py_mass       ), mass,       num_clumps*sizeof(double)   );
+   memcpy( PyArray_DATA( (PyArrayObject*)py_left_edge  ), left_edge,  num_clumps*sizeof(double)*3 );
+   memcpy( PyArray_DATA( (PyArrayObject*)py_right_edge ), right_edge, num_clumps*sizeof(double)*3 );
+
+   delete [] cell_count;
+   delete [] mass;
+   delete [] left_edge;
+   delete [] right_edge;
+
+   PyObject *py_clumps = PyDict_New();
+
+   PyDict_SetItemString( py_clumps, "cell_count", py_cell_count );
+   PyDict_SetItemString( py_clumps, "mass",       py_mass       );
+   PyDict_SetItemString( py_clumps, "left_edge",  py_left_edge  );
+   PyDict_SetItemString( py_clumps, "right_edge", py_right_edge );
+
+// call decref since PyDict_SetItemString() does not steal the references
+   Py_DECREF( py_cell_count );
+   Py_DECREF( py_mass       );
+   Py_DECREF( py_left_edge  );
+   Py_DECREF( py_right_edge );
+
+   return py_clumps;
+
+} // FUNCTION : get_clumps
@@ -0,0 +1,199 @@
+#include "yt_combo.h"
+#include <string.h>
+
+
+
+
+static PyObject *check_output( PyObject *py_out, const int dims[3] );
+
+
+
+
+//-------------------------------------------------------------------------------------------------------
+// Function    :  get_covering_grid
+// Description :  Method "libyt.covering_grid( level, left, dims, fields, out=None, interp='constant' )"
+//                resampling fields onto a uniform grid
+//
+// Note        :  1. See covering_grid() for details
+//                2. "fields" can be a single field name or a sequence of field names
+//                   ==> Return a single NumPy array or a list of NumPy arrays accordingly
+//                3. "out" must have the same structure as the return value. Each array must be C-contiguous,
+//                   writeable, with shape "dims" and dtype float32 or float64.
+//                   ==> Data are written into "out" directly so that the caller can reuse the buffers
+//                   ==> New float64 arrays are allocated if "out" is None
+//                4. "interp" is either "constant" or "linear"
+//                5. Release the GIL when resampling
+//
+// Parameter   :  self   : Not used
+//                args   : See above
+//                kwargs : See above
+//
+// Return      :  NumPy array(s) of the resampled fields or NULL on error
+//-------------------------------------------------------------------------------------------------------
+PyObject *get_covering_grid( PyObject *self, PyObject *args, PyObject *kwargs )
+{
+
+   static const char *kwlist[] = { "level", "left", "dims", "fields", "out", "interp", NULL };
+
+   int         level, dims[3];
+   double      left[3];
+   PyObject   *py_fields, *py_out = Py_None;
+   const char *interp = "constant";
+
+   if ( !PyArg_ParseTupleAndKeywords( args, kwargs, "i(ddd)(iii)O|Os", (char**)kwlist, &level, &left[0], &left[1],
+                                      &left[2], &dims[0], &dims[1], &dims[2], &py_fields, &py_out, &interp ) )
+      return NULL;
+
+   if ( !g_param_libyt.grids_committed )
+   {
+      PyErr_SetString( PyExc_RuntimeError, "covering_grid() can only be called during yt_inline()" );
+      return NULL;
+   }
+
+   if ( level < 0  ||  dims[0] <= 0  ||  dims[1] <= 0  ||  dims[2] <= 0 )
+   {
+      PyErr_SetString( PyExc_ValueError, "level must be >= 0 and dims must be > 0" );
+      return NULL;
+   }
+
+   if ( strcmp( interp, "constant" ) != 0  &&  strcmp( interp, "linear" ) != 0 )
+   {
+      PyErr_Format( PyExc_ValueError, "unknown interp \"%s\" (must be \"constant\" or \"linear\")", interp );
+      return NULL;
+   }
+
+
+// normalize "fields" and "out" to lists
+   const bool single = PyString_Check( py_fields );
+   PyObject  *py_field_list, *py_out_list;
+
+   if ( single )   py_field_list = Py_BuildValue( "[O]", py_fields );
+   else            py_field_list = PySequence_List( py_fields );
+
+   if ( py_field_list == NULL )   return NULL;
+
+   const Py_ssize_t num_fields = PyList_GET_SIZE( py_field_list );
+
+   if      ( py_out == Py_None )   py_out_list = PyList_New( 0 );
+   else if ( single )              py_out_list = Py_BuildValue( "[O]", py_out );
+   else                            py_out_list = PySequence_List( py_out );
+
+   if ( py_out_list == NULL )
+   {
+      Py_DECREF( py_field_list );
+      return NULL;
+   }
+
+   if ( py_out != Py_None  &&  PyList_GET_SIZE( py_out_list ) != num_fields )
+   {
+      Py_DECREF( py_field_list );
+      Py_DECREF( py_out_list );
+      PyErr_SetString( PyExc_ValueError, "out must have one array per field" );
+      return NULL;
+   }
+
+
+// resample each field
+   npy_intp np_dims[3] = { dims[0], dims[1], dims[2] };
+
+   for (Py_ssize_t v=0; v<num_fields; v++)
+   {
+      const char *field = PyString_AsString( PyList_GET_ITEM( py_field_list, v ) );
+      PyObject   *py_array;
+
+      if ( field == NULL )   py_array = NULL;
+      else if ( py_out == Py_None )
+      {
+         py_array = PyArray_SimpleNew( 3, np_dims, NPY_DOUBLE );
+         PyList_Append( py_out_list, py_array );
+         Py_DECREF( py_array );
+      }
+      else
+         py_array = check_output( PyList_GET_ITEM( py_out_list, v ), dims );
+
+      if ( py_array == NULL )
+      {
+         Py_DECREF( py_field_list );
+         Py_DECREF( py_out_list );
+         return NULL;
+      }
+
+      const yt_ftype out_ftype = ( PyArray_TYPE( (PyArrayObject*)py_array ) == NPY_FLOAT ) ? YT_FLOAT : YT_DOUBLE;
+      void          *out       = PyArray_DATA( (PyArrayObject*)py_array );
+      const bool     linear    = ( strcmp( interp, "linear" ) == 0 );
+      int            status;
+
+      {
+         yt_nogil_guard nogil;
+         status = covering_grid( level, left, dims, field, linear, out_ftype, out );
+      }
+
+      if ( status != YT_SUCCESS )
+      {
+         Py_DECREF( py_field_list );
+         Py_DECREF( py_out_list );
+         PyErr_Format( PyExc_KeyError, "resampling field \"%s\" failed", field );
+         return NULL;
+      }
+   }
+
+   Py_DECREF( py_field_list );
+
+
+// return a single array or a list of arrays
+   if ( single )
+   {
+      PyObject *py_array = PyList_GET_ITEM( py_out_list, 0 );
+      Py_INCREF( py_array );
+      Py_DECREF( py_out_list );
+      return py_array;
+   }
+
+   return py_out_list;
+
+} // FUNCTION : get_covering_grid
+
+
+
+//-------------------------------------------------------------------------------------------------------
+// Function    :  check_output
+// Description :  Check whether a caller-provided output array can be written by covering_grid()
+//
+// Parameter   :  py_out : Output array
+//                dims   : Expected shape
+//
+// Return      :  py_out (borrowed reference) or NULL with an exception set
+//-------------------------------------------------------------------------------------------------------
+static PyObject *check_output( PyObject *py_out, const int dims[3] )
+{
+
+   if ( !PyArray_Check( py_out ) )
+   {
+      PyErr_SetString( PyExc_TypeError, "out must be a NumPy array" );
+      return NULL;
+   }
+
+   PyArrayObject *array = (PyArrayObject*)py_out;
+
+   if ( PyArray_NDIM( array ) != 3  ||  PyArray_DIM( array, 0 ) != dims[0]  ||
+        PyArray_DIM( array, 1 ) != dims[1]  ||  PyArray_DIM( array, 2 ) != dims[2] )
+   {
+      PyErr_SetString( PyExc_ValueError, "out must have the shape of dims" );
+      return NULL;
+   }
+
+   if ( PyArray_TYPE( array ) != NPY_FLOAT  &&  PyArray_TYPE( array ) != NPY_DOUBLE )
+   {
+      PyErr_SetString( PyExc_TypeError, "out must be float32 or float64" );
+      return NULL;
+   }
+
+   if ( !PyArray_IS_C_CONTIGUOUS( array )  ||  !PyArray_ISWRITEABLE( array ) )
+   {
+      PyErr_SetString( PyExc_ValueError, "out must be C-contiguous and writeable" );
+      return NULL;
+   }
+
+   return py_out;
+
+} // FUNCTION : check_output
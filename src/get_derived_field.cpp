@@ -0,0 +1,96 @@
+#include "yt_combo.h"
+
+
+
+
+//-------------------------------------------------------------------------------------------------------
+// Function    :  get_derived_field
+// Description :  Method "libyt.derived_field( grid_id, name )" returning a derived field of a single grid
+//
+// Note        :  1. Compute the derived field by the native kernel registered by yt_add_derived_field()
+//                2. Results are cached in "g_py_derived_cache" until the end of yt_inline()
+//                3. Release the GIL when evaluating the kernel
+//
+// Parameter   :  self : Not used
+//                args : Grid ID and name of the derived field
+//
+// Return      :  NumPy array of the derived field or NULL on error
+//-------------------------------------------------------------------------------------------------------
+PyObject *get_derived_field( PyObject *self, PyObject *args )
+{
+
+   long        grid_id;
+   const char *name;
+
+   if ( !PyArg_ParseTuple( args, "ls", &grid_id, &name ) )   return NULL;
+
+
+// return the cached result if any
+// ==> PyDict_GetItem() returns a borrowed reference
+   PyObject *py_key    = Py_BuildValue( "(ls)", grid_id, name );
+   PyObject *py_output = PyDict_GetItem( g_py_derived_cache, py_key );
+
+   if ( py_output != NULL )
+   {
+      Py_DECREF( py_key );
+      Py_INCREF( py_output );
+      return py_output;
+   }
+
+
+// check inputs
+   const yt_derived_field *field = find_derived_field( name );
+
+   if ( field == NULL )
+   {
+      Py_DECREF( py_key );
+      PyErr_Format( PyExc_KeyError, "derived field \"%s\" has not been registered", name );
+      return NULL;
+   }
+
+   if ( !g_param_libyt.grids_committed  ||  grid_id < 0  ||  grid_id >= g_param_yt.num_grids )
+   {
+      Py_DECREF( py_key );
+      PyErr_Format( PyExc_IndexError, "grid [%ld] is not available", grid_id );
+      return NULL;
+   }
+
+   const yt_grid *grid = g_grids + grid_id;
+
+
+// collect input fields
+   const void **inputs = new const void* [ field->num_inputs ];
+
+   for (int v=0; v<field->num_inputs; v++)
+   {
+      if (  ( inputs[v] = find_field_data( grid, field->input_labels[v] ) ) == NULL  )
+      {
+         Py_DECREF( py_key );
+         delete [] inputs;
+         PyErr_Format( PyExc_KeyError, "input field \"%s\" of derived field \"%s\" is not found in grid [%ld]",
+                       field->input_labels[v], name, grid_id );
+         return NULL;
+      }
+   }
+
+
+// compute the derived field
+   npy_intp grid_dims[3] = { grid->dimensions[0], grid->dimensions[1], grid->dimensions[2] };
+   py_output = PyArray_SimpleNew( 3, grid_dims, ( field->output_ftype == YT_FLOAT ) ? NPY_FLOAT : NPY_DOUBLE );
+   void *output = PyArray_DATA( (PyArrayObject*)py_output );
+
+   {
+      yt_nogil_guard nogil;
+      evaluate_derived_field( field, grid, inputs, output );
+   }
+
+   delete [] inputs;
+
+
+// cache the result
+   PyDict_SetItem( g_py_derived_cache, py_key, py_output );
+   Py_DECREF( py_key );
+
+   return py_output;
+
+} // FUNCTION : get_derived_field
@@ -0,0 +1,139 @@
+#include "yt_combo.h"
+#include <math.h>
+
+
+
+
+//-------------------------------------------------------------------------------------------------------
+// Function    :  get_render
+// Description :  Method "libyt.render( field, center, normal, width, resolution, north=None, weight=None,
+//                transfer_function=None, log=False )" rendering an off-axis image
+//
+// Note        :  1. See ray_cast() for details
+//                2. "width" is a scalar or (width_east, width_north, depth), and "resolution" is an integer
+//                   or (nx, ny)
+//                3. "north" defaults to the coordinate axis least aligned with "normal"
+//                4. Line integral of "field" (weighted by "weight" if set) if "transfer_function" is None
+//                   ==> Return a float64 array of shape (ny, nx)
+//                5. Otherwise "transfer_function" = (min, max, rgba), where rgba is an array of shape (n, 4)
+//                   storing the emission (r,g,b) and absorption (a) per unit length of n bins between
+//                   min and max (of log10 of the field if "log" is true)
+//                   ==> Return a float64 array of shape (ny, nx, 4) storing (r,g,b,alpha)
+//                6. Release the GIL when rendering
+//
+// Parameter   :  self   : Not used
+//                args   : See above
+//                kwargs : See above
+//
+// Return      :  NumPy array of the image or NULL on error
+//-------------------------------------------------------------------------------------------------------
+PyObject *get_render( PyObject *self, PyObject *args, PyObject *kwargs )
+{
+
+   static const char *kwlist[] = { "field", "center", "normal", "width", "resolution", "north", "weight",
+                                   "transfer_function", "log", NULL };
+
+   yt_render   render;
+   PyObject   *py_width, *py_resolution, *py_north = Py_None, *py_tf = Py_None;
+   const char *field, *weight = NULL;
+   int         tf_log = 0;
+
+   if ( !PyArg_ParseTupleAndKeywords( args, kwargs, "s(ddd)(ddd)OO|OzOi", (char**)kwlist, &field,
+                                      &render.center[0], &render.center[1], &render.center[2],
+                                      &render.normal[0], &render.normal[1], &render.normal[2],
+                                      &py_width, &py_resolution, &py_north, &weight, &py_tf, &tf_log ) )
+      return NULL;
+
+   if ( !g_param_libyt.grids_committed )
+   {
+      PyErr_SetString( PyExc_RuntimeError, "render() can only be called during yt_inline()" );
+      return NULL;
+   }
+
+   render.field  = field;
+   render.weight = weight;
+   render.tf_log = tf_log;
+
+
+// width, resolution, and north
+   if ( PyNumber_Check( py_width ) )
+   {
+      const double width = PyFloat_AsDouble( py_width );
+      for (int d=0; d<3; d++)   render.width[d] = width;
+   }
+   else if ( !PyArg_ParseTuple( py_width, "ddd", &render.width[0], &render.width[1], &render.width[2] ) )
+      return NULL;
+
+   if ( PyInt_Check( py_resolution )  ||  PyLong_Check( py_resolution ) )
+      render.resolution[0] = render.resolution[1] = (int)PyInt_AsLong( py_resolution );
+   else if ( !PyArg_ParseTuple( py_resolution, "ii", &render.resolution[0], &render.resolution[1] ) )
+      return NULL;
+
+   if ( PyErr_Occurred() )   return NULL;
+
+   if ( py_north == Py_None )
+   {
+      int axis = 0;
+      for (int d=1; d<3; d++)   if ( fabs( render.normal[d] ) < fabs( render.normal[axis] ) )   axis = d;
+      for (int d=0; d<3; d++)   render.north[d] = ( d == axis ) ? 1.0 : 0.0;
+   }
+   else if ( !PyArg_ParseTuple( py_north, "ddd", &render.north[0], &render.north[1], &render.north[2] ) )
+      return NULL;
+
+
+// transfer function
+   PyObject *py_rgba = NULL;
+
+   if ( py_tf != Py_None )
+   {
+      PyObject *py_table;
+
+      if ( !PyArg_ParseTuple( py_tf, "ddO", &render.tf_bounds[0], &render.tf_bounds[1], &py_table ) )
+         return NULL;
+
+      py_rgba = PyArray_FROMANY( py_table, NPY_DOUBLE, 2, 2, NPY_ARRAY_IN_ARRAY );
+
+      if ( py_rgba == NULL )   return NULL;
+
+      if ( PyArray_DIM( (PyArrayObject*)py_rgba, 1 ) != 4  ||  PyArray_DIM( (PyArrayObject*)py_rgba, 0 ) == 0 )
+      {
+         Py_DECREF( py_rgba );
+         PyErr_SetString( PyExc_ValueError, "the rgba table of transfer_function must have shape (n, 4)" );
+         return NULL;
+      }
+
+      render.num_tf  = (int)PyArray_DIM( (PyArrayObject*)py_rgba, 0 );
+      render.tf_rgba = (const double*)PyArray_DATA( (PyArrayObject*)py_rgba );
+   }
+
+   if ( !render.validate() )
+   {
+      Py_XDECREF( py_rgba );
+      PyErr_SetString( PyExc_ValueError, "invalid rendering parameters (see the libyt log)" );
+      return NULL;
+   }
+
+
+// render
+   npy_intp  np_dims[3] = { render.resolution[1], render.resolution[0], 4 };
+   PyObject *py_image   = PyArray_SimpleNew( ( render.num_tf > 0 ) ? 3 : 2, np_dims, NPY_DOUBLE );
+   double   *image      = (double*)PyArray_DATA( (PyArrayObject*)py_image );
+   int       status;
+
+   {
+      yt_nogil_guard nogil;
+      status = ray_cast( &render, image );
+   }
+
+   Py_XDECREF( py_rgba );
+
+   if ( status != YT_SUCCESS )
+   {
+      Py_DECREF( py_image );
+      PyErr_Format( PyExc_KeyError, "rendering field \"%s\" failed", field );
+      return NULL;
+   }
+
+   return py_image;
+
+} // FUNCTION : get_render
@@ -0,0 +1,135 @@
+#include "yt_combo.h"
+#include <string.h>
+
+
+
+
+//-------------------------------------------------------------------------------------------------------
+// Function    :  get_sample
+// Description :  Method "libyt.sample( positions, fields, method='nearest' )" interpolating fields at
+//                arbitrary positions
+//
+// Note        :  1. See sample_points() for details
+//                2. "positions" is an array-like of shape (N, 3), converted to a C-contiguous float64 array
+//                   only if necessary
+//                3. "fields" can be a single field name or a sequence of field names
+//                   ==> Return a single float64 array of shape (N,) or a list of them accordingly
+//                4. "method" is either "nearest" or "linear"
+//                5. Release the GIL when sampling
+//
+// Parameter   :  self   : Not used
+//                args   : See above
+//                kwargs : See above
+//
+// Return      :  NumPy array(s) of the sampled fields or NULL on error
+//-------------------------------------------------------------------------------------------------------
+PyObject *get_sample( PyObject *self, PyObject *args, PyObject *kwargs )
+{
+
+   static const char *kwlist[] = { "positions", "fields", "method", NULL };
+
+   PyObject   *py_positions, *py_fields;
+   const char *method = "nearest";
+
+   if ( !PyArg_ParseTupleAndKeywords( args, kwargs, "OO|s", (char**)kwlist, &py_positions, &py_fields, &method ) )
+      return NULL;
+
+   if ( !g_param_libyt.grids_committed )
+   {
+      PyErr_SetString( PyExc_RuntimeError, "sample() can only be called during yt_inline()" );
+      return NULL;
+   }
+
+   if ( strcmp( method, "nearest" ) != 0  &&  strcmp( method, "linear" ) != 0 )
+   {
+      PyErr_Format( PyExc_ValueError, "unknown method \"%s\" (must be \"nearest\" or \"linear\")", method );
+      return NULL;
+   }
+
+
+// positions
+   PyObject *py_pos = PyArray_FROMANY( py_positions, NPY_DOUBLE, 2, 2, NPY_ARRAY_IN_ARRAY );
+
+   if ( py_pos == NULL )   return NULL;
+
+   if ( PyArray_DIM( (PyArrayObject*)py_pos, 1 ) != 3 )
+   {
+      Py_DECREF( py_pos );
+      PyErr_SetString( PyExc_ValueError, "positions must have shape (N, 3)" );
+      return NULL;
+   }
+
+   const long    num_points = PyArray_DIM( (PyArrayObject*)py_pos, 0 );
+   const double *pos        = (const double*)PyArray_DATA( (PyArrayObject*)py_pos );
+
+
+// fields
+   const bool single = PyString_Check( py_fields );
+   PyObject  *py_field_list;
+
+   if ( single )   py_field_list = Py_BuildValue( "[O]", py_fields );
+   else            py_field_list = PySequence_List( py_fields );
+
+   if ( py_field_list == NULL )
+   {
+      Py_DECREF( py_pos );
+      return NULL;
+   }
+
+   const int    num_fields  = (int)PyList_GET_SIZE( py_field_list );
+   const char **fields      = new const char* [num_fields];
+   double     **out         = new double*     [num_fields];
+   PyObject    *py_out_list = PyList_New( num_fields );
+   npy_intp     np_dim[1]   = { num_points };
+   bool         valid       = true;
+
+   for (int v=0; v<num_fields; v++)
+   {
+      PyObject *py_array = PyArray_SimpleNew( 1, np_dim, NPY_DOUBLE );
+
+      PyList_SET_ITEM( py_out_list, v, py_array );
+      out   [v] = (double*)PyArray_DATA( (PyArrayObject*)py_array );
+      fields[v] = PyString_AsString( PyList_GET_ITEM( py_field_list, v ) );
+
+      if ( fields[v] == NULL )   valid = false;
+   }
+
+
+// sample all fields
+   int status = YT_FAIL;
+
+   if ( valid )
+   {
+      const bool linear = ( strcmp( method, "linear" ) == 0 );
+
+      {
+         yt_nogil_guard nogil;
+         status = sample_points( num_points, pos, num_fields, fields, linear, out );
+      }
+   }
+
+   delete [] fields;
+   delete [] out;
+   Py_DECREF( py_field_list );
+   Py_DECREF( py_pos );
+
+   if ( status != YT_SUCCESS )
+   {
+      Py_DECREF( py_out_list );
+      if ( valid )   PyErr_SetString( PyExc_KeyError, "sampling fields failed" );
+      return NULL;
+   }
+
+
+// return a single array or a list of arrays
+   if ( single )
+   {
+      PyObject *py_array = PyList_GET_ITEM( py_out_list, 0 );
+      Py_INCREF( py_array );
+      Py_DECREF( py_out_list );
+      return py_array;
+   }
+
+   return py_out_list;
+
+} // FUNCTION : get_sample
@@ -0,0 +1,27 @@
+#define NO_PYTHON
+#include "yt_combo.h"
+#undef NO_PYTHON
+#include <sys/time.h>
+
+
+
+
+//-------------------------------------------------------------------------------------------------------
+// Function    :  get_wall_time
+// Description :  Return the current wall-clock time in seconds
+//
+// Note        :  1. Only the difference between two calls is meaningful
+//
+// Parameter   :  None
+//
+// Return      :  Wall-clock time in seconds
+//-------------------------------------------------------------------------------------------------------
+double get_wall_time()
+{
+
+   timeval tv;
+   gettimeofday( &tv, NULL );
+
+   return tv.tv_sec + 1.0e-6*tv.tv_usec;
+
+} // FUNCTION : get_wall_time
@@ -0,0 +1,159 @@
+#define NO_PYTHON
+#include "yt_combo.h"
+#undef NO_PYTHON
+#include <string.h>
+
+
+// copy of the field labels of "g_grid_filter"
+static char **Field_Labels = NULL;
+static int    NField       = 0;
+
+
+
+
+//-------------------------------------------------------------------------------------------------------
+// Function    :  grid_filter_init / grid_filter_free
+// Description :  Store the grid filter to "g_grid_filter" / release the copied field labels
+//
+// Note        :  1. Called by yt_set_grid_filter()
+//                2. Field labels are copied since the input pointer array may be free'd after
+//                   yt_set_grid_filter() returns
+//
+// Parameter   :  filter : Structure selecting the grids and fields
+//
+// Return      :  YT_SUCCESS or YT_FAIL
+//-------------------------------------------------------------------------------------------------------
+int grid_filter_init( const yt_grid_filter *filter )
+{
+
+   grid_filter_free();
+
+   g_grid_filter = *filter;
+
+   if ( g_grid_filter.num_fields > 0 )
+   {
+      NField       = g_grid_filter.num_fields;
+      Field_Labels = new char* [NField];
+
+      for (int v=0; v<NField; v++)
+      {
+         Field_Labels[v] = new char [ strlen( filter->field_labels[v] ) + 1 ];
+         strcpy( Field_Labels[v], filter->field_labels[v] );
+      }
+
+      g_grid_filter.field_labels = (const char**)Field_Labels;
+   }
+
+   return YT_SUCCESS;
+
+} // FUNCTION : grid_filter_init
+
+
+void grid_filter_free()
+{
+
+   for (int v=0; v<NField; v++)   delete [] Field_Labels[v];
+   delete [] Field_Labels;
+
+   Field_Labels = NULL;
+   NField       = 0;
+
+   g_grid_filter = yt_grid_filter();
+
+} // FUNCTION : grid_filter_free
+
+
+
+//-------------------------------------------------------------------------------------------------------
+// Function    :  grid_filter_accept
+// Description :  Check whether a grid is selected by the grid filter
+//
+// Note        :  1. Called by yt_add_grid() ==> thread-safe and O(1)
+//                2. Always true if no filter is set
+//
+// Parameter   :  grid : Target grid
+//
+// Return      :  true/false
+//-------------------------------------------------------------------------------------------------------
+bool grid_filter_accept( const yt_grid *grid )
+{
+
+   if ( !g_param_libyt.grid_filter_set )   return true;
+
+   if ( grid->level < g_grid_filter.min_level )   return false;
+   if ( g_grid_filter.max_level >= 0  &&  grid->level > g_grid_filter.max_level )   return false;
+
+   for (int d=0; d<3; d++)
+   {
+      if ( g_grid_filter.region_left_edge[d] == FLT_UNDEFINED )   continue;
+
+      if ( grid->right_edge[d] <= g_grid_filter.region_left_edge [d]  ||
+           grid->left_edge [d] >= g_grid_filter.region_right_edge[d]    )   return false;
+   }
+
+   return true;
+
+} // FUNCTION : grid_filter_accept
+
+
+
+//-------------------------------------------------------------------------------------------------------
+// Function    :  grid_filter_field
+// Description :  Check whether a field is selected by the grid filter
+//
+// Note        :  1. Called by commit_grids()
+//                2. Always true if no filter is set or the filter does not select fields
+//
+// Parameter   :  label : Name of the target field
+//
+// Return      :  true/false
+//-------------------------------------------------------------------------------------------------------
+bool grid_filter_field( const char *label )
+{
+
+   if ( !g_param_libyt.grid_filter_set  ||  g_grid_filter.num_fields == 0 )   return true;
+
+   for (int v=0; v<g_grid_filter.num_fields; v++)
+      if ( strcmp( g_grid_filter.field_labels[v], label ) == 0 )   return true;
+
+   return false;
+
+} // FUNCTION : grid_filter_field
+
+
+
+//-------------------------------------------------------------------------------------------------------
+// Function    :  compact_grids
+// Description :  Renumber the grids selected by the grid filter consecutively
+//
+// Note        :  1. Called by yt_inline() before order_grids() and commit_grids()
+//                2. Grids rejected by yt_add_grid() are left unset in "g_grids" (i.e., id != slot index)
+//                3. See renumber_grids() for details
+//                   ==> libyt.hierarchy is shrunk accordingly by commit_grids()
+//
+// Parameter   :  None
+//
+// Return      :  YT_SUCCESS or YT_FAIL
+//-------------------------------------------------------------------------------------------------------
+int compact_grids()
+{
+
+   const long num_grids = g_param_yt.num_grids;
+
+   if ( !g_param_libyt.grid_filter_set )   return YT_SUCCESS;
+
+   long *new_id = new long [num_grids];
+   long  count  = 0;
+
+   for (long g=0; g<num_grids; g++)
+      new_id[g] = ( g_grids[g].id == g ) ? count++ : -1;
+
+   const int status = renumber_grids( new_id, count );
+
+   delete [] new_id;
+
+   log_debug( "Selecting %ld of %ld grids by the grid filter ... done\n", count, num_grids );
+
+   return status;
+
+} // FUNCTION : compact_grids
@@ -0,0 +1,376 @@
+#define NO_PYTHON
+#include "yt_combo.h"
+#undef NO_PYTHON
+#include <math.h>
+#include <pthread.h>
+
+
+
+
+// internal states of the spatial index
+// ==> the simulation domain is divided into uniform buckets, each of which stores the IDs of all grids
+//     overlapping with it (compressed-row storage)
+// ==> grids in each bucket are sorted by level in descending order so that the first grid containing
+//     a point is the finest one
+static bool    Index_Built   = false;
+static pthread_mutex_t Index_Mutex = PTHREAD_MUTEX_INITIALIZER;   // serializes grid_index_build()
+static int     NBucket[3];
+static double  Bucket_Size[3];
+static long   *Bucket_Start  = NULL;   // [ NBucket[0]*NBucket[1]*NBucket[2] + 1 ]
+static long   *Bucket_Grids  = NULL;
+static long   *Child_Start   = NULL;   // [ num_grids + 1 ]
+static long   *Child_List    = NULL;   // children of each grid found through "parent_id"
+
+static void bucket_range( const yt_grid *grid, int lo[3], int hi[3] );
+
+
+
+
+//-------------------------------------------------------------------------------------------------------
+// Function    :  grid_index_build
+// Description :  Build the spatial index of all grids staged by yt_add_grid()
+//
+// Note        :  1. Used by native analysis routines to find the finest grid containing a given point
+//                2. Do nothing if the index has been built at this step
+//                   ==> It is freed by grid_index_free() in yt_inline()
+//                3. The number of buckets is roughly the number of grids so that each bucket stores
+//                   only a few grids per level
+//                4. Also list the children of each grid for grid_index_mark_covered()
+//                5. Thread-safe: called without the GIL by native routines that may run concurrently in the
+//                   script and the output workers, so only the first caller builds the index while the others
+//                   wait for it
+//
+// Parameter   :  None
+//
+// Return      :  YT_SUCCESS or YT_FAIL
+//-------------------------------------------------------------------------------------------------------
+int grid_index_build()
+{
+
+   pthread_mutex_lock( &Index_Mutex );
+
+   if ( Index_Built )
+   {
+      pthread_mutex_unlock( &Index_Mutex );
+      return YT_SUCCESS;
+   }
+
+   if ( g_grids == NULL )
+   {
+      pthread_mutex_unlock( &Index_Mutex );
+      YT_ABORT( "No grid has been staged!\n" );
+   }
+
+
+// set the number of buckets along each direction
+   const double num_root_cells = (double)g_param_yt.domain_dimensions[0]*g_param_yt.domain_dimensions[1]*
+                                         g_param_yt.domain_dimensions[2];
+   const double bucket_per_cell = cbrt( g_param_yt.num_grids / num_root_cells );
+
+   long num_buckets = 1;
+   for (int d=0; d<3; d++)
+   {
+      NBucket[d]     = MAX( 1, MIN( g_param_yt.domain_dimensions[d], (int)ceil( g_param_yt.domain_dimensions[d]*bucket_per_cell ) ) );
+      Bucket_Size[d] = ( g_param_yt.domain_right_edge[d] - g_param_yt.domain_left_edge[d] ) / NBucket[d];
+      num_buckets   *= NBucket[d];
+   }
+
+
+// count the number of grids overlapping with each bucket
+   Bucket_Start = new long [ num_buckets + 1 ];
+   for (long b=0; b<=num_buckets; b++)   Bucket_Start[b] = 0;
+
+   int max_level = 0;
+   for (long g=0; g<g_param_yt.num_grids; g++)
+   {
+      int lo[3], hi[3];
+      bucket_range( g_grids + g, lo, hi );
+
+      for (int i=lo[0]; i<=hi[0]; i++)
+      for (int j=lo[1]; j<=hi[1]; j++)
+      for (int k=lo[2]; k<=hi[2]; k++)
+         Bucket_Start[ ( (long)i*NBucket[1] + j )*NBucket[2] + k + 1 ] ++;
+
+      max_level = MAX( max_level, g_grids[g].level );
+   }
+
+   for (long b=0; b<num_buckets; b++)   Bucket_Start[b+1] += Bucket_Start[b];
+
+
+// fill buckets from the finest level to the root level
+   long *fill = new long [ num_buckets ];
+   for (long b=0; b<num_buckets; b++)   fill[b] = Bucket_Start[b];
+
+   Bucket_Grids = new long [ Bucket_Start[num_buckets] ];
+
+   for (int lv=max_level; lv>=0; lv--)
+   for (long g=0; g<g_param_yt.num_grids; g++)
+   {
+      if ( g_grids[g].level != lv )   continue;
+
+      int lo[3], hi[3];
+      bucket_range( g_grids + g, lo, hi );
+
+      for (int i=lo[0]; i<=hi[0]; i++)
+      for (int j=lo[1]; j<=hi[1]; j++)
+      for (int k=lo[2]; k<=hi[2]; k++)
+         Bucket_Grids[ fill[ ( (long)i*NBucket[1] + j )*NBucket[2] + k ] ++ ] = g;
+   }
+
+   delete [] fill;
+
+
+// list the children of each grid (compressed-row storage)
+   const long num_grids = g_param_yt.num_grids;
+
+   Child_Start = new long [num_grids+1];
+   Child_List  = new long [num_grids];
+   fill        = new long [num_grids];
+
+   for (long g=0; g<=num_grids; g++)   Child_Start[g] = 0;
+   for (long g=0; g<num_grids; g++)    if ( g_grids[g].parent_id >= 0 )   Child_Start[ g_grids[g].parent_id + 1 ] ++;
+   for (long g=0; g<num_grids; g++)    Child_Start[g+1] += Child_Start[g];
+   for (long g=0; g<num_grids; g++)    fill[g] = Child_Start[g];
+   for (long g=0; g<num_grids; g++)    if ( g_grids[g].parent_id >= 0 )   Child_List[ fill[ g_grids[g].parent_id ] ++ ] = g;
+
+   delete [] fill;
+
+   Index_Built = true;
+
+   pthread_mutex_unlock( &Index_Mutex );
+
+   log_debug( "Building the spatial index with %d x %d x %d buckets ... done\n", NBucket[0], NBucket[1], NBucket[2] );
+
+   return YT_SUCCESS;
+
+} // FUNCTION : grid_index_build
+
+
+
+//-------------------------------------------------------------------------------------------------------
+// Function    :  grid_index_find
+// Description :  Return the ID of the finest grid containing the target point
+//
+// Note        :  1. Must call grid_index_build() in advance
+//                2. Each grid covers [left_edge, right_edge)
+//                3. Thread-safe
+//
+// Parameter   :  pos : Target point
+//
+// Return      :  Grid ID or -1 if the point lies outside all grids
+//-------------------------------------------------------------------------------------------------------
+long grid_index_find( const double pos[3] )
+{
+
+   long bucket = 0;
+
+   for (int d=0; d<3; d++)
+   {
+      if ( pos[d] < g_param_yt.domain_left_edge[d]  ||  pos[d] >= g_param_yt.domain_right_edge[d] )   return -1;
+
+      const int b = MIN( NBucket[d]-1, (int)( ( pos[d] - g_param_yt.domain_left_edge[d] ) / Bucket_Size[d] ) );
+      bucket = bucket*NBucket[d] + b;
+   }
+
+   for (long t=Bucket_Start[bucket]; t<Bucket_Start[bucket+1]; t++)
+   {
+      const yt_grid *grid = g_grids + Bucket_Grids[t];
+
+      if ( pos[0] >= grid->left_edge[0]  &&  pos[0] < grid->right_edge[0]  &&
+           pos[1] >= grid->left_edge[1]  &&  pos[1] < grid->right_edge[1]  &&
+           pos[2] >= grid->left_edge[2]  &&  pos[2] < grid->right_edge[2]     )
+         return grid->id;
+   }
+
+   return -1;
+
+} // FUNCTION : grid_index_find
+
+
+
+//-------------------------------------------------------------------------------------------------------
+// Function    :  grid_index_query
+// Description :  Return the IDs of all grids overlapping with the target box
+//
+// Note        :  1. Must call grid_index_build() in advance
+//                2. Grids touching the box only at its faces are excluded
+//                3. Thread-safe
+//
+// Parameter   :  left     : Left  edge of the target box
+//                right    : Right edge of the target box
+//                grid_ids : IDs of the overlapping grids to be returned (must have room for all grids)
+//
+// Return      :  Number of overlapping grids
+//-------------------------------------------------------------------------------------------------------
+long grid_index_query( const double left[3], const double right[3], long *grid_ids )
+{
+
+   int lo[3], hi[3];
+
+   for (int d=0; d<3; d++)
+   {
+      lo[d] = MAX( 0,            (int)floor( ( left [d] - g_param_yt.domain_left_edge[d] ) / Bucket_Size[d] )     );
+      hi[d] = MIN( NBucket[d]-1, (int)ceil ( ( right[d] - g_param_yt.domain_left_edge[d] ) / Bucket_Size[d] ) - 1 );
+   }
+
+   char *found     = new char [ g_param_yt.num_grids ];
+   long  num_found = 0;
+
+   for (long g=0; g<g_param_yt.num_grids; g++)   found[g] = false;
+
+   for (int i=lo[0]; i<=hi[0]; i++)
+   for (int j=lo[1]; j<=hi[1]; j++)
+   for (int k=lo[2]; k<=hi[2]; k++)
+   {
+      const long bucket = ( (long)i*NBucket[1] + j )*NBucket[2] + k;
+
+      for (long t=Bucket_Start[bucket]; t<Bucket_Start[bucket+1]; t++)
+      {
+         const yt_grid *grid = g_grids + Bucket_Grids[t];
+
+         if ( found[ grid->id ] )   continue;
+
+         if ( grid->left_edge[0] < right[0]  &&  grid->right_edge[0] > left[0]  &&
+              grid->left_edge[1] < right[1]  &&  grid->right_edge[1] > left[1]  &&
+              grid->left_edge[2] < right[2]  &&  grid->right_edge[2] > left[2]     )
+         {
+            found[ grid->id ]       = true;
+            grid_ids[ num_found++ ] = grid->id;
+         }
+      }
+   }
+
+   delete [] found;
+
+   return num_found;
+
+} // FUNCTION : grid_index_query
+
+
+
+//-------------------------------------------------------------------------------------------------------
+// Function    :  grid_index_mark_covered
+// Description :  Mark the cells of a grid covered by its child grids
+//
+// Note        :  1. Must call grid_index_build() in advance
+//                2. Only cells covered by child grids are updated
+//                3. Thread-safe
+//
+// Parameter   :  grid_id : Target grid ID
+//                mask    : Cell mask of the target grid to be updated
+//                value   : Value assigned to covered cells
+//
+// Return      :  mask
+//-------------------------------------------------------------------------------------------------------
+void grid_index_mark_covered( const long grid_id, char *mask, const char value )
+{
+
+   const yt_grid *grid = g_grids + grid_id;
+   const int     *dim  = grid->dimensions;
+
+   for (long t=Child_Start[grid_id]; t<Child_Start[grid_id+1]; t++)
+   {
+      const yt_grid *child = g_grids + Child_List[t];
+      int lo[3], hi[3];
+
+      for (int d=0; d<3; d++)
+      {
+         const double dh = ( grid->right_edge[d] - grid->left_edge[d] ) / dim[d];
+
+         lo[d] = MAX( 0,      (int)floor( ( child->left_edge [d] - grid->left_edge[d] )/dh + 0.5 ) );
+         hi[d] = MIN( dim[d], (int)floor( ( child->right_edge[d] - grid->left_edge[d] )/dh + 0.5 ) );
+      }
+
+      for (int i=lo[0]; i<hi[0]; i++)
+      for (int j=lo[1]; j<hi[1]; j++)
+      for (int k=lo[2]; k<hi[2]; k++)
+         mask[ ( (long)i*dim[1] + j )*dim[2] + k ] = value;
+   }
+
+} // FUNCTION : grid_index_mark_covered
+
+
+
+//-------------------------------------------------------------------------------------------------------
+// Function    :  grid_index_children
+// Description :  Return the child grids of a grid
+//
+// Note        :  1. Must call grid_index_build() in advance
+//                2. Children are found through "parent_id"
+//                3. Thread-safe
+//
+// Parameter   :  grid_id  : Target grid ID
+//                children : Pointer to the IDs of the child grids to be returned
+//
+// Return      :  Number of child grids
+//-------------------------------------------------------------------------------------------------------
+long grid_index_children( const long grid_id, const long **children )
+{
+
+   *children = Child_List + Child_Start[grid_id];
+
+   return Child_Start[grid_id+1] - Child_Start[grid_id];
+
+} // FUNCTION : grid_index_children
+
+
+
+//-------------------------------------------------------------------------------------------------------
+// Function    :  grid_index_free
+// Description :  Free the spatial index built by grid_index_build()
+//
+// Note        :  1. Called by yt_inline() at the end of each step, after all native calls have returned
+//                   (see native_call_drain())
+//
+// Parameter   :  None
+//
+// Return      :  None
+//-------------------------------------------------------------------------------------------------------
+void grid_index_free()
+{
+
+   pthread_mutex_lock( &Index_Mutex );
+
+   delete [] Bucket_Start;
+   delete [] Bucket_Grids;
+   delete [] Child_Start;
+   delete [] Child_List;
+
+   Bucket_Start = NULL;
+   Bucket_Grids = NULL;
+   Child_Start  = NULL;
+   Child_List   = NULL;
+   Index_Built  = false;
+
+   pthread_mutex_unlock( &Index_Mutex );
+
+} // FUNCTION : grid_index_free
+
+
+
+//-------------------------------------------------------------------------------------------------------
+// Function    :  bucket_range
+// Description :  Return the range of buckets overlapping with the target grid
+//
+// Note        :  1. Inclusive range ==> lo[d] <= bucket index <= hi[d]
+//
+// Parameter   :  grid : Target grid
+//                lo   : Lower bucket index to be returned
+//                hi   : Upper bucket index to be returned
+//
+// Return      :  lo, hi
+//-------------------------------------------------------------------------------------------------------
+static void bucket_range( const yt_grid *grid, int lo[3], int hi[3] )
+{
+
+   for (int d=0; d<3; d++)
+   {
+      const double left  = ( grid->left_edge [d] - g_param_yt.domain_left_edge[d] ) / Bucket_Size[d];
+      const double right = ( grid->right_edge[d] - g_param_yt.domain_left_edge[d] ) / Bucket_Size[d];
+
+      lo[d] = MAX( 0,            (int)floor( left  )     );
+      hi[d] = MIN( NBucket[d]-1, (int)ceil ( right ) - 1 );
+      hi[d] = MAX( lo[d], hi[d] );
+   }
+
+} // FUNCTION : bucket_range
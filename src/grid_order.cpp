@@ -0,0 +1,325 @@
+#include "yt_combo.h"
+#include <math.h>
+
+
+// host ID (i.e., the ID passed to yt_add_grid()) of each grid after renumbering (NULL ==> not renumbered)
+static long *Host_ID      = NULL;
+static long  NumHostGrids = 0;
+
+// number of bits per dimension of the space-filling-curve keys
+static const int NBit = 21;
+
+struct grid_key
+{
+   unsigned long key;
+   int           level;
+   long          index;
+};
+
+static unsigned long morton_key( const unsigned long coord[3] );
+static unsigned long hilbert_key( const unsigned long coord[3] );
+static int compare_key( const void *a, const void *b );
+
+
+
+
+//-------------------------------------------------------------------------------------------------------
+// Function    :  renumber_grids
+// Description :  Select and reorder the staged grids
+//
+// Note        :  1. Called by compact_grids() and order_grids()
+//                2. Grid "g" becomes grid "new_id[g]", or is discarded if new_id[g] < 0
+//                   ==> Parent IDs are remapped (-1 if the parent grid is discarded)
+//                3. Update "g_grids", "g_param_libyt.grid_set", and "g_param_yt.num_grids"
+//                4. The host ID of each grid is kept for libyt.grid_permutation (see export_grid_order())
+//                5. Wait for the native calls still reading "g_grids" before replacing it (see native_call_drain())
+//
+// Parameter   :  new_id : New ID of each grid
+//                count  : Number of grids after renumbering
+//
+// Return      :  YT_SUCCESS or YT_FAIL
+//-------------------------------------------------------------------------------------------------------
+int renumber_grids( const long *new_id, const long count )
+{
+
+   const long num_grids = g_param_yt.num_grids;
+
+   if ( Host_ID == NULL )
+   {
+      NumHostGrids = num_grids;
+      Host_ID      = new long [num_grids];
+
+      for (long g=0; g<num_grids; g++)   Host_ID[g] = g;
+   }
+
+   yt_grid *grids   = new yt_grid [count];
+   long    *host_id = new long    [count];
+
+   for (long g=0; g<num_grids; g++)
+   {
+      if ( new_id[g] < 0 )   continue;
+
+      yt_grid *grid = grids + new_id[g];
+
+      *grid           = g_grids[g];
+      grid->id        = new_id[g];
+      grid->parent_id = ( grid->parent_id >= 0 ) ? new_id[ grid->parent_id ] : -1;
+
+      host_id[ new_id[g] ] = Host_ID[g];
+   }
+
+   native_call_drain();
+
+   delete [] g_grids;
+   delete [] Host_ID;
+   g_grids = grids;
+   Host_ID = host_id;
+
+   for (long g=count; g<num_grids; g++)   g_param_libyt.grid_set[g] = false;
+
+   g_param_yt.num_grids = count;
+
+   return YT_SUCCESS;
+
+} // FUNCTION : renumber_grids
+
+
+
+//-------------------------------------------------------------------------------------------------------
+// Function    :  order_grids
+// Description :  Sort the grids along a space-filling curve
+//
+// Note        :  1. Called by yt_inline() after compact_grids() and before commit_grids()
+//                2. Order is set by "g_param_libyt.grid_order"
+//                   ==> Keys are computed from the left edges normalized to the simulation domain with
+//                       21 bits per dimension
+//                   ==> Grids with the same key are sorted by level (i.e., parents first)
+//                3. Spatially local grids are then adjacent in libyt.hierarchy and libyt.grid_data
+//
+// Parameter   :  None
+//
+// Return      :  YT_SUCCESS or YT_FAIL
+//-------------------------------------------------------------------------------------------------------
+int order_grids()
+{
+
+   if ( g_param_libyt.grid_order == YT_ORDER_HOST )   return YT_SUCCESS;
+
+   const long   num_grids = g_param_yt.num_grids;
+   const double scale     = (double)( 1UL << NBit );
+   grid_key    *keys      = new grid_key [num_grids];
+
+   for (long g=0; g<num_grids; g++)
+   {
+      const yt_grid *grid = g_grids + g;
+      unsigned long coord[3];
+
+      for (int d=0; d<3; d++)
+      {
+         const double width = g_param_yt.domain_right_edge[d] - g_param_yt.domain_left_edge[d];
+         const double x     = ( d < g_param_yt.dimensionality ) ? ( grid->left_edge[d] - g_param_yt.domain_left_edge[d] )/width : 0.0;
+
+         coord[d] = (unsigned long)MIN( MAX( floor( x*scale ), 0.0 ), scale-1.0 );
+      }
+
+      keys[g].key   = ( g_param_libyt.grid_order == YT_ORDER_MORTON ) ? morton_key( coord ) : hilbert_key( coord );
+      keys[g].level = grid->level;
+      keys[g].index = g;
+   }
+
+   qsort( keys, num_grids, sizeof(grid_key), compare_key );
+
+   long *new_id = new long [num_grids];
+   for (long g=0; g<num_grids; g++)   new_id[ keys[g].index ] = g;
+
+   const int status = renumber_grids( new_id, num_grids );
+
+   delete [] new_id;
+   delete [] keys;
+
+   log_debug( "Sorting %ld grids along the %s curve ... done\n", num_grids,
+              ( g_param_libyt.grid_order == YT_ORDER_MORTON ) ? "Morton" : "Hilbert" );
+
+   return status;
+
+} // FUNCTION : order_grids
+
+
+
+//-------------------------------------------------------------------------------------------------------
+// Function    :  export_grid_order
+// Description :  Export the renumbering of this step to libyt.grid_permutation and
+//                libyt.grid_inverse_permutation
+//
+// Note        :  1. Called by commit_grids()
+//                2. grid_permutation[id]              = host ID of grid "id" in libyt.hierarchy
+//                   grid_inverse_permutation[host_id] = ID in libyt.hierarchy of grid "host_id"
+//                                                       (-1 if discarded by the grid filter)
+//                3. Both are None if the grids are not renumbered
+//
+// Parameter   :  None
+//
+// Return      :  YT_SUCCESS or YT_FAIL
+//-------------------------------------------------------------------------------------------------------
+int export_grid_order()
+{
+
+   PyObject *py_libyt = PyImport_AddModule( "libyt" );   // borrowed reference
+   PyObject *py_perm, *py_inverse;
+
+   if ( Host_ID == NULL )
+   {
+      Py_INCREF( Py_None );
+      Py_INCREF( Py_None );
+      py_perm    = Py_None;
+      py_inverse = Py_None;
+   }
+
+   else
+   {
+      npy_intp np_dim_perm[1]    = { g_param_yt.num_grids };
+      npy_intp np_dim_inverse[1] = { NumHostGrids };
+
+      py_perm    = PyArray_SimpleNew( 1, np_dim_perm,    NPY_LONG );
+      py_inverse = PyArray_SimpleNew( 1, np_dim_inverse, NPY_LONG );
+
+      npy_long *perm    = (npy_long*)PyArray_DATA( (PyArrayObject*)py_perm    );
+      npy_long *inverse = (npy_long*)PyArray_DATA( (PyArrayObject*)py_inverse );
+
+      for (long g=0; g<NumHostGrids;         g++)   inverse[g] = -1;
+      for (long g=0; g<g_param_yt.num_grids; g++) { perm[g] = Host_ID[g];   inverse[ Host_ID[g] ] = g; }
+   }
+
+   const int status = ( PyObject_SetAttrString( py_libyt, "grid_permutation",         py_perm    ) == 0  &&
+                        PyObject_SetAttrString( py_libyt, "grid_inverse_permutation", py_inverse ) == 0 )
+                      ? YT_SUCCESS : YT_FAIL;
+
+   Py_DECREF( py_perm );
+   Py_DECREF( py_inverse );
+
+   return status;
+
+} // FUNCTION : export_grid_order
+
+
+
+//-------------------------------------------------------------------------------------------------------
+// Function    :  grid_host_id
+// Description :  Return the host ID (i.e., the ID passed to yt_add_grid()) of a grid
+//
+// Note        :  1. Called by export_block_pools()
+//
+// Parameter   :  grid_id : Grid ID in libyt.hierarchy
+//
+// Return      :  Host ID
+//-------------------------------------------------------------------------------------------------------
+long grid_host_id( const long grid_id )
+{
+
+   return ( Host_ID == NULL ) ? grid_id : Host_ID[grid_id];
+
+} // FUNCTION : grid_host_id
+
+
+
+//-------------------------------------------------------------------------------------------------------
+// Function    :  grid_order_free
+// Description :  Release the host IDs of this step
+//
+// Note        :  1. Called by yt_inline() at the end of each analysis
+//
+// Parameter   :  None
+//
+// Return      :  None
+//-------------------------------------------------------------------------------------------------------
+void grid_order_free()
+{
+
+   delete [] Host_ID;
+   Host_ID      = NULL;
+   NumHostGrids = 0;
+
+} // FUNCTION : grid_order_free
+
+
+
+//-------------------------------------------------------------------------------------------------------
+// Function    :  morton_key / hilbert_key
+// Description :  Keys of the Morton (Z-order) and Hilbert curves of 3D integer coordinates
+//
+// Note        :  1. hilbert_key() follows J. Skilling, "Programming the Hilbert curve", AIP Conf. Proc.
+//                   707, 381 (2004): transform the coordinates to the transposed Hilbert index, and then
+//                   interleave its bits as for the Morton key
+//
+// Parameter   :  coord : Integer coordinates in [0, 2^NBit)
+//
+// Return      :  Key of 3*NBit bits
+//-------------------------------------------------------------------------------------------------------
+static unsigned long morton_key( const unsigned long coord[3] )
+{
+
+   unsigned long key = 0;
+
+   for (int b=NBit-1; b>=0; b--)
+   for (int d=0; d<3; d++)
+      key = ( key << 1 ) | ( ( coord[d] >> b ) & 1UL );
+
+   return key;
+
+} // FUNCTION : morton_key
+
+
+static unsigned long hilbert_key( const unsigned long coord[3] )
+{
+
+   unsigned long x[3] = { coord[0], coord[1], coord[2] };
+   const unsigned long M = 1UL << ( NBit - 1 );
+
+// inverse undo
+   for (unsigned long Q=M; Q>1; Q>>=1)
+   {
+      const unsigned long P = Q - 1;
+
+      for (int d=0; d<3; d++)
+      {
+         if ( x[d] & Q )   x[0] ^= P;
+         else
+         {
+            const unsigned long t = ( x[0] ^ x[d] ) & P;
+            x[0] ^= t;
+            x[d] ^= t;
+         }
+      }
+   }
+
+// Gray encode
+   for (int d=1; d<3; d++)   x[d] ^= x[d-1];
+
+   unsigned long t = 0;
+   for (unsigned long Q=M; Q>1; Q>>=1)
+      if ( x[2] & Q )   t ^= Q - 1;
+
+   for (int d=0; d<3; d++)   x[d] ^= t;
+
+   return morton_key( x );
+
+} // FUNCTION : hilbert_key
+
+
+
+//-------------------------------------------------------------------------------------------------------
+// Function    :  compare_key
+// Description :  Comparison function of qsort() for sorting grids by key and then by level
+//-------------------------------------------------------------------------------------------------------
+static int compare_key( const void *a, const void *b )
+{
+
+   const grid_key *ka = (const grid_key*)a;
+   const grid_key *kb = (const grid_key*)b;
+
+   if ( ka->key   != kb->key   )   return ( ka->key   < kb->key   ) ? -1 : +1;
+   if ( ka->level != kb->level )   return ( ka->level < kb->level ) ? -1 : +1;
+
+   return ( ka->index < kb->index ) ? -1 : ( ka->index > kb->index );
+
+} // FUNCTION : compare_key
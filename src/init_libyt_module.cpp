@@ -6,6 +6,22 @@
 static PyMethodDef libyt_method_list[] =
 {
 // { "method_name", c_function_name, METH_VARARGS, "Description"},
+   { "_decode_hierarchy", decode_hierarchy,  METH_VARARGS, "Decode grid indices and edges from the compact hierarchy" },
+   { "derived_field",     get_derived_field, METH_VARARGS, "Compute a derived field of a grid by its native kernel" },
+   { "find_clumps",       get_clumps,        METH_VARARGS, "Find connected regions of leaf cells above a threshold" },
+   { "covering_grid",     (PyCFunction)get_covering_grid, METH_VARARGS | METH_KEYWORDS,
+                                                            "Resample fields onto a uniform grid at a given level" },
+   { "render",            (PyCFunction)get_render, METH_VARARGS | METH_KEYWORDS,
+                                                            "Render an off-axis projection or volume rendering" },
+   { "sample",            (PyCFunction)get_sample, METH_VARARGS | METH_KEYWORDS,
+                                                            "Interpolate fields at arbitrary positions" },
+   { "ring_buffer",       (PyCFunction)get_ring_buffer, METH_VARARGS | METH_KEYWORDS,
+                                                            "Get or create a ring buffer kept across yt_inline()" },
+   { "parallel_map",      (PyCFunction)parallel_map, METH_VARARGS | METH_KEYWORDS,
+                                                            "Map a function over items with forked worker processes" },
+   { "submit_output",     submit_output,     METH_VARARGS, "Execute callable(*args) by the background output workers" },
+   { "_decode_field",     get_decoded_field, METH_VARARGS, "Decode an encoded field of a grid" },
+   { "_grid_data",        get_grid_data,     METH_VARARGS, "Create the dictionary of all fields of a grid" },
    { NULL, NULL, 0, NULL } // sentinel
 };
 
@@ -38,16 +54,128 @@ int init_libyt_module()
       YT_ABORT(  "Obtaining the __dict__ attribute of libyt ... failed!\n" );
 
 
+// define the dictionary type of libyt.hierarchy
+// ==> __missing__() decodes "grid_left_index", "grid_left_edge", and "grid_right_edge" on access when using the
+//     compact hierarchy
+   const char *HierarchyClass = "class _hierarchy_dict( dict ):\n"
+                                "    def __missing__( self, key ):\n"
+                                "        return _decode_hierarchy( key )\n";
+   PyObject *py_result = PyRun_String( HierarchyClass, Py_file_input, libyt_module_dict, libyt_module_dict );
+
+   if ( py_result != NULL )
+      log_debug( "Defining libyt._hierarchy_dict ... done\n" );
+   else
+   {
+      PyErr_Print();
+      YT_ABORT(  "Defining libyt._hierarchy_dict ... failed!\n" );
+   }
+
+   Py_DECREF( py_result );
+
+
+// define the dictionary type of the grids with encoded fields in libyt.grid_data
+// ==> __missing__() decodes the encoded fields on access
+   const char *GridClass = "class _grid_dict( dict ):\n"
+                           "    def __init__( self, grid_id, encoded ):\n"
+                           "        dict.__init__( self )\n"
+                           "        self._id      = grid_id\n"
+                           "        self._encoded = encoded\n"
+                           "    def __missing__( self, key ):\n"
+                           "        if key in self._encoded:\n"
+                           "            return _decode_field( self._id, key )\n"
+                           "        raise KeyError( key )\n"
+                           "    def __contains__( self, key ):\n"
+                           "        return dict.__contains__( self, key ) or key in self._encoded\n"
+                           "    def __iter__( self ):\n"
+                           "        return iter( self.keys() )\n"
+                           "    def __len__( self ):\n"
+                           "        return dict.__len__( self ) + len( self._encoded )\n"
+                           "    def keys( self ):\n"
+                           "        return dict.keys( self ) + list( self._encoded )\n"
+                           "    def has_key( self, key ):\n"
+                           "        return key in self\n"
+                           "    def get( self, key, default=None ):\n"
+                           "        return self[key] if key in self else default\n"
+                           "    def items( self ):\n"
+                           "        return [ ( key, self[key] ) for key in self.keys() ]\n";
+   py_result = PyRun_String( GridClass, Py_file_input, libyt_module_dict, libyt_module_dict );
+
+   if ( py_result != NULL )
+      log_debug( "Defining libyt._grid_dict ... done\n" );
+   else
+   {
+      PyErr_Print();
+      YT_ABORT(  "Defining libyt._grid_dict ... failed!\n" );
+   }
+
+   Py_DECREF( py_result );
+
+   g_py_grid_dict = PyDict_GetItemString( libyt_module_dict, "_grid_dict" );
+   Py_INCREF( g_py_grid_dict );
+
+
+// define the dictionary type of libyt.grid_data
+// ==> __missing__() creates libyt.grid_data[grid_id] on access (see get_grid_data())
+   const char *GridDataClass = "class _grid_data_dict( dict ):\n"
+                               "    _num_grids = 0\n"
+                               "    def __missing__( self, key ):\n"
+                               "        if not isinstance( key, ( int, long ) ) or not 0 <= key < self._num_grids:\n"
+                               "            raise KeyError( key )\n"
+                               "        grid = _grid_data( key )\n"
+                               "        dict.__setitem__( self, key, grid )\n"
+                               "        return grid\n"
+                               "    def __contains__( self, key ):\n"
+                               "        return isinstance( key, ( int, long ) ) and 0 <= key < self._num_grids\n"
+                               "    def __iter__( self ):\n"
+                               "        return iter( xrange( self._num_grids ) )\n"
+                               "    def __len__( self ):\n"
+                               "        return self._num_grids\n"
+                               "    def keys( self ):\n"
+                               "        return range( self._num_grids )\n"
+                               "    def values( self ):\n"
+                               "        return [ self[key] for key in xrange( self._num_grids ) ]\n"
+                               "    def items( self ):\n"
+                               "        return [ ( key, self[key] ) for key in xrange( self._num_grids ) ]\n"
+                               "    def iterkeys( self ):\n"
+                               "        return iter( self )\n"
+                               "    def itervalues( self ):\n"
+                               "        return ( self[key] for key in xrange( self._num_grids ) )\n"
+                               "    def iteritems( self ):\n"
+                               "        return ( ( key, self[key] ) for key in xrange( self._num_grids ) )\n"
+                               "    def has_key( self, key ):\n"
+                               "        return key in self\n"
+                               "    def get( self, key, default=None ):\n"
+                               "        return self[key] if key in self else default\n";
+   py_result = PyRun_String( GridDataClass, Py_file_input, libyt_module_dict, libyt_module_dict );
+
+   if ( py_result != NULL )
+      log_debug( "Defining libyt._grid_data_dict ... done\n" );
+   else
+   {
+      PyErr_Print();
+      YT_ABORT(  "Defining libyt._grid_data_dict ... failed!\n" );
+   }
+
+   Py_DECREF( py_result );
+
+
 // attach empty dictionaries
-   g_py_grid_data  = PyDict_New();
-   g_py_hierarchy  = PyDict_New();
-   g_py_param_yt   = PyDict_New();
+// ==> libyt.param_yt is a read-only dictionary-like object backed by "g_param_yt"
+   g_py_grid_data  = PyObject_CallObject( PyDict_GetItemString( libyt_module_dict, "_grid_data_dict" ), NULL );
+   g_py_hierarchy  = PyObject_CallObject( PyDict_GetItemString( libyt_module_dict, "_hierarchy_dict" ), NULL );
+   g_py_param_yt   = new_param_yt_object();
    g_py_param_user = PyDict_New();
+   g_py_derived_cache = PyDict_New();
+   g_py_views      = PyList_New( 0 );
 
    PyDict_SetItemString( libyt_module_dict, "grid_data",  g_py_grid_data  );
    PyDict_SetItemString( libyt_module_dict, "hierarchy",  g_py_hierarchy  );
    PyDict_SetItemString( libyt_module_dict, "param_yt",   g_py_param_yt   );
    PyDict_SetItemString( libyt_module_dict, "param_user", g_py_param_user );
+   PyModule_AddObject( libyt_module, "block_pools", PyList_New( 0 ) );
+   PyModule_AddObject( libyt_module, "field_list",  PyDict_New() );
+   PyModule_AddObject( libyt_module, "ring_buffers", PyDict_New() );
+   PyModule_AddObject( libyt_module, "analysis_task", PyDict_New() );
 
    log_debug( "Attaching empty dictionaries to libyt module ... done\n" );
 
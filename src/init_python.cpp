@@ -36,6 +36,9 @@ int init_python( int argc, char *argv[] )
 // set sys.argv
    PySys_SetArgv( argc, argv );
 
+// create the GIL so that the output workers can run Python code
+   PyEval_InitThreads();
+
 
 // import numpy
    if ( import_numpy() )
@@ -50,7 +53,12 @@ int init_python( int argc, char *argv[] )
 
 
 // add the current location to the module search path (sys._parallel = True --> run yt in parallel )
-   if ( PyRun_SimpleString( "import sys; sys.path.insert(0,'.'); sys._parallel = True" ) == 0 )
+// ==> analysis ranks in the staging mode run yt serially, since MPI_COMM_WORLD also contains the compute ranks
+//     and the other analysis ranks, which are working on other steps
+   const char *SetPath = ( g_param_libyt.analysis_rank ) ? "import sys; sys.path.insert(0,'.'); sys._parallel = False"
+                                                         : "import sys; sys.path.insert(0,'.'); sys._parallel = True";
+
+   if ( PyRun_SimpleString( SetPath ) == 0 )
       log_debug( "Adding search path for modules ... done\n" );
    else
       YT_ABORT(  "Adding search path for modules ... failed!\n" );
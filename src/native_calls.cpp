@@ -0,0 +1,85 @@
+#include "yt_combo.h"
+#include <pthread.h>
+
+
+
+
+// number of native calls reading the staged grids without holding the GIL (see yt_nogil_guard)
+// ==> incremented and checked only with the GIL held, so no new call can start while a thread holding the
+//     GIL sees zero
+static int             Num_Calls   = 0;
+static pthread_mutex_t Calls_Mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t  Calls_Done  = PTHREAD_COND_INITIALIZER;
+
+
+
+
+//-------------------------------------------------------------------------------------------------------
+// Function    :  native_call_begin / native_call_end
+// Description :  Count a native call in flight
+//
+// Note        :  1. Called by yt_nogil_guard with the GIL held
+//
+// Parameter   :  None
+//
+// Return      :  None
+//-------------------------------------------------------------------------------------------------------
+void native_call_begin()
+{
+
+   pthread_mutex_lock( &Calls_Mutex );
+   Num_Calls ++;
+   pthread_mutex_unlock( &Calls_Mutex );
+
+} // FUNCTION : native_call_begin
+
+
+void native_call_end()
+{
+
+   pthread_mutex_lock( &Calls_Mutex );
+   if ( --Num_Calls == 0 )   pthread_cond_broadcast( &Calls_Done );
+   pthread_mutex_unlock( &Calls_Mutex );
+
+} // FUNCTION : native_call_end
+
+
+
+//-------------------------------------------------------------------------------------------------------
+// Function    :  native_call_drain
+// Description :  Wait until no native call reads the staged grids
+//
+// Note        :  1. Called by begin_step(), reset_step(), and renumber_grids() with the GIL held before
+//                   freeing or replacing the grids
+//                   ==> e.g., an output worker may still be inside libyt.render() started by the script
+//                   ==> "g_param_libyt.grids_committed" is cleared first so that no new call can start
+//                2. Release the GIL while waiting so that the calls in flight can return
+//                3. No call is in flight on return as long as the GIL is held
+//                4. Return immediately if no call is in flight, which is always the case on the processes
+//                   without Python (i.e., the compute ranks and the shared-memory transport)
+//
+// Parameter   :  None
+//
+// Return      :  None
+//-------------------------------------------------------------------------------------------------------
+void native_call_drain()
+{
+
+   while ( true )
+   {
+      pthread_mutex_lock( &Calls_Mutex );
+      const int num_calls = Num_Calls;
+      pthread_mutex_unlock( &Calls_Mutex );
+
+      if ( num_calls == 0 )   return;
+
+      log_debug( "Waiting for %d native call(s) in flight ...\n", num_calls );
+
+      Py_BEGIN_ALLOW_THREADS
+      pthread_mutex_lock( &Calls_Mutex );
+      while ( Num_Calls > 0 )   pthread_cond_wait( &Calls_Done, &Calls_Mutex );
+      pthread_mutex_unlock( &Calls_Mutex );
+      Py_END_ALLOW_THREADS
+   }
+
+} // FUNCTION : native_call_drain
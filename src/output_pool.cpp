@@ -0,0 +1,308 @@
+#include "yt_combo.h"
+#include <pthread.h>
+
+
+
+
+// queue item: a Python callable and its arguments (both are owned references)
+struct output_task
+{
+   PyObject *callable;
+   PyObject *args;
+};
+
+
+// internal states of the output workers
+// ==> the queue is a bounded circular buffer protected by "Pool_Mutex"
+static output_task    *Queue        = NULL;
+static int             Queue_Size   = 0;
+static int             Queue_Head   = 0;
+static int             Queue_Count  = 0;
+static int             Num_Running  = 0;      // number of tasks being executed
+static bool            Stop         = false;
+static int             Num_Workers  = 0;
+static pthread_t      *Workers      = NULL;
+static pthread_mutex_t Pool_Mutex   = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t  Pool_NotFull = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t  Pool_NotEmpty= PTHREAD_COND_INITIALIZER;
+static pthread_cond_t  Pool_Idle    = PTHREAD_COND_INITIALIZER;
+
+static void *worker_main( void *arg );
+
+
+
+
+//-------------------------------------------------------------------------------------------------------
+// Function    :  output_pool_init
+// Description :  Launch the output workers
+//
+// Note        :  1. Called by yt_init() after initializing Python
+//                2. Number of workers and queue size are set by "g_param_libyt.output_threads" and
+//                   "g_param_libyt.output_queue_size"
+//                   ==> No worker is launched if output_threads == 0, in which case libyt.submit_output()
+//                       executes the callable immediately
+//
+// Parameter   :  None
+//
+// Return      :  YT_SUCCESS or YT_FAIL
+//-------------------------------------------------------------------------------------------------------
+int output_pool_init()
+{
+
+   Num_Workers = g_param_libyt.output_threads;
+   Queue_Size  = g_param_libyt.output_queue_size;
+   Stop        = false;
+
+   if ( Num_Workers == 0 )   return YT_SUCCESS;
+
+   Queue   = new output_task [Queue_Size];
+   Workers = new pthread_t   [Num_Workers];
+
+   for (int t=0; t<Num_Workers; t++)
+      if ( pthread_create( Workers+t, NULL, worker_main, NULL ) != 0 )
+         YT_ABORT( "Launching output worker %d ... failed!\n", t );
+
+   log_debug( "Launching %d output worker(s) with a queue of %d tasks ... done\n", Num_Workers, Queue_Size );
+
+   return YT_SUCCESS;
+
+} // FUNCTION : output_pool_init
+
+
+
+//-------------------------------------------------------------------------------------------------------
+// Function    :  output_pool_submit
+// Description :  Push a task to the queue of the output workers
+//
+// Note        :  1. Must be called with the GIL held
+//                2. Block until there is room in the queue (backpressure), with the GIL released so that
+//                   workers can make progress
+//                3. The references of "callable" and "args" are stolen
+//
+// Parameter   :  callable : Python callable
+//                args     : Tuple of the arguments of "callable"
+//
+// Return      :  None
+//-------------------------------------------------------------------------------------------------------
+void output_pool_submit( PyObject *callable, PyObject *args )
+{
+
+   Py_BEGIN_ALLOW_THREADS
+
+   pthread_mutex_lock( &Pool_Mutex );
+
+   while ( Queue_Count == Queue_Size )   pthread_cond_wait( &Pool_NotFull, &Pool_Mutex );
+
+   output_task *task = Queue + ( Queue_Head + Queue_Count ) % Queue_Size;
+   task->callable = callable;
+   task->args     = args;
+   Queue_Count ++;
+
+   pthread_cond_signal( &Pool_NotEmpty );
+   pthread_mutex_unlock( &Pool_Mutex );
+
+   Py_END_ALLOW_THREADS
+
+} // FUNCTION : output_pool_submit
+
+
+
+//-------------------------------------------------------------------------------------------------------
+// Function    :  output_pool_wait
+// Description :  Wait until all submitted tasks have been executed
+//
+// Note        :  1. Must be called WITHOUT the GIL held, since workers need it to execute the tasks
+//
+// Parameter   :  None
+//
+// Return      :  None
+//-------------------------------------------------------------------------------------------------------
+void output_pool_wait()
+{
+
+   if ( Num_Workers == 0 )   return;
+
+   pthread_mutex_lock( &Pool_Mutex );
+
+   while ( Queue_Count > 0  ||  Num_Running > 0 )   pthread_cond_wait( &Pool_Idle, &Pool_Mutex );
+
+   pthread_mutex_unlock( &Pool_Mutex );
+
+} // FUNCTION : output_pool_wait
+
+
+
+//-------------------------------------------------------------------------------------------------------
+// Function    :  output_pool_is_worker
+// Description :  Return whether the calling thread is one of the output workers
+//
+// Note        :  1. Used by libyt.parallel_map(), which cannot wait for the output workers in a task
+//
+// Parameter   :  None
+//
+// Return      :  true/false
+//-------------------------------------------------------------------------------------------------------
+bool output_pool_is_worker()
+{
+
+   for (int w=0; w<Num_Workers; w++)
+      if ( pthread_equal( Workers[w], pthread_self() ) )   return true;
+
+   return false;
+
+} // FUNCTION : output_pool_is_worker
+
+
+
+//-------------------------------------------------------------------------------------------------------
+// Function    :  output_pool_finalize
+// Description :  Execute all pending tasks and terminate the output workers
+//
+// Note        :  1. Called by yt_finalize() before finalizing Python
+//                2. Must be called WITHOUT the GIL held
+//
+// Parameter   :  None
+//
+// Return      :  None
+//-------------------------------------------------------------------------------------------------------
+void output_pool_finalize()
+{
+
+   if ( Num_Workers == 0 )   return;
+
+   output_pool_wait();
+
+   pthread_mutex_lock( &Pool_Mutex );
+   Stop = true;
+   pthread_cond_broadcast( &Pool_NotEmpty );
+   pthread_mutex_unlock( &Pool_Mutex );
+
+   for (int t=0; t<Num_Workers; t++)   pthread_join( Workers[t], NULL );
+
+   delete [] Queue;
+   delete [] Workers;
+
+   Queue       = NULL;
+   Workers     = NULL;
+   Num_Workers = 0;
+
+   log_debug( "Terminating output workers ... done\n" );
+
+} // FUNCTION : output_pool_finalize
+
+
+
+//-------------------------------------------------------------------------------------------------------
+// Function    :  worker_main
+// Description :  Main loop of an output worker
+//
+// Note        :  1. Acquire the GIL only when executing a task
+//                2. Exceptions raised by tasks are printed and otherwise ignored
+//
+// Parameter   :  arg : Not used
+//
+// Return      :  NULL
+//-------------------------------------------------------------------------------------------------------
+static void *worker_main( void *arg )
+{
+
+   while ( true )
+   {
+//    get the next task
+      pthread_mutex_lock( &Pool_Mutex );
+
+      while ( Queue_Count == 0  &&  !Stop )   pthread_cond_wait( &Pool_NotEmpty, &Pool_Mutex );
+
+      if ( Queue_Count == 0  &&  Stop )
+      {
+         pthread_mutex_unlock( &Pool_Mutex );
+         break;
+      }
+
+      output_task task = Queue[Queue_Head];
+      Queue_Head = ( Queue_Head + 1 ) % Queue_Size;
+      Queue_Count --;
+      Num_Running ++;
+
+      pthread_cond_signal( &Pool_NotFull );
+      pthread_mutex_unlock( &Pool_Mutex );
+
+//    execute the task
+      {
+         yt_gil_guard gil;
+
+         PyObject *py_result = PyObject_CallObject( task.callable, task.args );
+
+         if ( py_result == NULL )
+         {
+            log_warning( "Output task raised an exception ==> ignored\n" );
+            PyErr_Print();
+         }
+
+         Py_XDECREF( py_result );
+         Py_DECREF( task.callable );
+         Py_DECREF( task.args );
+      }
+
+      pthread_mutex_lock( &Pool_Mutex );
+      Num_Running --;
+      if ( Queue_Count == 0  &&  Num_Running == 0 )   pthread_cond_broadcast( &Pool_Idle );
+      pthread_mutex_unlock( &Pool_Mutex );
+   } // while ( true )
+
+   return NULL;
+
+} // FUNCTION : worker_main
+
+
+
+//-------------------------------------------------------------------------------------------------------
+// Function    :  submit_output
+// Description :  Method "libyt.submit_output( callable, *args )" executing callable(*args) asynchronously
+//                by the output workers
+//
+// Note        :  1. Block if the queue is full
+//                2. Execute immediately if "g_param_libyt.output_threads == 0" or in a worker forked by
+//                   libyt.parallel_map()
+//                3. Arguments referring to libyt.grid_data must be copied, since the simulation may modify
+//                   its data after yt_inline() returns
+//
+// Parameter   :  self : Not used
+//                args : Callable followed by its arguments
+//
+// Return      :  None or NULL on error
+//-------------------------------------------------------------------------------------------------------
+PyObject *submit_output( PyObject *self, PyObject *args )
+{
+
+   if ( PyTuple_GET_SIZE( args ) < 1  ||  !PyCallable_Check( PyTuple_GET_ITEM( args, 0 ) ) )
+   {
+      PyErr_SetString( PyExc_TypeError, "submit_output() requires a callable as the first argument" );
+      return NULL;
+   }
+
+   PyObject *py_callable = PyTuple_GET_ITEM( args, 0 );
+   PyObject *py_args     = PyTuple_GetSlice( args, 1, PyTuple_GET_SIZE( args ) );
+
+   if ( py_args == NULL )   return NULL;
+
+// execute immediately if there is no worker
+// ==> including in the processes forked by libyt.parallel_map(), which do not inherit the workers
+   if ( Num_Workers == 0  ||  g_param_libyt.forked_worker )
+   {
+      PyObject *py_result = PyObject_CallObject( py_callable, py_args );
+      Py_DECREF( py_args );
+
+      if ( py_result == NULL )   return NULL;
+      Py_DECREF( py_result );
+   }
+
+   else
+   {
+      Py_INCREF( py_callable );
+      output_pool_submit( py_callable, py_args );
+   }
+
+   Py_RETURN_NONE;
+
+} // FUNCTION : submit_output
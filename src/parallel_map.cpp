@@ -0,0 +1,384 @@
+#include "yt_combo.h"
+#include <unistd.h>
+#include <errno.h>
+#include <signal.h>
+#include <sched.h>
+#include <sys/wait.h>
+
+
+
+
+//-------------------------------------------------------------------------------------------------------
+// Function    :  write_all / read_all
+// Description :  Write or read exactly "size" bytes through a pipe
+//
+// Return      :  true on success
+//-------------------------------------------------------------------------------------------------------
+static bool write_all( const int fd, const char *buffer, size_t size )
+{
+
+   while ( size > 0 )
+   {
+      const ssize_t done = write( fd, buffer, size );
+
+      if ( done < 0  &&  errno == EINTR )   continue;
+      if ( done <= 0 )                      return false;
+
+      buffer += done;
+      size   -= done;
+   }
+
+   return true;
+
+} // FUNCTION : write_all
+
+
+static bool read_all( const int fd, char *buffer, size_t size )
+{
+
+   while ( size > 0 )
+   {
+      const ssize_t done = read( fd, buffer, size );
+
+      if ( done < 0  &&  errno == EINTR )   continue;
+      if ( done <= 0 )                      return false;
+
+      buffer += done;
+      size   -= done;
+   }
+
+   return true;
+
+} // FUNCTION : read_all
+
+
+
+//-------------------------------------------------------------------------------------------------------
+// Function    :  run_worker
+// Description :  Apply "func" to items[worker], items[worker+num_workers], ... in a forked worker, and send
+//                the pickled tuple ( succeeded, results or traceback ) to the parent
+//
+// Note        :  1. Never returns
+//                2. Terminated by _exit() so that neither atexit handlers nor MPI_Finalize() are executed
+//                3. Set "g_param_libyt.forked_worker" so that the native routines run without OpenMP and
+//                   libyt.submit_output() executes the tasks immediately
+//
+// Parameter   :  py_func     : Callable
+//                py_items    : List of all items
+//                worker      : Index of this worker
+//                num_workers : Number of workers
+//                fd          : Write end of the pipe to the parent
+//-------------------------------------------------------------------------------------------------------
+static void run_worker( PyObject *py_func, PyObject *py_items, const int worker, const int num_workers, const int fd )
+{
+
+   PyOS_AfterFork();
+
+   g_param_libyt.forked_worker = true;
+
+   const Py_ssize_t num_items  = PyList_GET_SIZE( py_items );
+   PyObject        *py_results = PyList_New( 0 );
+   PyObject        *py_message = NULL;
+
+   for (Py_ssize_t t=worker; t<num_items  &&  py_results != NULL; t+=num_workers)
+   {
+      PyObject *py_result = PyObject_CallFunctionObjArgs( py_func, PyList_GET_ITEM( py_items, t ), NULL );
+
+      if ( py_result == NULL )   Py_CLEAR( py_results );
+      else
+      {
+         PyList_Append( py_results, py_result );
+         Py_DECREF( py_result );
+      }
+   }
+
+   if ( py_results != NULL )
+   {
+      py_message = Py_BuildValue( "(ON)", Py_True, py_results );
+   }
+   else
+   {
+//    format the exception raised by "func"
+      PyObject *py_type, *py_value, *py_tb;
+      PyErr_Fetch( &py_type, &py_value, &py_tb );
+      PyErr_NormalizeException( &py_type, &py_value, &py_tb );
+
+      PyObject *py_traceback = PyImport_ImportModule( "traceback" );
+      PyObject *py_lines     = ( py_traceback == NULL ) ? NULL :
+                               PyObject_CallMethod( py_traceback, (char*)"format_exception", (char*)"OOO",
+                                                    py_type, py_value, ( py_tb != NULL ) ? py_tb : Py_None );
+      PyObject *py_empty     = PyString_FromString( "" );
+      PyObject *py_text      = ( py_lines == NULL ) ? NULL : _PyString_Join( py_empty, py_lines );
+
+      py_message = Py_BuildValue( "(OO)", Py_False, ( py_text != NULL ) ? py_text : py_value );
+
+      Py_XDECREF( py_text );
+      Py_XDECREF( py_empty );
+      Py_XDECREF( py_lines );
+      Py_XDECREF( py_traceback );
+      Py_XDECREF( py_type );
+      Py_XDECREF( py_value );
+      Py_XDECREF( py_tb );
+   }
+
+
+// send the pickled message prefixed by its size
+   PyObject *py_pickle = PyImport_ImportModule( "cPickle" );
+   PyObject *py_data   = ( py_pickle == NULL  ||  py_message == NULL ) ? NULL :
+                         PyObject_CallMethod( py_pickle, (char*)"dumps", (char*)"Oi", py_message, 2 );
+
+   if ( py_data == NULL )
+   {
+      PyErr_Clear();
+      Py_XDECREF( py_message );
+      py_message = Py_BuildValue( "(Os)", Py_False, "results cannot be pickled" );
+      py_data    = ( py_pickle == NULL ) ? NULL :
+                   PyObject_CallMethod( py_pickle, (char*)"dumps", (char*)"Oi", py_message, 2 );
+   }
+
+   int exit_code = 1;
+
+   if ( py_data != NULL )
+   {
+      const unsigned long size = PyString_GET_SIZE( py_data );
+
+      if ( write_all( fd, (const char*)&size, sizeof(size) )  &&  write_all( fd, PyString_AS_STRING( py_data ), size ) )
+         exit_code = 0;
+   }
+
+   close( fd );
+   fflush( stdout );
+   fflush( stderr );
+
+   _exit( exit_code );
+
+} // FUNCTION : run_worker
+
+
+
+//-------------------------------------------------------------------------------------------------------
+// Function    :  parallel_map
+// Description :  Method "libyt.parallel_map( func, items, processes=0 )" returning [ func(item) for item
+//                in items ] computed by forked worker processes
+//
+// Note        :  1. Workers are forked at each call, after all grids have been committed, so they read
+//                   libyt.grid_data and all other Python objects of this rank through copy-on-write pages
+//                   without copying the simulation data
+//                   ==> Changes made by "func" (e.g., to global variables or libyt.grid_data) are lost
+//                2. Items are distributed cyclically (worker w processes items[w::processes]) and the
+//                   results, which must be picklable, are returned in the order of "items"
+//                3. "processes" defaults to "g_param_libyt.parallel_workers", or the number of cores this
+//                   process may run on if it is 0
+//                   ==> Run serially without forking if there is only one worker
+//                4. Workers must not call MPI, since they share the communicator of this rank
+//                5. Raise RuntimeError with the traceback of the first failed worker
+//                6. Release the GIL when waiting for the workers
+//                7. Wait for the tasks of the output workers and the native calls in flight before forking,
+//                   so that the workers do not inherit locks held by other threads
+//                   ==> Cannot be called by a libyt.submit_output() task
+//                   ==> Native routines run without OpenMP in the workers (see run_worker())
+//
+// Parameter   :  self   : Not used
+//                args   : See above
+//                kwargs : See above
+//
+// Return      :  List of the results or NULL on error
+//-------------------------------------------------------------------------------------------------------
+PyObject *parallel_map( PyObject *self, PyObject *args, PyObject *kwargs )
+{
+
+   static const char *kwlist[] = { "func", "items", "processes", NULL };
+
+   PyObject *py_func, *py_input;
+   int       num_workers = g_param_libyt.parallel_workers;
+
+   if ( !PyArg_ParseTupleAndKeywords( args, kwargs, "OO|i", (char**)kwlist, &py_func, &py_input, &num_workers ) )
+      return NULL;
+
+   if ( !PyCallable_Check( py_func ) )
+   {
+      PyErr_SetString( PyExc_TypeError, "func must be callable" );
+      return NULL;
+   }
+
+   if ( output_pool_is_worker() )
+   {
+      PyErr_SetString( PyExc_RuntimeError, "parallel_map() cannot be called by a libyt.submit_output() task" );
+      return NULL;
+   }
+
+   PyObject *py_items = PySequence_List( py_input );
+
+   if ( py_items == NULL )   return NULL;
+
+   const Py_ssize_t num_items = PyList_GET_SIZE( py_items );
+
+   if ( num_workers <= 0 )
+   {
+      cpu_set_t cpu_set;
+      num_workers = ( sched_getaffinity( 0, sizeof(cpu_set), &cpu_set ) == 0 ) ? CPU_COUNT( &cpu_set ) : 1;
+   }
+
+   if ( num_workers > num_items )   num_workers = (int)num_items;
+
+
+// run serially
+   if ( num_workers <= 1 )
+   {
+      PyObject *py_results = PyList_New( num_items );
+
+      for (Py_ssize_t t=0; t<num_items; t++)
+      {
+         PyObject *py_result = PyObject_CallFunctionObjArgs( py_func, PyList_GET_ITEM( py_items, t ), NULL );
+
+         if ( py_result == NULL )
+         {
+            Py_DECREF( py_results );
+            Py_DECREF( py_items );
+            return NULL;
+         }
+
+         PyList_SET_ITEM( py_results, t, py_result );
+      }
+
+      Py_DECREF( py_items );
+      return py_results;
+   }
+
+
+// quiesce the other threads of this rank so that no lock is held when forking
+// ==> no new task or native call can start since this thread holds the GIL
+   Py_BEGIN_ALLOW_THREADS
+   output_pool_wait();
+   Py_END_ALLOW_THREADS
+
+   native_call_drain();
+
+
+// fork all workers
+   const double start = get_wall_time();
+   pid_t       *pid   = new pid_t [num_workers];
+   int         *fd    = new int   [num_workers];
+   int          num_forked;
+
+   fflush( stdout );
+   fflush( stderr );
+
+   for (num_forked=0; num_forked<num_workers; num_forked++)
+   {
+      int pipe_fd[2];
+
+      if ( pipe( pipe_fd ) != 0 )   break;
+
+      pid[num_forked] = fork();
+
+      if ( pid[num_forked] == 0 )
+      {
+         for (int w=0; w<num_forked; w++)   close( fd[w] );
+         close( pipe_fd[0] );
+
+         run_worker( py_func, py_items, num_forked, num_workers, pipe_fd[1] );
+      }
+
+      close( pipe_fd[1] );
+
+      if ( pid[num_forked] < 0 )
+      {
+         close( pipe_fd[0] );
+         break;
+      }
+
+      fd[num_forked] = pipe_fd[0];
+   }
+
+
+// receive the pickled results of each worker
+   char          **data     = new char*         [num_workers];
+   unsigned long  *size     = new unsigned long [num_workers];
+   bool            received = ( num_forked == num_workers );
+
+   for (int w=0; w<num_forked; w++)   data[w] = NULL;
+
+   Py_BEGIN_ALLOW_THREADS
+
+   for (int w=0; w<num_forked; w++)
+   {
+      if ( received  &&  read_all( fd[w], (char*)&size[w], sizeof(size[w]) ) )
+      {
+         data[w] = new char [ size[w] ];
+         if ( !read_all( fd[w], data[w], size[w] ) )   received = false;
+      }
+      else
+      {
+         received = false;
+         kill( pid[w], SIGKILL );
+      }
+
+      close( fd[w] );
+   }
+
+   for (int w=0; w<num_forked; w++)   waitpid( pid[w], NULL, 0 );
+
+   Py_END_ALLOW_THREADS
+
+
+// unpickle the results and restore the order of "items"
+   PyObject *py_results = NULL;
+
+   if ( !received )
+      PyErr_Format( PyExc_RuntimeError, "parallel_map() lost %s worker process",
+                    ( num_forked == num_workers ) ? "a" : "the fork of a" );
+   else
+   {
+      PyObject *py_pickle = PyImport_ImportModule( "cPickle" );
+
+      py_results = ( py_pickle == NULL ) ? NULL : PyList_New( num_items );
+
+      for (int w=0; w<num_workers  &&  py_results != NULL; w++)
+      {
+         PyObject *py_message = PyObject_CallMethod( py_pickle, (char*)"loads", (char*)"s#", data[w], (int)size[w] );
+         PyObject *py_payload;
+         PyObject *py_succeeded;
+
+         if ( py_message == NULL  ||  !PyArg_ParseTuple( py_message, "OO", &py_succeeded, &py_payload ) )
+            Py_CLEAR( py_results );
+
+         else if ( py_succeeded != Py_True )
+         {
+            PyObject *py_text = PyObject_Str( py_payload );
+            PyErr_Format( PyExc_RuntimeError, "parallel_map() worker %d failed:\n%s", w,
+                          ( py_text != NULL ) ? PyString_AsString( py_text ) : "" );
+            Py_XDECREF( py_text );
+            Py_CLEAR( py_results );
+         }
+
+         else
+         {
+            for (Py_ssize_t t=w, r=0; t<num_items; t+=num_workers, r++)
+            {
+               PyObject *py_result = PyList_GET_ITEM( py_payload, r );
+               Py_INCREF( py_result );
+               PyList_SET_ITEM( py_results, t, py_result );
+            }
+         }
+
+         Py_XDECREF( py_message );
+      }
+
+      Py_XDECREF( py_pickle );
+   }
+
+   for (int w=0; w<num_forked; w++)   delete [] data[w];
+   delete [] data;
+   delete [] size;
+   delete [] pid;
+   delete [] fd;
+   Py_DECREF( py_items );
+
+   if ( py_results != NULL )
+      log_debug( "Mapping %ld items on %d worker processes ... done (%.3f s)\n", (long)num_items, num_workers,
+                 get_wall_time() - start );
+
+   return py_results;
+
+} // FUNCTION : parallel_map
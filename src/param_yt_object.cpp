@@ -0,0 +1,365 @@
+#include "yt_combo.h"
+#include <stddef.h>
+#include <string.h>
+
+
+// all parameters exposed by libyt.param_yt
+// ==> values are read from "g_param_yt" on access so that yt_set_parameter() only needs to copy the structure
+enum param_kind { PARAM_STRING, PARAM_DOUBLE, PARAM_INT, PARAM_LONG, PARAM_DOUBLE3, PARAM_INT3 };
+
+struct param_entry
+{
+   const char *key;
+   param_kind  kind;
+   size_t      offset;    // offset of the data member in yt_param_yt
+};
+
+#define ENTRY( KEY, KIND )   { #KEY, KIND, offsetof( yt_param_yt, KEY ) }
+
+static const param_entry Param_Table[] =
+{
+   ENTRY( frontend,                PARAM_STRING  ),
+   ENTRY( fig_basename,            PARAM_STRING  ),
+   ENTRY( current_time,            PARAM_DOUBLE  ),
+   ENTRY( current_redshift,        PARAM_DOUBLE  ),
+   ENTRY( omega_lambda,            PARAM_DOUBLE  ),
+   ENTRY( omega_matter,            PARAM_DOUBLE  ),
+   ENTRY( hubble_constant,         PARAM_DOUBLE  ),
+   ENTRY( length_unit,             PARAM_DOUBLE  ),
+   ENTRY( mass_unit,               PARAM_DOUBLE  ),
+   ENTRY( time_unit,               PARAM_DOUBLE  ),
+   ENTRY( cosmological_simulation, PARAM_INT     ),
+   ENTRY( dimensionality,          PARAM_INT     ),
+   ENTRY( refine_by,               PARAM_INT     ),
+   ENTRY( num_grids,               PARAM_LONG    ),
+   ENTRY( domain_left_edge,        PARAM_DOUBLE3 ),
+   ENTRY( domain_right_edge,       PARAM_DOUBLE3 ),
+   ENTRY( periodicity,             PARAM_INT3    ),
+   ENTRY( domain_dimensions,       PARAM_INT3    ),
+};
+
+#undef ENTRY
+
+static const int NParam = sizeof(Param_Table) / sizeof(Param_Table[0]);
+
+
+// Python object of libyt.param_yt ==> it has no state other than "g_param_yt"
+struct param_yt_object
+{
+   PyObject_HEAD
+};
+
+static PyTypeObject ParamYT_Type;
+
+static const param_entry *find_param( PyObject *key );
+static PyObject *get_value( const param_entry *entry );
+static PyObject *get_keys( const bool values );
+
+
+
+
+//-------------------------------------------------------------------------------------------------------
+// Function    :  find_param / get_value
+// Description :  Look up a parameter by its key, and convert its current value in "g_param_yt" to Python
+//
+// Note        :  1. Parameters are unavailable (i.e., find_param() returns NULL) when yt_set_parameter()
+//                   has not been called in this step
+//                2. Vectors are returned as 3-element tuples copied from "g_param_yt"
+//                   ==> They stay valid after yt_inline() returns (e.g., in a dataset used by an output
+//                       worker or by a generator resumed at a later step), while "g_param_yt" is reset
+//                       at the end of each step
+//-------------------------------------------------------------------------------------------------------
+static const param_entry *find_param( PyObject *key )
+{
+
+   if ( !g_param_libyt.param_yt_set  ||  !PyString_Check( key ) )   return NULL;
+
+   const char *name = PyString_AsString( key );
+
+   for (int p=0; p<NParam; p++)
+      if ( strcmp( name, Param_Table[p].key ) == 0 )   return Param_Table + p;
+
+   return NULL;
+
+} // FUNCTION : find_param
+
+
+static PyObject *get_value( const param_entry *entry )
+{
+
+   char *ptr = (char*)&g_param_yt + entry->offset;
+
+   switch ( entry->kind )
+   {
+      case PARAM_STRING :
+      {
+         const char *string = *(const char**)ptr;
+         if ( string == NULL )   Py_RETURN_NONE;
+         return PyString_FromString( string );
+      }
+
+      case PARAM_DOUBLE :   return PyFloat_FromDouble( *(double*)ptr );
+      case PARAM_INT    :   return PyInt_FromLong    ( *(int   *)ptr );
+      case PARAM_LONG   :   return PyLong_FromLong   ( *(long  *)ptr );
+
+      case PARAM_DOUBLE3 :
+      case PARAM_INT3 :
+      {
+         PyObject *py_tuple = PyTuple_New( 3 );
+
+         for (int d=0; d<3; d++)
+            PyTuple_SET_ITEM( py_tuple, d, ( entry->kind == PARAM_DOUBLE3 ) ? PyFloat_FromDouble( ((double*)ptr)[d] )
+                                                                             : PyLong_FromLong  ( ((int   *)ptr)[d] ) );
+         return py_tuple;
+      }
+   }
+
+   return NULL;
+
+} // FUNCTION : get_value
+
+
+
+//-------------------------------------------------------------------------------------------------------
+// Function    :  param_yt_subscript / param_yt_getattro / param_yt_contains / param_yt_length
+// Description :  Mapping, attribute, and sequence protocols of libyt.param_yt
+//
+// Note        :  1. param_yt["key"] and param_yt.key are equivalent
+//                2. Raise KeyError/AttributeError for unknown keys, or before yt_set_parameter() is called
+//-------------------------------------------------------------------------------------------------------
+static PyObject *param_yt_subscript( PyObject *self, PyObject *key )
+{
+
+   const param_entry *entry = find_param( key );
+
+   if ( entry == NULL )
+   {
+      PyErr_SetObject( PyExc_KeyError, key );
+      return NULL;
+   }
+
+   return get_value( entry );
+
+} // FUNCTION : param_yt_subscript
+
+
+static PyObject *param_yt_getattro( PyObject *self, PyObject *name )
+{
+
+   const param_entry *entry = find_param( name );
+
+   if ( entry != NULL )   return get_value( entry );
+
+   return PyObject_GenericGetAttr( self, name );
+
+} // FUNCTION : param_yt_getattro
+
+
+static int param_yt_contains( PyObject *self, PyObject *key )
+{
+
+   return ( find_param( key ) != NULL );
+
+} // FUNCTION : param_yt_contains
+
+
+static Py_ssize_t param_yt_length( PyObject *self )
+{
+
+   return ( g_param_libyt.param_yt_set ) ? NParam : 0;
+
+} // FUNCTION : param_yt_length
+
+
+
+//-------------------------------------------------------------------------------------------------------
+// Function    :  get_keys / param_yt_keys / param_yt_values / param_yt_items / param_yt_get / param_yt_iter
+//                param_yt_repr
+// Description :  dict-compatible methods of libyt.param_yt
+//-------------------------------------------------------------------------------------------------------
+static PyObject *get_keys( const bool values )
+{
+
+   const int n    = ( g_param_libyt.param_yt_set ) ? NParam : 0;
+   PyObject *list = PyList_New( n );
+
+   for (int p=0; p<n  &&  list!=NULL; p++)
+   {
+      PyObject *item;
+
+      if ( values )
+      {
+         PyObject *value = get_value( Param_Table + p );
+         item = ( value == NULL ) ? NULL : Py_BuildValue( "(sN)", Param_Table[p].key, value );
+      }
+      else
+         item = PyString_FromString( Param_Table[p].key );
+
+      if ( item == NULL )
+      {
+         Py_DECREF( list );
+         return NULL;
+      }
+
+      PyList_SET_ITEM( list, p, item );
+   }
+
+   return list;
+
+} // FUNCTION : get_keys
+
+
+static PyObject *param_yt_keys( PyObject *self, PyObject *args )
+{
+
+   return get_keys( false );
+
+} // FUNCTION : param_yt_keys
+
+
+static PyObject *param_yt_items( PyObject *self, PyObject *args )
+{
+
+   return get_keys( true );
+
+} // FUNCTION : param_yt_items
+
+
+static PyObject *param_yt_values( PyObject *self, PyObject *args )
+{
+
+   const int n    = ( g_param_libyt.param_yt_set ) ? NParam : 0;
+   PyObject *list = PyList_New( n );
+
+   for (int p=0; p<n  &&  list!=NULL; p++)
+   {
+      PyObject *value = get_value( Param_Table + p );
+
+      if ( value == NULL )
+      {
+         Py_DECREF( list );
+         return NULL;
+      }
+
+      PyList_SET_ITEM( list, p, value );
+   }
+
+   return list;
+
+} // FUNCTION : param_yt_values
+
+
+static PyObject *param_yt_get( PyObject *self, PyObject *args )
+{
+
+   PyObject *key, *fallback = Py_None;
+
+   if ( !PyArg_ParseTuple( args, "O|O", &key, &fallback ) )   return NULL;
+
+   const param_entry *entry = find_param( key );
+
+   if ( entry != NULL )   return get_value( entry );
+
+   Py_INCREF( fallback );
+   return fallback;
+
+} // FUNCTION : param_yt_get
+
+
+static PyObject *param_yt_has_key( PyObject *self, PyObject *key )
+{
+
+   return PyBool_FromLong( find_param( key ) != NULL );
+
+} // FUNCTION : param_yt_has_key
+
+
+static PyObject *param_yt_iter( PyObject *self )
+{
+
+   PyObject *keys = get_keys( false );
+   if ( keys == NULL )   return NULL;
+
+   PyObject *iter = PyObject_GetIter( keys );
+   Py_DECREF( keys );
+
+   return iter;
+
+} // FUNCTION : param_yt_iter
+
+
+static PyObject *param_yt_repr( PyObject *self )
+{
+
+   PyObject *items = get_keys( true );
+   if ( items == NULL )   return NULL;
+
+   PyObject *dict = PyDict_New();
+   for (Py_ssize_t i=0; i<PyList_GET_SIZE( items ); i++)
+   {
+      PyObject *item = PyList_GET_ITEM( items, i );
+      PyDict_SetItem( dict, PyTuple_GET_ITEM( item, 0 ), PyTuple_GET_ITEM( item, 1 ) );
+   }
+   Py_DECREF( items );
+
+   PyObject *repr = PyObject_Repr( dict );
+   Py_DECREF( dict );
+
+   return repr;
+
+} // FUNCTION : param_yt_repr
+
+
+static PyMethodDef ParamYT_Methods[] =
+{
+   { "keys",    param_yt_keys,    METH_NOARGS,  "List of all keys" },
+   { "values",  param_yt_values,  METH_NOARGS,  "List of all values" },
+   { "items",   param_yt_items,   METH_NOARGS,  "List of all (key, value) pairs" },
+   { "get",     param_yt_get,     METH_VARARGS, "Value of a key, or the default value if the key is not found" },
+   { "has_key", param_yt_has_key, METH_O,       "Whether a key is found" },
+   { NULL, NULL, 0, NULL } // sentinel
+};
+
+static PyMappingMethods  ParamYT_Mapping;
+static PySequenceMethods ParamYT_Sequence;
+
+
+
+//-------------------------------------------------------------------------------------------------------
+// Function    :  new_param_yt_object
+// Description :  Create the object of libyt.param_yt
+//
+// Note        :  1. Called by init_libyt_module()
+//                2. libyt.param_yt behaves like a read-only dictionary of "g_param_yt" and also supports
+//                   attribute access (e.g., libyt.param_yt.current_time)
+//                   ==> yt_set_parameter() only copies the input structure to "g_param_yt" instead of
+//                       creating Python objects for all parameters at every step
+//
+// Parameter   :  None
+//
+// Return      :  New reference of libyt.param_yt or NULL on error
+//-------------------------------------------------------------------------------------------------------
+PyObject *new_param_yt_object()
+{
+
+   ParamYT_Mapping.mp_length        = param_yt_length;
+   ParamYT_Mapping.mp_subscript     = param_yt_subscript;
+   ParamYT_Sequence.sq_contains     = param_yt_contains;
+
+   ParamYT_Type.tp_name             = "libyt.ParamYT";
+   ParamYT_Type.tp_basicsize        = sizeof(param_yt_object);
+   ParamYT_Type.tp_flags            = Py_TPFLAGS_DEFAULT;
+   ParamYT_Type.tp_doc              = "YT-specific parameters set by yt_set_parameter()";
+   ParamYT_Type.tp_as_mapping       = &ParamYT_Mapping;
+   ParamYT_Type.tp_as_sequence      = &ParamYT_Sequence;
+   ParamYT_Type.tp_getattro         = param_yt_getattro;
+   ParamYT_Type.tp_iter             = param_yt_iter;
+   ParamYT_Type.tp_repr             = param_yt_repr;
+   ParamYT_Type.tp_methods          = ParamYT_Methods;
+   ParamYT_Type.tp_new              = PyType_GenericNew;
+
+   if ( PyType_Ready( &ParamYT_Type ) != 0 )   return NULL;
+
+   return PyObject_CallObject( (PyObject*)&ParamYT_Type, NULL );
+
+} // FUNCTION : new_param_yt_object
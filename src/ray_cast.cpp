@@ -0,0 +1,355 @@
+#define NO_PYTHON
+#include "yt_combo.h"
+#undef NO_PYTHON
+#include <math.h>
+
+
+
+
+// number of pixels along each side of an image tile processed by one thread
+static const int TileSize = 16;
+
+// stop marching a ray once its transmittance drops below this value
+static const double MinTransmittance = 1.0e-6;
+
+static void cast_ray( const yt_render *render, const double origin[3], const double dir[3], const double t_end,
+                      void **data, const yt_ftype *ftype, void **weight, const yt_ftype *wtype, double *pixel );
+static inline bool inside_grid( const yt_grid *grid, const double pos[3] );
+static inline bool inside_child( const long grid_id, const double pos[3] );
+
+
+
+
+//-------------------------------------------------------------------------------------------------------
+// Function    :  ray_cast
+// Description :  Render an off-axis image by casting one ray per pixel through the finest grids
+//
+// Note        :  1. Rays start at center + 0.5*width[2]*normal and travel along -normal for a distance of
+//                   width[2]. Pixel (j,i) is at center + (i+0.5-nx/2)*width[0]/nx*east
+//                   + (j+0.5-ny/2)*width[1]/ny*north, with east = north x normal.
+//                2. Each ray is marched cell by cell through the finest grid containing it (see
+//                   grid_index_find()), and leaves a grid at its faces or when entering one of its children
+//                   ==> Child grids are assumed to be aligned with the cells of their parents
+//                3. Field data are fetched once per grid overlapping the bounding box of the rendered volume
+//                4. Image tiles are processed in parallel with OpenMP if libyt is compiled with -DOPENMP
+//                5. Does not touch any Python object ==> can be called without holding the GIL
+//
+// Parameter   :  render : Structure describing the image
+//                image  : Output image [ny][nx] for line integrals or [ny][nx][4] for transfer functions
+//
+// Return      :  YT_SUCCESS or YT_FAIL
+//-------------------------------------------------------------------------------------------------------
+int ray_cast( const yt_render *render, double *image )
+{
+
+   if ( g_grids == NULL )   YT_ABORT( "No grid has been staged!\n" );
+
+   if ( !render->validate() )   YT_ABORT( "Validating the rendering parameters ... failed!\n" );
+
+   if ( grid_index_build() != YT_SUCCESS )   YT_ABORT( "Building the spatial index ... failed!\n" );
+
+
+// orthonormal basis of the image
+   double normal[3], north[3], east[3];
+   double norm = sqrt( render->normal[0]*render->normal[0] + render->normal[1]*render->normal[1] +
+                       render->normal[2]*render->normal[2] );
+
+   if ( norm == 0.0 )   YT_ABORT( "\"%s\" is a zero vector!\n", "normal" );
+
+   for (int d=0; d<3; d++)   normal[d] = render->normal[d] / norm;
+
+   const double proj = render->north[0]*normal[0] + render->north[1]*normal[1] + render->north[2]*normal[2];
+
+   for (int d=0; d<3; d++)   north[d] = render->north[d] - proj*normal[d];
+
+   norm = sqrt( north[0]*north[0] + north[1]*north[1] + north[2]*north[2] );
+
+   if ( norm < 1.0e-12 )   YT_ABORT( "\"%s\" is parallel to \"%s\"!\n", "north", "normal" );
+
+   for (int d=0; d<3; d++)   north[d] /= norm;
+
+   east[0] = north[1]*normal[2] - north[2]*normal[1];
+   east[1] = north[2]*normal[0] - north[0]*normal[2];
+   east[2] = north[0]*normal[1] - north[1]*normal[0];
+
+
+// fetch the field data of all grids overlapping the bounding box of the rendered volume
+   const long num_grids = g_param_yt.num_grids;
+   double     box_left[3], box_right[3];
+
+   for (int d=0; d<3; d++)
+   {
+      const double half = 0.5*( fabs( east[d] )*render->width[0] + fabs( north[d] )*render->width[1] +
+                                 fabs( normal[d] )*render->width[2] );
+
+      box_left [d] = render->center[d] - half;
+      box_right[d] = render->center[d] + half;
+   }
+
+   long     *grid_ids   = new long     [num_grids];
+   void    **data       = new void*    [num_grids];
+   void    **weight     = new void*    [num_grids];
+   yt_ftype *ftype      = new yt_ftype [num_grids];
+   yt_ftype *wtype      = new yt_ftype [num_grids];
+   bool     *allocated  = new bool     [num_grids];
+   bool     *wallocated = new bool     [num_grids];
+   bool      found      = true;
+
+   for (long g=0; g<num_grids; g++)
+   {
+      data      [g] = NULL;
+      weight    [g] = NULL;
+      allocated [g] = false;
+      wallocated[g] = false;
+   }
+
+   const long num_found = grid_index_query( box_left, box_right, grid_ids );
+
+#  ifdef OPENMP
+#  pragma omp parallel for schedule( dynamic ) if ( !g_param_libyt.forked_worker )
+#  endif
+   for (long t=0; t<num_found; t++)
+   {
+      const long g = grid_ids[t];
+
+      if (  ( data[g] = get_field_data( g_grids + g, render->field, ftype + g, allocated + g ) ) == NULL  )
+         found = false;
+
+      if ( render->weight != NULL  &&
+           ( weight[g] = get_field_data( g_grids + g, render->weight, wtype + g, wallocated + g ) ) == NULL  )
+         found = false;
+   }
+
+
+// cast rays tile by tile
+   const int nx       = render->resolution[0];
+   const int ny       = render->resolution[1];
+   const int nchannel = ( render->num_tf > 0 ) ? 4 : 1;
+   const int ntile_x  = ( nx + TileSize - 1 ) / TileSize;
+   const int ntile_y  = ( ny + TileSize - 1 ) / TileSize;
+
+   if ( found )
+   {
+#     ifdef OPENMP
+#     pragma omp parallel for schedule( dynamic ) if ( !g_param_libyt.forked_worker )
+#     endif
+      for (int tile=0; tile<ntile_x*ntile_y; tile++)
+      {
+         const int j0 = ( tile / ntile_x )*TileSize;
+         const int i0 = ( tile % ntile_x )*TileSize;
+
+         for (int j=j0; j<MIN( j0+TileSize, ny ); j++)
+         for (int i=i0; i<MIN( i0+TileSize, nx ); i++)
+         {
+            const double x = ( i + 0.5 )/nx - 0.5;
+            const double y = ( j + 0.5 )/ny - 0.5;
+            double origin[3], dir[3];
+
+            for (int d=0; d<3; d++)
+            {
+               origin[d] = render->center[d] + x*render->width[0]*east[d] + y*render->width[1]*north[d]
+                         + 0.5*render->width[2]*normal[d];
+               dir   [d] = -normal[d];
+            }
+
+            cast_ray( render, origin, dir, render->width[2], data, ftype, weight, wtype,
+                      image + ( (long)j*nx + i )*nchannel );
+         }
+      }
+   }
+
+   for (long g=0; g<num_grids; g++)
+   {
+      if ( allocated [g] )   delete [] (char*)data  [g];
+      if ( wallocated[g] )   delete [] (char*)weight[g];
+   }
+
+   delete [] grid_ids;
+   delete [] data;
+   delete [] weight;
+   delete [] ftype;
+   delete [] wtype;
+   delete [] allocated;
+   delete [] wallocated;
+
+   if ( !found )   YT_ABORT( "Field \"%s\" or \"%s\" is not found in all grids!\n", render->field,
+                             ( render->weight == NULL ) ? "" : render->weight );
+
+   log_debug( "Rendering \"%s\" with %d x %d pixels through %ld grids ... done\n", render->field, nx, ny, num_found );
+
+   return YT_SUCCESS;
+
+} // FUNCTION : ray_cast
+
+
+
+//-------------------------------------------------------------------------------------------------------
+// Function    :  cast_ray
+// Description :  March a single ray cell by cell and accumulate the image of one pixel
+//
+// Note        :  1. Gaps not covered by any grid are skipped with steps of the smallest root cell size
+//
+// Parameter   :  render : Structure describing the image
+//                origin : Start point of the ray
+//                dir    : Unit direction of the ray
+//                t_end  : Length of the ray
+//                data   : Field data of each grid
+//                ftype  : Floating-point type of "data"
+//                weight : Weight field data of each grid
+//                wtype  : Floating-point type of "weight"
+//                pixel  : Pixel to be returned (1 or 4 channels)
+//
+// Return      :  pixel
+//-------------------------------------------------------------------------------------------------------
+static void cast_ray( const yt_render *render, const double origin[3], const double dir[3], const double t_end,
+                      void **data, const yt_ftype *ftype, void **weight, const yt_ftype *wtype, double *pixel )
+{
+
+// clip the ray to the simulation domain
+   double t_min = 0.0, t_max = t_end, gap = HUGE_VAL, scale = 0.0;
+
+   for (int d=0; d<3; d++)
+   {
+      const double left  = g_param_yt.domain_left_edge [d];
+      const double right = g_param_yt.domain_right_edge[d];
+
+      gap   = MIN( gap,   ( right - left )/g_param_yt.domain_dimensions[d] );
+      scale = MAX( scale, right - left );
+
+      if ( dir[d] == 0.0 )
+      {
+         if ( origin[d] < left  ||  origin[d] >= right )   t_max = -1.0;
+         continue;
+      }
+
+      const double ta = ( left  - origin[d] )/dir[d];
+      const double tb = ( right - origin[d] )/dir[d];
+
+      t_min = MAX( t_min, MIN( ta, tb ) );
+      t_max = MIN( t_max, MAX( ta, tb ) );
+   }
+
+   const double eps = 1.0e-10*scale;
+
+   double sum = 0.0, wsum = 0.0, rgb[3] = { 0.0, 0.0, 0.0 }, trans = 1.0;
+   long   g   = -1;
+
+   for (double t=t_min; t<t_max; )
+   {
+      const double pos[3] = { origin[0] + ( t + eps )*dir[0], origin[1] + ( t + eps )*dir[1],
+                              origin[2] + ( t + eps )*dir[2] };
+
+//    find the finest grid unless the ray is still in the current grid and not in its children
+      if ( g < 0  ||  !inside_grid( g_grids + g, pos )  ||  inside_child( g, pos ) )   g = grid_index_find( pos );
+
+      if ( g < 0  ||  data[g] == NULL )
+      {
+         t += gap;
+         g  = -1;
+         continue;
+      }
+
+//    cell containing the ray and the distance to its exit
+      const yt_grid *grid = g_grids + g;
+      int    idx[3];
+      double t_exit = t_max;
+
+      for (int d=0; d<3; d++)
+      {
+         const double dh = ( grid->right_edge[d] - grid->left_edge[d] ) / grid->dimensions[d];
+
+         idx[d] = MAX( 0, MIN( grid->dimensions[d]-1, (int)floor( ( pos[d] - grid->left_edge[d] )/dh ) ) );
+
+         if ( dir[d] != 0.0 )
+         {
+            const double face = grid->left_edge[d] + ( idx[d] + ( dir[d] > 0.0 ) )*dh;
+            t_exit = MIN( t_exit, ( face - origin[d] )/dir[d] );
+         }
+      }
+
+      t_exit = MAX( t_exit, t + eps );
+
+      const double dl = MIN( t_exit, t_max ) - t;
+      const long   c  = ( (long)idx[0]*grid->dimensions[1] + idx[1] )*grid->dimensions[2] + idx[2];
+      const double f  = ( ftype[g] == YT_FLOAT ) ? ( (const float*)data[g] )[c] : ( (const double*)data[g] )[c];
+
+//    line integral
+      if ( render->num_tf == 0 )
+      {
+         if ( render->weight == NULL )   sum += f*dl;
+         else
+         {
+            const double w = ( wtype[g] == YT_FLOAT ) ? ( (const float*)weight[g] )[c] : ( (const double*)weight[g] )[c];
+
+            sum  += f*w*dl;
+            wsum +=   w*dl;
+         }
+      }
+
+//    emission/absorption
+      else
+      {
+         const double v   = ( render->tf_log ) ? ( ( f > 0.0 ) ? log10( f ) : -HUGE_VAL ) : f;
+         const double x   = ( v - render->tf_bounds[0] ) / ( render->tf_bounds[1] - render->tf_bounds[0] );
+
+         if ( x >= 0.0  &&  x < 1.0 )
+         {
+            const double *rgba  = render->tf_rgba + 4*(int)( x*render->num_tf );
+            const double  alpha = 1.0 - exp( -rgba[3]*dl );
+
+            for (int ch=0; ch<3; ch++)   rgb[ch] += trans*rgba[ch]*dl;
+            trans *= 1.0 - alpha;
+
+            if ( trans < MinTransmittance )   break;
+         }
+      }
+
+      t = t_exit;
+   }
+
+
+// store the results
+   if ( render->num_tf == 0 )
+      pixel[0] = ( render->weight == NULL ) ? sum : ( ( wsum != 0.0 ) ? sum/wsum : 0.0 );
+   else
+   {
+      for (int ch=0; ch<3; ch++)   pixel[ch] = rgb[ch];
+      pixel[3] = 1.0 - trans;
+   }
+
+} // FUNCTION : cast_ray
+
+
+
+//-------------------------------------------------------------------------------------------------------
+// Function    :  inside_grid / inside_child
+// Description :  Check whether a point lies in a grid / in one of the child grids of a grid
+//
+// Parameter   :  grid    : Target grid
+//                grid_id : Target grid ID
+//                pos     : Target point
+//
+// Return      :  true/false
+//-------------------------------------------------------------------------------------------------------
+static inline bool inside_grid( const yt_grid *grid, const double pos[3] )
+{
+
+   return ( pos[0] >= grid->left_edge[0]  &&  pos[0] < grid->right_edge[0]  &&
+            pos[1] >= grid->left_edge[1]  &&  pos[1] < grid->right_edge[1]  &&
+            pos[2] >= grid->left_edge[2]  &&  pos[2] < grid->right_edge[2]     );
+
+} // FUNCTION : inside_grid
+
+
+static inline bool inside_child( const long grid_id, const double pos[3] )
+{
+
+   const long *children;
+   const long  num_children = grid_index_children( grid_id, &children );
+
+   for (long t=0; t<num_children; t++)
+      if ( inside_grid( g_grids + children[t], pos ) )   return true;
+
+   return false;
+
+} // FUNCTION : inside_child
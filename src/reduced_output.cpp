@@ -0,0 +1,548 @@
+#define NO_PYTHON
+#include "yt_combo.h"
+#undef NO_PYTHON
+#include <string.h>
+#include <stdint.h>
+#include <pthread.h>
+
+
+
+
+// magic strings and version of the reduced data format
+// ==> see tool/read_reduced_output.py for the corresponding reader
+static const char    DataMagic [8] = "LIBYTRD";
+static const char    IndexMagic[8] = "LIBYTRI";
+static const int32_t FormatVersion = 1;
+static const int     MaxLabelWidth = 32;
+
+
+//-------------------------------------------------------------------------------------------------------
+// Structure   :  reduced_chunk_header
+// Description :  Header of a single data chunk (i.e., a single field of a single grid)
+//
+// Note        :  1. Written to the data file right before the chunk payload so that the data file is
+//                   self-describing, and appended to the index file after the payload has been written
+//                   ==> The index file is an array of fixed-size records and can be memory-mapped directly
+//                2. All members are naturally aligned ==> sizeof(reduced_chunk_header) == 152 bytes
+//-------------------------------------------------------------------------------------------------------
+struct reduced_chunk_header
+{
+   char    magic[4];                  // "CHNK"
+   int32_t ftype;                     // YT_FLOAT or YT_DOUBLE
+   int64_t step;                      // g_param_libyt.counter
+   double  time;                      // g_param_yt.current_time
+   int64_t grid_id;
+   int32_t level;
+   int32_t downsample;
+   int32_t dimensions[3];             // after downsampling
+   int32_t padding;
+   double  left_edge[3];
+   double  right_edge[3];
+   char    field[MaxLabelWidth];
+   int64_t offset;                    // file offset of the payload in the data file
+   int64_t nbytes;                    // payload size in bytes
+};
+
+
+// queue item: a chunk waiting to be written or a control message for the I/O thread
+enum chunk_kind { CHUNK_DATA=0, CHUNK_FLUSH=1, CHUNK_STOP=2 };
+
+struct reduced_chunk
+{
+   chunk_kind            kind;
+   reduced_chunk_header  header;
+   void                 *data;
+};
+
+
+// internal states of the output stage
+// ==> the queue is a bounded circular buffer protected by "Queue_Mutex"
+static FILE           *Data_File     = NULL;
+static FILE           *Index_File    = NULL;
+static int64_t         Data_Offset   = 0;
+static char          **Field_Labels  = NULL;
+static reduced_chunk **Queue         = NULL;
+static int             Queue_Head    = 0;
+static int             Queue_Count   = 0;
+static bool            IO_Failed     = false;
+static long            Last_Warning  = -1;
+static pthread_t       IO_Thread;
+static pthread_mutex_t Queue_Mutex   = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t  Queue_NotFull = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t  Queue_NotEmpty= PTHREAD_COND_INITIALIZER;
+
+static void *io_thread_main( void *arg );
+static int   push_chunk( reduced_chunk *chunk );
+static void  free_resources();
+template <typename T>
+static void  downsample_field( const T *in, T *out, const int in_dim[3], const int out_dim[3], const int factor );
+
+
+
+
+//-------------------------------------------------------------------------------------------------------
+// Function    :  reduced_output_init
+// Description :  Open the output files and launch the background I/O thread
+//
+// Note        :  1. Called by yt_set_reduced_output()
+//                2. Input "output" has been copied to "g_reduced_output" already
+//                   ==> Field labels are copied again here since "g_reduced_output.field_labels" points to
+//                       user-provided memory that may be free'd after yt_set_reduced_output() returns
+//                3. Everything acquired here is released again on failure (see free_resources())
+//
+// Parameter   :  None
+//
+// Return      :  YT_SUCCESS or YT_FAIL
+//-------------------------------------------------------------------------------------------------------
+int reduced_output_init()
+{
+
+// copy field labels
+   if ( g_reduced_output.num_fields > 0 )
+   {
+//    initialize to NULL so that a partially filled table can be freed
+      Field_Labels = new char* [ g_reduced_output.num_fields ]();
+
+      for (int v=0; v<g_reduced_output.num_fields; v++)
+      {
+         if ( strlen( g_reduced_output.field_labels[v] ) >= (size_t)MaxLabelWidth )
+         {
+            free_resources();
+            YT_ABORT( "Field label \"%s\" exceeds the maximum width (%d)!\n",
+                      g_reduced_output.field_labels[v], MaxLabelWidth-1 );
+         }
+
+         Field_Labels[v] = new char [MaxLabelWidth];
+         strcpy( Field_Labels[v], g_reduced_output.field_labels[v] );
+      }
+   }
+
+
+// open files and write file headers
+   const int FileNameWidth = strlen( g_reduced_output.basename ) + 6;   // 6 = ".ldat" + '\0'
+   char *FileName = (char*) malloc( FileNameWidth*sizeof(char) );
+
+   sprintf( FileName, "%s.ldat", g_reduced_output.basename );
+   Data_File = fopen( FileName, "wb" );
+
+   sprintf( FileName, "%s.lidx", g_reduced_output.basename );
+   Index_File = ( Data_File == NULL ) ? NULL : fopen( FileName, "wb" );
+
+   free( FileName );
+
+   if ( Data_File == NULL  ||  Index_File == NULL )
+   {
+      free_resources();
+      YT_ABORT( "Opening the reduced %s file \"%s.%s\" ... failed!\n", ( Data_File == NULL ) ? "data" : "index",
+                g_reduced_output.basename, ( Data_File == NULL ) ? "ldat" : "lidx" );
+   }
+
+   const int32_t RecordSize = sizeof(reduced_chunk_header);
+
+   fwrite( DataMagic,      sizeof(char),    8, Data_File  );
+   fwrite( &FormatVersion, sizeof(int32_t), 1, Data_File  );
+   fwrite( &RecordSize,    sizeof(int32_t), 1, Data_File  );
+
+   fwrite( IndexMagic,     sizeof(char),    8, Index_File );
+   fwrite( &FormatVersion, sizeof(int32_t), 1, Index_File );
+   fwrite( &RecordSize,    sizeof(int32_t), 1, Index_File );
+
+   Data_Offset = 8 + 2*sizeof(int32_t);
+
+
+// allocate the queue and launch the I/O thread
+   Queue       = new reduced_chunk* [ g_reduced_output.queue_size ];
+   Queue_Head  = 0;
+   Queue_Count = 0;
+   IO_Failed   = false;
+
+   if ( pthread_create( &IO_Thread, NULL, io_thread_main, NULL ) != 0 )
+   {
+      free_resources();
+      YT_ABORT( "Launching the I/O thread of the reduced output ... failed!\n" );
+   }
+
+   log_debug( "Launching the I/O thread of the reduced output ... done\n" );
+
+
+// switch to the private copy of field labels only after everything succeeds
+   if ( Field_Labels != NULL )   g_reduced_output.field_labels = (const char**)Field_Labels;
+
+
+   return YT_SUCCESS;
+
+} // FUNCTION : reduced_output_init
+
+
+
+//-------------------------------------------------------------------------------------------------------
+// Function    :  reduced_output_add_grid
+// Description :  Copy the selected fields of a single grid into data chunks and push them to the I/O queue
+//
+// Note        :  1. Called by yt_add_grid()
+//                2. Grids are selected by the output interval, AMR level, and region
+//                   ==> Only called at analysis steps, so data are dumped at the analysis steps whose
+//                       step number is a multiple of the interval
+//                3. Data are copied (and downsampled) here so that users are free to modify the field data
+//                   right after yt_inline() returns, even if the chunks have not been written yet
+//                4. Block if the queue is full so that memory consumption is bounded by "queue_size"
+//
+// Parameter   :  grid : Target grid
+//
+// Return      :  YT_SUCCESS or YT_FAIL
+//-------------------------------------------------------------------------------------------------------
+int reduced_output_add_grid( const yt_grid *grid )
+{
+
+// check if this grid should be dumped
+   if ( g_param_libyt.counter % g_reduced_output.interval != 0 )   return YT_SUCCESS;
+
+   if ( grid->level < g_reduced_output.min_level )   return YT_SUCCESS;
+   if ( g_reduced_output.max_level >= 0  &&  grid->level > g_reduced_output.max_level )   return YT_SUCCESS;
+
+   for (int d=0; d<3; d++)
+   {
+      if ( g_reduced_output.region_left_edge[d] == FLT_UNDEFINED )   continue;
+
+      if ( grid->right_edge[d] <= g_reduced_output.region_left_edge [d]  ||
+           grid->left_edge [d] >= g_reduced_output.region_right_edge[d]    )   return YT_SUCCESS;
+   }
+
+
+// dimensions after downsampling
+   const int factor = g_reduced_output.downsample;
+   int  out_dim[3];
+   long out_cells = 1;
+
+   for (int d=0; d<3; d++)
+   {
+      out_dim[d] = ( grid->dimensions[d] + factor - 1 ) / factor;
+      out_cells *= out_dim[d];
+   }
+
+   const size_t type_size = ( grid->field_ftype == YT_FLOAT ) ? sizeof(float) : sizeof(double);
+
+
+// create one chunk for each selected field
+   for (int v=0; v<grid->num_fields; v++)
+   {
+      if ( g_reduced_output.num_fields > 0 )
+      {
+         bool selected = false;
+         for (int t=0; t<g_reduced_output.num_fields; t++)
+         {
+            if ( strcmp( grid->field_labels[v], g_reduced_output.field_labels[t] ) == 0 )
+            {
+               selected = true;
+               break;
+            }
+         }
+
+         if ( !selected )   continue;
+      }
+
+      if ( strlen( grid->field_labels[v] ) >= (size_t)MaxLabelWidth )
+         YT_ABORT( "Field label \"%s\" of grid [%ld] exceeds the maximum width (%d)!\n",
+                   grid->field_labels[v], grid->id, MaxLabelWidth-1 );
+
+      reduced_chunk *chunk = new reduced_chunk;
+      reduced_chunk_header *header = &chunk->header;
+
+      memset( header, 0, sizeof(reduced_chunk_header) );
+      memcpy( header->magic, "CHNK", 4 );
+      header->ftype      = grid->field_ftype;
+      header->step       = g_param_libyt.counter;
+      header->time       = g_param_yt.current_time;
+      header->grid_id    = grid->id;
+      header->level      = grid->level;
+      header->downsample = factor;
+      for (int d=0; d<3; d++) {
+      header->dimensions[d] = out_dim[d];
+      header->left_edge [d] = grid->left_edge [d];
+      header->right_edge[d] = grid->right_edge[d]; }
+      strcpy( header->field, grid->field_labels[v] );
+      header->nbytes     = out_cells*type_size;
+
+      chunk->kind = CHUNK_DATA;
+      chunk->data = malloc( header->nbytes );
+
+      if ( factor == 1 )
+         memcpy( chunk->data, grid->field_data[v], header->nbytes );
+      else if ( grid->field_ftype == YT_FLOAT )
+         downsample_field( (const float *)grid->field_data[v], (float *)chunk->data, grid->dimensions, out_dim, factor );
+      else
+         downsample_field( (const double*)grid->field_data[v], (double*)chunk->data, grid->dimensions, out_dim, factor );
+
+      if ( push_chunk( chunk ) != YT_SUCCESS )
+         YT_ABORT( "Pushing grid [%ld] field \"%s\" to the reduced output queue ... failed!\n",
+                   grid->id, grid->field_labels[v] );
+   } // for (int v=0; v<grid->num_fields; v++)
+
+
+   return YT_SUCCESS;
+
+} // FUNCTION : reduced_output_add_grid
+
+
+
+//-------------------------------------------------------------------------------------------------------
+// Function    :  reduced_output_flush
+// Description :  Ask the I/O thread to flush both output files once all chunks queued so far are written
+//
+// Note        :  1. Called by yt_inline() at the end of each step so that readers always see complete steps
+//                2. Do not wait for the I/O thread
+//
+// Parameter   :  None
+//
+// Return      :  YT_SUCCESS or YT_FAIL
+//-------------------------------------------------------------------------------------------------------
+int reduced_output_flush()
+{
+
+   if ( g_param_libyt.counter % g_reduced_output.interval != 0 )   return YT_SUCCESS;
+
+   reduced_chunk *chunk = new reduced_chunk;
+   chunk->kind = CHUNK_FLUSH;
+   chunk->data = NULL;
+
+   return push_chunk( chunk );
+
+} // FUNCTION : reduced_output_flush
+
+
+
+//-------------------------------------------------------------------------------------------------------
+// Function    :  reduced_output_finalize
+// Description :  Drain the queue, stop the I/O thread, and close the output files
+//
+// Note        :  1. Called by yt_finalize()
+//
+// Parameter   :  None
+//
+// Return      :  YT_SUCCESS or YT_FAIL
+//-------------------------------------------------------------------------------------------------------
+int reduced_output_finalize()
+{
+
+   reduced_chunk *chunk = new reduced_chunk;
+   chunk->kind = CHUNK_STOP;
+   chunk->data = NULL;
+
+   push_chunk( chunk );
+
+   if ( pthread_join( IO_Thread, NULL ) != 0 )
+      YT_ABORT( "Joining the I/O thread of the reduced output ... failed!\n" );
+
+   free_resources();
+
+   log_debug( "Closing the reduced output files ... done\n" );
+
+   if ( IO_Failed )
+      YT_ABORT( "Some chunks of the reduced output were not written successfully!\n" );
+
+
+   return YT_SUCCESS;
+
+} // FUNCTION : reduced_output_finalize
+
+
+
+//-------------------------------------------------------------------------------------------------------
+// Function    :  free_resources
+// Description :  Close the output files and free the queue and the copied field labels
+//
+// Note        :  1. Called by reduced_output_finalize() after the I/O thread has stopped, and by
+//                   reduced_output_init() on failure
+//                2. Only releases what has been acquired, so it works on a partially initialized state
+//
+// Parameter   :  None
+//
+// Return      :  None
+//-------------------------------------------------------------------------------------------------------
+static void free_resources()
+{
+
+   if ( Data_File  != NULL )   fclose( Data_File  );
+   if ( Index_File != NULL )   fclose( Index_File );
+   Data_File  = NULL;
+   Index_File = NULL;
+
+   delete [] Queue;
+   Queue = NULL;
+
+   if ( Field_Labels != NULL )
+   {
+      for (int v=0; v<g_reduced_output.num_fields; v++)   delete [] Field_Labels[v];
+      delete [] Field_Labels;
+      Field_Labels = NULL;
+   }
+
+} // FUNCTION : free_resources
+
+
+
+//-------------------------------------------------------------------------------------------------------
+// Function    :  push_chunk
+// Description :  Push a chunk to the I/O queue
+//
+// Note        :  1. Block if the queue is full
+//                2. Thread-safe
+//
+// Parameter   :  chunk : Chunk to be pushed (ownership is transferred to the I/O thread)
+//
+// Return      :  YT_SUCCESS or YT_FAIL
+//-------------------------------------------------------------------------------------------------------
+static int push_chunk( reduced_chunk *chunk )
+{
+
+   pthread_mutex_lock( &Queue_Mutex );
+
+   if ( IO_Failed  &&  chunk->kind != CHUNK_STOP )
+   {
+      pthread_mutex_unlock( &Queue_Mutex );
+      free( chunk->data );
+      delete chunk;
+      YT_ABORT( "The I/O thread of the reduced output has failed previously!\n" );
+   }
+
+   if ( Queue_Count == g_reduced_output.queue_size  &&  Last_Warning != g_param_libyt.counter )
+   {
+      log_warning( "Reduced output queue is full (queue_size = %d) ==> waiting for the I/O thread\n",
+                   g_reduced_output.queue_size );
+      Last_Warning = g_param_libyt.counter;
+   }
+
+   while ( Queue_Count == g_reduced_output.queue_size )
+      pthread_cond_wait( &Queue_NotFull, &Queue_Mutex );
+
+   Queue[ ( Queue_Head + Queue_Count ) % g_reduced_output.queue_size ] = chunk;
+   Queue_Count ++;
+
+   pthread_cond_signal( &Queue_NotEmpty );
+   pthread_mutex_unlock( &Queue_Mutex );
+
+
+   return YT_SUCCESS;
+
+} // FUNCTION : push_chunk
+
+
+
+//-------------------------------------------------------------------------------------------------------
+// Function    :  io_thread_main
+// Description :  Main loop of the background I/O thread
+//
+// Note        :  1. Write the header and payload of each chunk to the data file and then append the header
+//                   to the index file
+//                2. Return when receiving CHUNK_STOP
+//
+// Parameter   :  arg : Not used
+//
+// Return      :  NULL
+//-------------------------------------------------------------------------------------------------------
+static void *io_thread_main( void *arg )
+{
+
+   while ( true )
+   {
+//    pop a chunk
+      pthread_mutex_lock( &Queue_Mutex );
+
+      while ( Queue_Count == 0 )
+         pthread_cond_wait( &Queue_NotEmpty, &Queue_Mutex );
+
+      reduced_chunk *chunk = Queue[Queue_Head];
+      Queue_Head  = ( Queue_Head + 1 ) % g_reduced_output.queue_size;
+      Queue_Count --;
+
+      pthread_cond_signal( &Queue_NotFull );
+      pthread_mutex_unlock( &Queue_Mutex );
+
+
+//    process the chunk
+      const chunk_kind kind = chunk->kind;
+
+      if ( kind == CHUNK_DATA  &&  !IO_Failed )
+      {
+         chunk->header.offset = Data_Offset + sizeof(reduced_chunk_header);
+
+         bool failed = false;
+         if ( fwrite( &chunk->header, sizeof(reduced_chunk_header), 1, Data_File  ) != 1 )   failed = true;
+         if ( fwrite( chunk->data,    chunk->header.nbytes,         1, Data_File  ) != 1 )   failed = true;
+         if ( fwrite( &chunk->header, sizeof(reduced_chunk_header), 1, Index_File ) != 1 )   failed = true;
+
+         if ( failed )
+         {
+            log_error( "Writing grid [%ld] field \"%s\" to the reduced output ... failed!\n",
+                       (long)chunk->header.grid_id, chunk->header.field );
+
+            pthread_mutex_lock( &Queue_Mutex );
+            IO_Failed = true;
+            pthread_mutex_unlock( &Queue_Mutex );
+         }
+
+         Data_Offset = chunk->header.offset + chunk->header.nbytes;
+      }
+
+      else if ( kind == CHUNK_FLUSH  ||  kind == CHUNK_STOP )
+      {
+         fflush( Data_File  );
+         fflush( Index_File );
+      }
+
+      free( chunk->data );
+      delete chunk;
+
+      if ( kind == CHUNK_STOP )   break;
+   } // while ( true )
+
+
+   return NULL;
+
+} // FUNCTION : io_thread_main
+
+
+
+//-------------------------------------------------------------------------------------------------------
+// Function    :  downsample_field
+// Description :  Downsample a field by averaging every factor^3 cells
+//
+// Note        :  1. Array layout follows the NumPy arrays in libyt.grid_data
+//                   ==> index = ( i0*dim[1] + i1 )*dim[2] + i2
+//                2. Partial blocks at the upper boundaries average over the available cells only
+//
+// Parameter   :  in      : Input  array
+//                out     : Output array
+//                in_dim  : Input  dimensions
+//                out_dim : Output dimensions
+//                factor  : Downsampling factor
+//
+// Return      :  out
+//-------------------------------------------------------------------------------------------------------
+template <typename T>
+static void downsample_field( const T *in, T *out, const int in_dim[3], const int out_dim[3], const int factor )
+{
+
+   for (int o0=0; o0<out_dim[0]; o0++)
+   for (int o1=0; o1<out_dim[1]; o1++)
+   for (int o2=0; o2<out_dim[2]; o2++)
+   {
+      const int i0_end = MIN( (o0+1)*factor, in_dim[0] );
+      const int i1_end = MIN( (o1+1)*factor, in_dim[1] );
+      const int i2_end = MIN( (o2+1)*factor, in_dim[2] );
+
+      double sum   = 0.0;
+      long   count = 0;
+
+      for (int i0=o0*factor; i0<i0_end; i0++)
+      for (int i1=o1*factor; i1<i1_end; i1++)
+      for (int i2=o2*factor; i2<i2_end; i2++)
+      {
+         sum += in[ ( (long)i0*in_dim[1] + i1 )*in_dim[2] + i2 ];
+         count ++;
+      }
+
+      out[ ( (long)o0*out_dim[1] + o1 )*out_dim[2] + o2 ] = (T)( sum/count );
+   }
+
+} // FUNCTION : downsample_field
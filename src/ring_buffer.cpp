@@ -0,0 +1,410 @@
+#include "yt_combo.h"
+#include <string.h>
+#include <math.h>
+
+
+// Python object of libyt.ring_buffer()
+// ==> each slot is stored twice, at "s" and "s + depth", so that the "count" most recent slots starting at
+//     "head" are always contiguous and can be returned as a single NumPy view without copying
+struct ring_buffer_object
+{
+   PyObject_HEAD
+   PyObject *name;
+   int       ndim;
+   npy_intp  shape[NPY_MAXDIMS];
+   int       type_num;
+   size_t    slot_bytes;
+   int       depth;
+   int       head;        // index of the oldest slot
+   int       count;       // number of stored slots
+   char     *data;        // [2*depth][slot_bytes]
+   long     *steps;       // [2*depth]
+   double   *times;       // [2*depth]
+};
+
+static PyTypeObject RingBuffer_Type;
+static bool         Type_Ready  = false;
+static size_t       Total_Bytes = 0;   // memory of all ring buffers
+
+static PyObject *ordered_view( ring_buffer_object *self, const int type_num, const int ndim, const npy_intp *shape,
+                               char *base, const size_t slot_bytes, const int first, const int count );
+
+
+
+
+//-------------------------------------------------------------------------------------------------------
+// Function    :  ring_buffer_dealloc / ring_buffer_append / ring_buffer_clear
+// Description :  Methods of libyt.RingBuffer
+//
+// Note        :  1. append( array ) copies "array" (converted to the buffer shape and dtype) to the next slot,
+//                   and records the current step (i.e., counter) and simulation time
+//                   ==> The oldest slot is overwritten once the buffer is full, and nothing is reallocated
+//                2. clear() drops all slots but keeps the memory
+//-------------------------------------------------------------------------------------------------------
+static void ring_buffer_dealloc( PyObject *object )
+{
+
+   ring_buffer_object *self = (ring_buffer_object*)object;
+
+   Total_Bytes -= 2*(size_t)self->depth*( self->slot_bytes + sizeof(long) + sizeof(double) );
+
+   Py_XDECREF( self->name );
+   free( self->data );
+   free( self->steps );
+   free( self->times );
+
+   Py_TYPE( object )->tp_free( object );
+
+} // FUNCTION : ring_buffer_dealloc
+
+
+static PyObject *ring_buffer_append( PyObject *object, PyObject *py_input )
+{
+
+   ring_buffer_object *self = (ring_buffer_object*)object;
+
+// slot to be written
+   int slot;
+
+   if ( self->count < self->depth )   slot = ( self->head + self->count ) % self->depth;
+   else                               slot = self->head;
+
+// copy the input by NumPy so that it is converted and broadcast to the slot
+   PyArray_Descr *descr   = PyArray_DescrFromType( self->type_num );
+   PyObject      *py_slot = PyArray_NewFromDescr( &PyArray_Type, descr, self->ndim, self->shape, NULL,
+                                                  self->data + slot*self->slot_bytes, NPY_ARRAY_CARRAY, NULL );
+   if ( py_slot == NULL )   return NULL;
+
+   PyObject *py_array = PyArray_FROMANY( py_input, self->type_num, 0, self->ndim, 0 );
+   int       status   = ( py_array == NULL ) ? -1 : PyArray_CopyInto( (PyArrayObject*)py_slot, (PyArrayObject*)py_array );
+
+   Py_XDECREF( py_array );
+   Py_DECREF( py_slot );
+
+   if ( status != 0 )   return NULL;
+
+// mirror the slot and record the step
+   memcpy( self->data + ( slot + self->depth )*self->slot_bytes, self->data + slot*self->slot_bytes, self->slot_bytes );
+
+   self->steps[slot] = self->steps[ slot + self->depth ] = g_param_libyt.counter;
+   self->times[slot] = self->times[ slot + self->depth ] = ( g_param_libyt.param_yt_set ) ? g_param_yt.current_time : NAN;
+
+   if ( self->count < self->depth )   self->count ++;
+   else                               self->head = ( self->head + 1 ) % self->depth;
+
+   Py_RETURN_NONE;
+
+} // FUNCTION : ring_buffer_append
+
+
+static PyObject *ring_buffer_clear( PyObject *object, PyObject *args )
+{
+
+   ring_buffer_object *self = (ring_buffer_object*)object;
+
+   self->head  = 0;
+   self->count = 0;
+
+   Py_RETURN_NONE;
+
+} // FUNCTION : ring_buffer_clear
+
+
+
+//-------------------------------------------------------------------------------------------------------
+// Function    :  ring_buffer_getattro / ring_buffer_length / ring_buffer_item
+// Description :  Attributes and sequence protocol of libyt.RingBuffer
+//
+// Note        :  1. Attributes "data", "steps", and "times" are read-only views of all stored slots ordered
+//                   from the oldest to the most recent, with shapes (count, *shape), (count,), and (count,)
+//                   ==> Views keep the buffer alive, but their contents change with later appends
+//                       (copy them to keep)
+//                2. buffer[i] is a read-only view of slot "i" in the same order (negative "i" allowed)
+//-------------------------------------------------------------------------------------------------------
+static PyObject *ring_buffer_getattro( PyObject *object, PyObject *py_name )
+{
+
+   ring_buffer_object *self = (ring_buffer_object*)object;
+   const char         *name = PyString_Check( py_name ) ? PyString_AsString( py_name ) : "";
+
+   if ( strcmp( name, "data" ) == 0 )
+      return ordered_view( self, self->type_num, self->ndim, self->shape, self->data, self->slot_bytes,
+                           self->head, self->count );
+
+   if ( strcmp( name, "steps" ) == 0 )
+      return ordered_view( self, NPY_LONG, 0, NULL, (char*)self->steps, sizeof(long), self->head, self->count );
+
+   if ( strcmp( name, "times" ) == 0 )
+      return ordered_view( self, NPY_DOUBLE, 0, NULL, (char*)self->times, sizeof(double), self->head, self->count );
+
+   if ( strcmp( name, "name"  ) == 0 ) {  Py_INCREF( self->name );   return self->name;  }
+   if ( strcmp( name, "depth" ) == 0 )    return PyInt_FromLong( self->depth );
+
+   if ( strcmp( name, "shape" ) == 0 )
+   {
+      PyObject *py_shape = PyTuple_New( self->ndim );
+      for (int d=0; d<self->ndim; d++)   PyTuple_SET_ITEM( py_shape, d, PyInt_FromLong( self->shape[d] ) );
+      return py_shape;
+   }
+
+   return PyObject_GenericGetAttr( object, py_name );
+
+} // FUNCTION : ring_buffer_getattro
+
+
+static Py_ssize_t ring_buffer_length( PyObject *object )
+{
+
+   return ( (ring_buffer_object*)object )->count;
+
+} // FUNCTION : ring_buffer_length
+
+
+static PyObject *ring_buffer_item( PyObject *object, Py_ssize_t i )
+{
+
+   ring_buffer_object *self = (ring_buffer_object*)object;
+
+   if ( i < 0  ||  i >= self->count )
+   {
+      PyErr_SetString( PyExc_IndexError, "ring buffer index out of range" );
+      return NULL;
+   }
+
+   PyObject *py_view = ordered_view( self, self->type_num, self->ndim, self->shape, self->data, self->slot_bytes,
+                                     self->head + (int)i, 1 );
+   if ( py_view == NULL )   return NULL;
+
+// drop the leading axis of length one
+   PyArray_Dims np_shape = { self->shape, self->ndim };
+   PyObject    *py_item  = PyArray_Newshape( (PyArrayObject*)py_view, &np_shape, NPY_CORDER );
+   Py_DECREF( py_view );
+
+   return py_item;
+
+} // FUNCTION : ring_buffer_item
+
+
+static PyObject *ring_buffer_repr( PyObject *object )
+{
+
+   ring_buffer_object *self = (ring_buffer_object*)object;
+
+   return PyString_FromFormat( "<libyt.RingBuffer '%s': %d of %d steps>", PyString_AsString( self->name ),
+                               self->count, self->depth );
+
+} // FUNCTION : ring_buffer_repr
+
+
+static PyMethodDef RingBuffer_Methods[] =
+{
+   { "append", ring_buffer_append, METH_O,      "Copy an array to the next slot, overwriting the oldest one if full" },
+   { "clear",  ring_buffer_clear,  METH_NOARGS, "Drop all stored slots" },
+   { NULL, NULL, 0, NULL } // sentinel
+};
+
+static PySequenceMethods RingBuffer_Sequence;
+
+
+
+//-------------------------------------------------------------------------------------------------------
+// Function    :  ordered_view
+// Description :  Return a read-only NumPy view of consecutive slots of a ring buffer
+//
+// Parameter   :  self       : Ring buffer owning the memory ==> set as the base object of the view
+//                type_num   : NumPy type of each element
+//                ndim       : Number of dimensions of each slot
+//                shape      : Shape of each slot
+//                base       : Pointer to slot 0
+//                slot_bytes : Size of each slot in bytes
+//                first      : Index of the first slot (< 2*depth - count)
+//                count      : Number of slots
+//
+// Return      :  New reference of the view or NULL on error
+//-------------------------------------------------------------------------------------------------------
+static PyObject *ordered_view( ring_buffer_object *self, const int type_num, const int ndim, const npy_intp *shape,
+                               char *base, const size_t slot_bytes, const int first, const int count )
+{
+
+   npy_intp np_shape[NPY_MAXDIMS];
+
+   np_shape[0] = count;
+   for (int d=0; d<ndim; d++)   np_shape[d+1] = shape[d];
+
+   PyObject *py_view = PyArray_SimpleNewFromData( ndim+1, np_shape, type_num, base + first*slot_bytes );
+   if ( py_view == NULL )   return NULL;
+
+   PyArray_CLEARFLAGS( (PyArrayObject*)py_view, NPY_ARRAY_WRITEABLE );
+
+   Py_INCREF( self );
+   if ( PyArray_SetBaseObject( (PyArrayObject*)py_view, (PyObject*)self ) != 0 )
+   {
+      Py_DECREF( py_view );
+      return NULL;
+   }
+
+   return py_view;
+
+} // FUNCTION : ordered_view
+
+
+
+//-------------------------------------------------------------------------------------------------------
+// Function    :  get_ring_buffer
+// Description :  Method "libyt.ring_buffer( name, shape, dtype='float64', depth=None )" returning the ring
+//                buffer "name", which is created on the first call
+//
+// Note        :  1. Ring buffers are stored in libyt.ring_buffers, which is not cleared by yt_inline()
+//                   ==> Scripts can call libyt.ring_buffer() at every step to get the same buffer
+//                2. "depth" defaults to "g_param_libyt.ring_buffer_depth"
+//                3. All ring buffers share the memory cap "g_param_libyt.ring_buffer_mb"
+//                4. An existing buffer is returned only if "shape" and "dtype" match
+//                5. "dtype" must be a boolean or numeric type
+//
+// Parameter   :  self   : Not used
+//                args   : See above
+//                kwargs : See above
+//
+// Return      :  Ring buffer or NULL on error
+//-------------------------------------------------------------------------------------------------------
+PyObject *get_ring_buffer( PyObject *self, PyObject *args, PyObject *kwargs )
+{
+
+   static const char *kwlist[] = { "name", "shape", "dtype", "depth", NULL };
+
+   PyObject      *py_name, *py_shape;
+   PyArray_Descr *descr = NULL;
+   int            depth = g_param_libyt.ring_buffer_depth;
+
+   if ( !PyArg_ParseTupleAndKeywords( args, kwargs, "SO|O&i", (char**)kwlist, &py_name, &py_shape,
+                                      PyArray_DescrConverter2, &descr, &depth ) )
+      return NULL;
+
+   if ( descr == NULL )   descr = PyArray_DescrFromType( NPY_DOUBLE );
+
+   npy_intp  shape[NPY_MAXDIMS];
+   PyObject *py_seq = ( PyInt_Check( py_shape )  ||  PyLong_Check( py_shape ) ) ? Py_BuildValue( "(O)", py_shape )
+                                                                              : PySequence_Tuple( py_shape );
+   const int ndim   = ( py_seq == NULL ) ? -1 : PyArray_IntpFromSequence( py_seq, shape, NPY_MAXDIMS );
+
+   Py_XDECREF( py_seq );
+
+   if ( ndim < 0 )
+   {
+      Py_DECREF( descr );
+      if ( !PyErr_Occurred() )   PyErr_SetString( PyExc_ValueError, "invalid shape" );
+      return NULL;
+   }
+
+   const int type_num = descr->type_num;
+   const int elsize   = descr->elsize;
+
+// slots are copied with memcpy() and recreated from "type_num"
+// ==> reject object, flexible (e.g., strings and structured types), and datetime dtypes
+   if (  PyDataType_REFCHK( descr )  ||  ( !PyTypeNum_ISBOOL( type_num ) && !PyTypeNum_ISNUMBER( type_num ) )  ||
+         elsize == 0  )
+   {
+      Py_DECREF( descr );
+      PyErr_SetString( PyExc_TypeError, "dtype of a ring buffer must be a boolean or numeric type" );
+      return NULL;
+   }
+
+   Py_DECREF( descr );
+
+
+// return the existing buffer
+   PyObject *py_buffers = PyObject_GetAttrString( PyImport_AddModule( "libyt" ), "ring_buffers" );
+   PyObject *py_buffer  = ( py_buffers == NULL ) ? NULL : PyDict_GetItem( py_buffers, py_name );   // borrowed reference
+
+   if ( py_buffer != NULL )
+   {
+      ring_buffer_object *buffer = (ring_buffer_object*)py_buffer;
+      bool match = ( buffer->type_num == type_num  &&  buffer->ndim == ndim );
+
+      for (int d=0; d<ndim  &&  match; d++)   match = ( buffer->shape[d] == shape[d] );
+
+      Py_DECREF( py_buffers );
+
+      if ( !match )
+      {
+         PyErr_Format( PyExc_ValueError, "ring buffer \"%s\" exists with a different shape or dtype",
+                       PyString_AsString( py_name ) );
+         return NULL;
+      }
+
+      Py_INCREF( py_buffer );
+      return py_buffer;
+   }
+
+
+// create a new buffer
+   size_t slot_bytes = elsize;
+   for (int d=0; d<ndim; d++)   slot_bytes *= shape[d];
+
+   const size_t bytes = 2*(size_t)depth*( slot_bytes + sizeof(long) + sizeof(double) );
+
+   if ( py_buffers == NULL  ||  depth <= 0  ||  ndim >= NPY_MAXDIMS  ||
+        Total_Bytes + bytes > g_param_libyt.ring_buffer_mb*1048576.0 )
+   {
+      Py_XDECREF( py_buffers );
+
+      if ( py_buffers == NULL )   return NULL;
+      if ( depth <= 0 )           PyErr_SetString( PyExc_ValueError, "depth must be > 0" );
+      else if ( ndim >= NPY_MAXDIMS )
+                                  PyErr_SetString( PyExc_ValueError, "too many dimensions" );
+      else                        PyErr_Format( PyExc_MemoryError, "ring buffer \"%s\" exceeds ring_buffer_mb = %.1f",
+                                                PyString_AsString( py_name ), g_param_libyt.ring_buffer_mb );
+      return NULL;
+   }
+
+   if ( !Type_Ready )
+   {
+      RingBuffer_Sequence.sq_length = ring_buffer_length;
+      RingBuffer_Sequence.sq_item   = ring_buffer_item;
+
+      RingBuffer_Type.tp_name       = "libyt.RingBuffer";
+      RingBuffer_Type.tp_basicsize  = sizeof(ring_buffer_object);
+      RingBuffer_Type.tp_flags      = Py_TPFLAGS_DEFAULT;
+      RingBuffer_Type.tp_doc        = "Fixed-shape arrays of the most recent steps kept across yt_inline()";
+      RingBuffer_Type.tp_dealloc    = ring_buffer_dealloc;
+      RingBuffer_Type.tp_as_sequence= &RingBuffer_Sequence;
+      RingBuffer_Type.tp_getattro   = ring_buffer_getattro;
+      RingBuffer_Type.tp_repr       = ring_buffer_repr;
+      RingBuffer_Type.tp_methods    = RingBuffer_Methods;
+
+      if ( PyType_Ready( &RingBuffer_Type ) != 0 )
+      {
+         Py_DECREF( py_buffers );
+         return NULL;
+      }
+
+      Type_Ready = true;
+   }
+
+   ring_buffer_object *buffer = PyObject_New( ring_buffer_object, &RingBuffer_Type );
+
+   Py_INCREF( py_name );
+   buffer->name       = py_name;
+   buffer->ndim       = ndim;
+   buffer->type_num   = type_num;
+   buffer->slot_bytes = slot_bytes;
+   buffer->depth      = depth;
+   buffer->head       = 0;
+   buffer->count      = 0;
+   buffer->data       = (char  *)malloc( 2*depth*MAX( slot_bytes, (size_t)1 ) );
+   buffer->steps      = (long  *)malloc( 2*depth*sizeof(long)   );
+   buffer->times      = (double*)malloc( 2*depth*sizeof(double) );
+
+   for (int d=0; d<ndim; d++)   buffer->shape[d] = shape[d];
+
+   Total_Bytes += bytes;
+
+   PyDict_SetItem( py_buffers, py_name, (PyObject*)buffer );
+   Py_DECREF( py_buffers );
+
+   log_debug( "Creating ring buffer \"%s\" with %d steps of %ld bytes ... done\n", PyString_AsString( py_name ),
+              depth, (long)slot_bytes );
+
+   return (PyObject*)buffer;
+
+} // FUNCTION : get_ring_buffer
@@ -0,0 +1,107 @@
+#define NO_PYTHON
+#include "yt_combo.h"
+#undef NO_PYTHON
+#include <math.h>
+
+
+
+
+//-------------------------------------------------------------------------------------------------------
+// Function    :  sample_points
+// Description :  Interpolate fields at arbitrary positions
+//
+// Note        :  1. Points are binned into the finest grid containing them (see grid_index_find()), and
+//                   each grid is then processed once for all its points
+//                   ==> Field data of derived or encoded fields are computed once per grid containing points
+//                2. Piecewise-constant or trilinear interpolation within the containing grid (see sample_grid())
+//                3. Points outside all grids are set to NaN
+//                4. Both binning and sampling are parallelized with OpenMP if libyt is compiled with -DOPENMP
+//                5. Does not touch any Python object ==> can be called without holding the GIL
+//
+// Parameter   :  num_points : Number of points
+//                pos        : Positions of all points [num_points][3]
+//                num_fields : Number of fields
+//                fields     : Name of each field (a field passed to yt_add_grid() or a derived field)
+//                linear     : true  ==> trilinear interpolation
+//                             false ==> value of the cell containing each point
+//                out        : Output array of each field [num_fields][num_points]
+//
+// Return      :  YT_SUCCESS or YT_FAIL
+//-------------------------------------------------------------------------------------------------------
+int sample_points( const long num_points, const double *pos, const int num_fields, const char **fields,
+                   const bool linear, double **out )
+{
+
+   const long num_grids = g_param_yt.num_grids;
+
+   if ( g_grids == NULL )   YT_ABORT( "No grid has been staged!\n" );
+
+   if ( grid_index_build() != YT_SUCCESS )   YT_ABORT( "Building the spatial index ... failed!\n" );
+
+
+// bin points into their grids (compressed-row storage)
+   long *grid_of    = new long [num_points];
+   long *grid_start = new long [num_grids+1];
+   long *points     = new long [num_points];
+
+#  ifdef OPENMP
+#  pragma omp parallel for schedule( static ) if ( !g_param_libyt.forked_worker )
+#  endif
+   for (long p=0; p<num_points; p++)   grid_of[p] = grid_index_find( pos + 3*p );
+
+   for (long g=0; g<=num_grids; g++)   grid_start[g] = 0;
+   for (long p=0; p<num_points; p++)   if ( grid_of[p] >= 0 )   grid_start[ grid_of[p] + 1 ] ++;
+   for (long g=0; g<num_grids; g++)    grid_start[g+1] += grid_start[g];
+
+   long *fill = new long [num_grids];
+   for (long g=0; g<num_grids; g++)    fill[g] = grid_start[g];
+   for (long p=0; p<num_points; p++)
+   {
+      if ( grid_of[p] >= 0 )   points[ fill[ grid_of[p] ] ++ ] = p;
+      else
+         for (int v=0; v<num_fields; v++)   out[v][p] = NAN;
+   }
+
+   delete [] fill;
+   delete [] grid_of;
+
+
+// sample each grid containing points
+   bool found = true;
+
+#  ifdef OPENMP
+#  pragma omp parallel for schedule( dynamic ) if ( !g_param_libyt.forked_worker )
+#  endif
+   for (long g=0; g<num_grids; g++)
+   {
+      if ( grid_start[g] == grid_start[g+1] )   continue;
+
+      for (int v=0; v<num_fields; v++)
+      {
+         yt_ftype ftype;
+         bool     allocated;
+         void    *data = get_field_data( g_grids + g, fields[v], &ftype, &allocated );
+
+         if ( data == NULL )
+         {
+            found = false;
+            continue;
+         }
+
+         for (long t=grid_start[g]; t<grid_start[g+1]; t++)
+            out[v][ points[t] ] = sample_grid( g_grids + g, data, ftype, pos + 3*points[t], linear );
+
+         if ( allocated )   delete [] (char*)data;
+      }
+   }
+
+   delete [] grid_start;
+   delete [] points;
+
+   if ( !found )   YT_ABORT( "Sampled fields are not found in all grids!\n" );
+
+   log_debug( "Sampling %d field(s) at %ld points ... done\n", num_fields, num_points );
+
+   return YT_SUCCESS;
+
+} // FUNCTION : sample_points
@@ -0,0 +1,683 @@
+#define NO_PYTHON
+#include "yt_combo.h"
+#undef NO_PYTHON
+#include <string.h>
+#include <stdint.h>
+#include <stdarg.h>
+#include <math.h>
+#include <typeinfo>
+#include <unistd.h>
+#include <signal.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+
+
+// magic strings and version of the shared-memory format
+// ==> see tool/libyt_server.py for the corresponding reader
+static const char    ControlMagic[8] = "LIBYTSC";
+static const char    SlotMagic   [8] = "LIBYTSS";
+static const int32_t FormatVersion   = 1;
+static const int     MaxSlots        = 16;
+static const int64_t Alignment       = 64;
+
+
+//-------------------------------------------------------------------------------------------------------
+// Structure   :  shm_control / shm_slot_header
+// Description :  Layout of the control segment "/<shm_name>.ctl" and the slot segments "/<shm_name>.<slot>"
+//
+// Note        :  1. The control segment is a single-producer single-consumer ring of "num_slots" entries
+//                   ==> libyt publishes step "head" in slot ( head % num_slots ) and then increments "head"
+//                   ==> The server analyzes step "tail" and then increments "tail" to release its slot
+//                2. Each slot segment stores one step: [shm_slot_header] [JSON] [padding] [data]
+//                   ==> The JSON text describes the parameters and the location of all arrays in [data]
+//                       (offsets relative to "data_offset")
+//                3. All members are naturally aligned ==> sizeof(shm_control) == 304 bytes
+//-------------------------------------------------------------------------------------------------------
+struct shm_control
+{
+   char    magic[8];
+   int32_t version;
+   int32_t num_slots;
+   int64_t head;                   // number of steps published by libyt
+   int64_t tail;                   // number of steps released by the server
+   int64_t server_pid;             // PID of the attached server (0 ==> none)
+   int64_t closed;                 // 1 ==> yt_finalize() has been called
+   int64_t step  [MaxSlots];       // step (i.e., g_param_libyt.counter) stored in each slot
+   int64_t nbytes[MaxSlots];       // size of the data stored in each slot
+};
+
+struct shm_slot_header
+{
+   char    magic[8];
+   int64_t step;
+   int64_t json_size;              // JSON text starts right after this header
+   int64_t data_offset;            // start of the arrays
+   int64_t padding[4];
+};
+
+
+// internal states
+static shm_control *Control    = NULL;
+static char        *Slot_Ptr [MaxSlots];
+static int64_t      Slot_Size[MaxSlots];
+
+// JSON text of this step and the code-specific parameters collected by yt_add_user_parameter_*()
+static char   *Json           = NULL;
+static int64_t Json_Size      = 0;
+static int64_t Json_Capacity  = 0;
+static char   *User           = NULL;
+static int64_t User_Size      = 0;
+static int64_t User_Capacity  = 0;
+
+static int64_t padded( const int64_t nbytes ) { return ( nbytes + Alignment - 1 ) / Alignment * Alignment; }
+static void    append( char **buffer, int64_t *size, int64_t *capacity, const char *format, ... );
+static void    append_string( char **buffer, int64_t *size, int64_t *capacity, const char *string );
+static void    append_double( char **buffer, int64_t *size, int64_t *capacity, const double value );
+static int     map_slot( const int slot, const int64_t nbytes );
+
+#define JSON( ... )          append( &Json, &Json_Size, &Json_Capacity, __VA_ARGS__ )
+#define JSON_STRING( s )     append_string( &Json, &Json_Size, &Json_Capacity, s )
+
+
+
+
+//-------------------------------------------------------------------------------------------------------
+// Function    :  shm_init
+// Description :  Create the control segment of the shared-memory transport
+//
+// Note        :  1. Called by yt_init() before initializing Python
+//                2. Set "g_param_libyt.external" so that this process publishes every analysis step to
+//                   tool/libyt_server.py instead of running Python
+//                3. Do nothing if "g_param_libyt.shm_name" is not set
+//
+// Parameter   :  None
+//
+// Return      :  YT_SUCCESS or YT_FAIL
+//-------------------------------------------------------------------------------------------------------
+int shm_init()
+{
+
+   if ( g_param_libyt.shm_name == NULL )   return YT_SUCCESS;
+
+   if ( strchr( g_param_libyt.shm_name, '/' ) != NULL  ||  strlen( g_param_libyt.shm_name ) > 200 )
+      YT_ABORT( "\"%s\" == \"%s\" must be a short name without '/'!\n", "shm_name", g_param_libyt.shm_name );
+
+   if ( g_param_libyt.shm_slots < 1  ||  g_param_libyt.shm_slots > MaxSlots )
+      YT_ABORT( "\"%s\" == %d is not in the range [1, %d]!\n", "shm_slots", g_param_libyt.shm_slots, MaxSlots );
+
+
+// remove the segment left by a previous run and create a new one
+   char name[256];
+   sprintf( name, "/%s.ctl", g_param_libyt.shm_name );
+   shm_unlink( name );
+
+   const int fd = shm_open( name, O_CREAT|O_EXCL|O_RDWR, 0600 );
+
+   if ( fd < 0  ||  ftruncate( fd, sizeof(shm_control) ) != 0 )
+   {
+      if ( fd >= 0 )   close( fd );
+      YT_ABORT( "Creating the shared-memory segment \"%s\" ... failed!\n", name );
+   }
+
+   Control = (shm_control*)mmap( NULL, sizeof(shm_control), PROT_READ|PROT_WRITE, MAP_SHARED, fd, 0 );
+   close( fd );
+
+   if ( Control == MAP_FAILED )
+   {
+      Control = NULL;
+      YT_ABORT( "Mapping the shared-memory segment \"%s\" ... failed!\n", name );
+   }
+
+   memset( Control, 0, sizeof(shm_control) );
+   Control->version   = FormatVersion;
+   Control->num_slots = g_param_libyt.shm_slots;
+
+   for (int s=0; s<MaxSlots; s++)
+   {
+      Slot_Ptr [s] = NULL;
+      Slot_Size[s] = 0;
+   }
+
+// publish the magic string last so that the server never sees a partially initialized segment
+   __atomic_thread_fence( __ATOMIC_RELEASE );
+   memcpy( Control->magic, ControlMagic, 8 );
+
+   g_param_libyt.external = true;
+
+   log_debug( "Creating the shared-memory control segment \"%s\" with %d slots ... done\n",
+              name, g_param_libyt.shm_slots );
+
+   return YT_SUCCESS;
+
+} // FUNCTION : shm_init
+
+
+
+//-------------------------------------------------------------------------------------------------------
+// Function    :  shm_finalize
+// Description :  Close the shared-memory transport
+//
+// Note        :  1. Called by yt_finalize()
+//                2. Wait until the server has analyzed all published steps, unless no server is attached
+//                   or the server has died
+//                3. Remove all segments ==> the server keeps its mappings until it exits
+//
+// Parameter   :  None
+//
+// Return      :  YT_SUCCESS or YT_FAIL
+//-------------------------------------------------------------------------------------------------------
+int shm_finalize()
+{
+
+   if ( Control == NULL )   return YT_SUCCESS;
+
+   __atomic_store_n( &Control->closed, 1, __ATOMIC_RELEASE );
+
+   const int64_t head = __atomic_load_n( &Control->head, __ATOMIC_ACQUIRE );
+   pid_t         pid;
+
+   if ( __atomic_load_n( &Control->tail, __ATOMIC_ACQUIRE ) < head )
+      log_info( "Waiting for the analysis server to finish %ld steps ...\n",
+                (long)( head - __atomic_load_n( &Control->tail, __ATOMIC_ACQUIRE ) ) );
+
+   while (  __atomic_load_n( &Control->tail, __ATOMIC_ACQUIRE ) < head  &&
+            ( pid = (pid_t)__atomic_load_n( &Control->server_pid, __ATOMIC_ACQUIRE ) ) != 0  &&
+            kill( pid, 0 ) == 0  )
+      usleep( 1000 );
+
+   if ( __atomic_load_n( &Control->tail, __ATOMIC_ACQUIRE ) < head )
+      log_warning( "%ld published steps were not analyzed since the analysis server is not running!\n",
+                   (long)( head - __atomic_load_n( &Control->tail, __ATOMIC_ACQUIRE ) ) );
+
+
+// remove all segments
+   char name[256];
+
+   for (int s=0; s<g_param_libyt.shm_slots; s++)
+   {
+      if ( Slot_Ptr[s] == NULL )   continue;
+
+      munmap( Slot_Ptr[s], Slot_Size[s] );
+      Slot_Ptr [s] = NULL;
+      Slot_Size[s] = 0;
+
+      sprintf( name, "/%s.%d", g_param_libyt.shm_name, s );
+      shm_unlink( name );
+   }
+
+   munmap( Control, sizeof(shm_control) );
+   Control = NULL;
+
+   sprintf( name, "/%s.ctl", g_param_libyt.shm_name );
+   shm_unlink( name );
+
+   free( Json );
+   free( User );
+   Json = User = NULL;
+   Json_Size = Json_Capacity = User_Size = User_Capacity = 0;
+
+   g_param_libyt.external = false;
+
+   return YT_SUCCESS;
+
+} // FUNCTION : shm_finalize
+
+
+
+//-------------------------------------------------------------------------------------------------------
+// Function    :  shm_set_parameter / shm_user_param / shm_user_param_string
+// Description :  yt_set_parameter() and yt_add_user_parameter_*() in the shared-memory transport
+//
+// Note        :  1. Validate the input and keep it for shm_inline() without touching Python
+//                2. shm_set_parameter() also allocates "g_param_libyt.grid_set" and "g_grids" so that
+//                   yt_add_grid() works as usual
+//
+// Return      :  YT_SUCCESS or YT_FAIL
+//-------------------------------------------------------------------------------------------------------
+int shm_set_parameter( yt_param_yt *param_yt )
+{
+
+   if ( g_param_libyt.param_yt_set )
+      YT_ABORT( "%s() has been called already in the shared-memory transport!\n", "yt_set_parameter" );
+
+   if ( begin_step( param_yt ) != YT_SUCCESS )   return YT_FAIL;
+
+   User_Size = 0;
+
+   g_param_libyt.param_yt_set = true;
+
+   return YT_SUCCESS;
+
+} // FUNCTION : shm_set_parameter
+
+
+template <typename T>
+int shm_user_param( const char *key, const int n, const T *input )
+{
+
+   if ( g_param_libyt.analysis_decided  &&  !g_param_libyt.analysis_due )   return YT_SUCCESS;
+
+   if ( !g_param_libyt.param_yt_set )
+      YT_ABORT( "Please invoke yt_set_parameter() before calling %s() in the shared-memory transport!\n",
+                "yt_add_user_parameter" );
+
+   if ( n != 1  &&  n != 3 )
+      YT_ABORT( "Currently %s() only supports loading a single scalar or a three-element array!\n",
+                "yt_add_user_parameter" );
+
+   const bool is_float = ( typeid(T) == typeid(float)  ||  typeid(T) == typeid(double) );
+   const bool is_int   = ( typeid(T) == typeid(  int)  ||  typeid(T) == typeid(  long) );
+   const bool is_uint  = ( typeid(T) == typeid( uint)  ||  typeid(T) == typeid( ulong) );
+
+   if ( !is_float  &&  !is_int  &&  !is_uint )
+      YT_ABORT( "Unsupported data type (only support float, double, int, long, unit, ulong)!\n" );
+
+   append( &User, &User_Size, &User_Capacity, "%s", ( User_Size > 0 ) ? ", " : "" );
+   append_string( &User, &User_Size, &User_Capacity, key );
+   append( &User, &User_Size, &User_Capacity, ( n == 1 ) ? ": " : ": [" );
+
+   for (int i=0; i<n; i++)
+   {
+      if ( i > 0 )   append( &User, &User_Size, &User_Capacity, ", " );
+
+      if      ( is_float )   append_double( &User, &User_Size, &User_Capacity, (double)input[i] );
+      else if ( is_int   )   append( &User, &User_Size, &User_Capacity, "%ld", (long )input[i] );
+      else                   append( &User, &User_Size, &User_Capacity, "%lu", (ulong)input[i] );
+   }
+
+   if ( n != 1 )   append( &User, &User_Size, &User_Capacity, "]" );
+
+   return YT_SUCCESS;
+
+} // FUNCTION : shm_user_param
+
+
+int shm_user_param_string( const char *key, const char *input )
+{
+
+   if ( g_param_libyt.analysis_decided  &&  !g_param_libyt.analysis_due )   return YT_SUCCESS;
+
+   if ( !g_param_libyt.param_yt_set )
+      YT_ABORT( "Please invoke yt_set_parameter() before calling %s() in the shared-memory transport!\n",
+                "yt_add_user_parameter_string" );
+
+   append( &User, &User_Size, &User_Capacity, "%s", ( User_Size > 0 ) ? ", " : "" );
+   append_string( &User, &User_Size, &User_Capacity, key );
+   append( &User, &User_Size, &User_Capacity, ": " );
+   append_string( &User, &User_Size, &User_Capacity, input );
+
+   return YT_SUCCESS;
+
+} // FUNCTION : shm_user_param_string
+
+
+// explicit template instantiation
+template int shm_user_param <int>    ( const char *key, const int n, const int    *input );
+template int shm_user_param <long>   ( const char *key, const int n, const long   *input );
+template int shm_user_param <uint>   ( const char *key, const int n, const uint   *input );
+template int shm_user_param <ulong>  ( const char *key, const int n, const ulong  *input );
+template int shm_user_param <float>  ( const char *key, const int n, const float  *input );
+template int shm_user_param <double> ( const char *key, const int n, const double *input );
+
+
+
+//-------------------------------------------------------------------------------------------------------
+// Function    :  shm_inline
+// Description :  yt_inline() in the shared-memory transport
+//
+// Note        :  1. Copy the parameters, hierarchy, and field data of this step to the next free slot and
+//                   publish it to the server
+//                   ==> Return right after the copy without waiting for the analysis
+//                2. Drop the step with a warning if all slots are still being analyzed (or no server is
+//                   running) so that the simulation never waits for the server
+//                3. Hierarchy is always published in the default representation
+//                   (i.e., "g_param_libyt.compact_hierarchy" is ignored)
+//
+// Parameter   :  None
+//
+// Return      :  YT_SUCCESS or YT_FAIL
+//-------------------------------------------------------------------------------------------------------
+int shm_inline()
+{
+
+   const double start = get_wall_time();
+
+// skip if no analysis is scheduled at this step
+   if ( g_param_libyt.analysis_decided  &&  !g_param_libyt.analysis_due )
+   {
+      log_info( "No analysis is scheduled at step [%ld] ... skipped\n", g_param_libyt.counter );
+
+      end_analysis_step();
+      g_param_libyt.counter ++;
+
+      return YT_SUCCESS;
+   }
+
+   if ( !g_param_libyt.param_yt_set )
+      YT_ABORT( "Please invoke yt_set_parameter() before calling %s()!\n", "yt_inline" );
+
+   for (long g=0; g<g_param_yt.num_grids; g++)
+   {
+      if ( g_param_libyt.grid_set[g] == false )
+         YT_ABORT( "Grid [%ld] has not been set!\n", g );
+   }
+
+
+// find a free slot
+   const int64_t head = Control->head;
+   const int     slot = head % Control->num_slots;
+
+   if ( head - __atomic_load_n( &Control->tail, __ATOMIC_ACQUIRE ) >= Control->num_slots )
+   {
+      log_warning( "All %d shared-memory slots are in use (is tool/libyt_server.py running?) ==> step [%ld] is dropped\n",
+                   Control->num_slots, g_param_libyt.counter );
+
+      reset_step();
+      return YT_SUCCESS;
+   }
+
+
+// collect all field labels
+   const long N          = g_param_yt.num_grids;
+   int        num_labels = 0;
+   const char **labels   = NULL;
+
+   for (long g=0; g<N; g++)
+   for (int  v=0; v<g_grids[g].num_fields; v++)
+   {
+      int l;
+      for (l=0; l<num_labels; l++)   if ( strcmp( labels[l], g_grids[g].field_labels[v] ) == 0 )   break;
+
+      if ( l == num_labels )
+      {
+         labels = (const char**)realloc( labels, (num_labels+1)*sizeof(const char*) );
+         labels[ num_labels ++ ] = g_grids[g].field_labels[v];
+      }
+   }
+
+
+// data layout: hierarchy arrays, field offset table, field types, and then field data
+   const int64_t offset_left   = 0;
+   const int64_t offset_right  = offset_left   + padded( N*3*sizeof(double) );
+   const int64_t offset_dims   = offset_right  + padded( N*3*sizeof(double) );
+   const int64_t offset_count  = offset_dims   + padded( N*3*sizeof(int64_t) );
+   const int64_t offset_parent = offset_count  + padded( N*sizeof(int64_t) );
+   const int64_t offset_level  = offset_parent + padded( N*sizeof(int64_t) );
+   const int64_t offset_table  = offset_level  + padded( N*sizeof(int64_t) );
+   const int64_t offset_ftype  = offset_table  + padded( N*num_labels*sizeof(int64_t) );
+   const int64_t offset_fields = offset_ftype  + padded( N*sizeof(int8_t) );
+
+   int64_t *field_offset = (int64_t*)malloc( N*num_labels*sizeof(int64_t) );
+   int64_t  data_size    = offset_fields;
+
+   for (long g=0; g<N; g++)
+   {
+      const yt_grid *grid      = g_grids + g;
+      const size_t   type_size = ( grid->field_ftype == YT_FLOAT ) ? sizeof(float) : sizeof(double);
+      const int64_t  nbytes    = (int64_t)grid->dimensions[0]*grid->dimensions[1]*grid->dimensions[2]*type_size;
+
+      for (int l=0; l<num_labels; l++)   field_offset[ g*num_labels + l ] = -1;
+
+      for (int v=0; v<grid->num_fields; v++)
+      {
+         int l;
+         for (l=0; l<num_labels; l++)   if ( strcmp( labels[l], grid->field_labels[v] ) == 0 )   break;
+
+         field_offset[ g*num_labels + l ] = data_size;
+         data_size += padded( nbytes );
+      }
+   }
+
+
+// JSON text
+   Json_Size = 0;
+
+   JSON( "{\"step\": %ld, \"param_yt\": {\"frontend\": ", g_param_libyt.counter );
+   JSON_STRING( g_param_yt.frontend );
+   JSON( ", \"fig_basename\": " );
+   if ( g_param_yt.fig_basename == NULL )
+   JSON( "\"Fig%09ld\"", g_param_libyt.counter );
+   else
+   JSON_STRING( g_param_yt.fig_basename );
+
+#  define JSON_SCALAR( KEY, FORMAT )   JSON( ", \"" #KEY "\": " FORMAT, g_param_yt.KEY )
+#  define JSON_VECTOR( KEY, FORMAT )   JSON( ", \"" #KEY "\": [" FORMAT ", " FORMAT ", " FORMAT "]", \
+                                             g_param_yt.KEY[0], g_param_yt.KEY[1], g_param_yt.KEY[2] )
+
+   JSON_SCALAR( current_time,            "%.17g" );
+   JSON_SCALAR( current_redshift,        "%.17g" );
+   JSON_SCALAR( omega_lambda,            "%.17g" );
+   JSON_SCALAR( omega_matter,            "%.17g" );
+   JSON_SCALAR( hubble_constant,         "%.17g" );
+   JSON_SCALAR( length_unit,             "%.17g" );
+   JSON_SCALAR( mass_unit,               "%.17g" );
+   JSON_SCALAR( time_unit,               "%.17g" );
+   JSON_SCALAR( cosmological_simulation, "%d"    );
+   JSON_SCALAR( dimensionality,          "%d"    );
+   JSON_SCALAR( refine_by,               "%d"    );
+   JSON_SCALAR( num_grids,               "%ld"   );
+   JSON_VECTOR( domain_left_edge,        "%.17g" );
+   JSON_VECTOR( domain_right_edge,       "%.17g" );
+   JSON_VECTOR( periodicity,             "%d"    );
+   JSON_VECTOR( domain_dimensions,       "%d"    );
+
+#  undef JSON_SCALAR
+#  undef JSON_VECTOR
+
+   JSON( "}, \"param_user\": {" );
+   if ( User_Size > 0 )   JSON( "%.*s", (int)User_Size, User );
+
+#  define JSON_ARRAY( SEPARATOR, KEY, OFFSET, DTYPE, NCOLUMN )                            \
+      JSON( "%s\"%s\": {\"offset\": %ld, \"dtype\": \"%s\", \"shape\": [%ld, %d]}",  \
+            SEPARATOR, KEY, (long)OFFSET, DTYPE, N, NCOLUMN )
+
+   JSON( "}, \"hierarchy\": {" );
+   JSON_ARRAY( "",   "grid_left_edge",      offset_left,   "<f8", 3 );
+   JSON_ARRAY( ", ", "grid_right_edge",     offset_right,  "<f8", 3 );
+   JSON_ARRAY( ", ", "grid_dimensions",     offset_dims,   "<i8", 3 );
+   JSON_ARRAY( ", ", "grid_particle_count", offset_count,  "<i8", 1 );
+   JSON_ARRAY( ", ", "grid_parent_id",      offset_parent, "<i8", 1 );
+   JSON_ARRAY( ", ", "grid_levels",         offset_level,  "<i8", 1 );
+   JSON( "}, " );
+   JSON_ARRAY( "",   "field_offset",        offset_table,  "<i8", num_labels );
+   JSON_ARRAY( ", ", "field_ftype",         offset_ftype,  "i1",  1 );
+
+#  undef JSON_ARRAY
+
+   JSON( ", \"fields\": [" );
+   for (int l=0; l<num_labels; l++)
+   {
+      if ( l > 0 )   JSON( ", " );
+      JSON_STRING( labels[l] );
+   }
+   JSON( "]}" );
+
+
+// map the slot
+   const int64_t data_offset = padded( sizeof(shm_slot_header) + Json_Size + 1 );
+   const int64_t slot_size   = data_offset + data_size;
+
+   if ( map_slot( slot, slot_size ) != YT_SUCCESS )
+   {
+      free( labels );
+      free( field_offset );
+      YT_ABORT( "Mapping the shared-memory slot [%d] of %ld bytes ... failed!\n", slot, (long)slot_size );
+   }
+
+
+// copy everything to the slot
+   char            *ptr    = Slot_Ptr[slot];
+   char            *data   = ptr + data_offset;
+   shm_slot_header *header = (shm_slot_header*)ptr;
+
+   memset( header, 0, sizeof(shm_slot_header) );
+   memcpy( header->magic, SlotMagic, 8 );
+   header->step        = g_param_libyt.counter;
+   header->json_size   = Json_Size;
+   header->data_offset = data_offset;
+
+   memcpy( ptr + sizeof(shm_slot_header), Json, Json_Size + 1 );
+   memcpy( data + offset_table, field_offset, N*num_labels*sizeof(int64_t) );
+
+#  ifdef OPENMP
+#  pragma omp parallel for schedule( dynamic )
+#  endif
+   for (long g=0; g<N; g++)
+   {
+      const yt_grid *grid      = g_grids + g;
+      const size_t   type_size = ( grid->field_ftype == YT_FLOAT ) ? sizeof(float) : sizeof(double);
+      const int64_t  nbytes    = (int64_t)grid->dimensions[0]*grid->dimensions[1]*grid->dimensions[2]*type_size;
+
+      for (int d=0; d<3; d++)
+      {
+         ( (double *)( data + offset_left  ) )[ 3*g + d ] = grid->left_edge [d];
+         ( (double *)( data + offset_right ) )[ 3*g + d ] = grid->right_edge[d];
+         ( (int64_t*)( data + offset_dims  ) )[ 3*g + d ] = grid->dimensions[d];
+      }
+
+      ( (int64_t*)( data + offset_count  ) )[g] = grid->particle_count;
+      ( (int64_t*)( data + offset_parent ) )[g] = grid->parent_id;
+      ( (int64_t*)( data + offset_level  ) )[g] = grid->level;
+      ( (int8_t *)( data + offset_ftype  ) )[g] = grid->field_ftype;
+
+      for (int v=0; v<grid->num_fields; v++)
+      {
+         int l;
+         for (l=0; l<num_labels; l++)   if ( strcmp( labels[l], grid->field_labels[v] ) == 0 )   break;
+
+         memcpy( data + field_offset[ g*num_labels + l ], grid->field_data[v], nbytes );
+      }
+   }
+
+   free( labels );
+   free( field_offset );
+
+
+// publish this step
+   Control->step  [slot] = g_param_libyt.counter;
+   Control->nbytes[slot] = slot_size;
+   __atomic_store_n( &Control->head, head + 1, __ATOMIC_RELEASE );
+
+   log_debug( "Publishing step [%ld] (%ld bytes) to the shared-memory slot [%d] ... done (%.3f s)\n",
+              g_param_libyt.counter, (long)slot_size, slot, get_wall_time() - start );
+
+
+// flush the reduced output of this step (the I/O thread does the actual work)
+   if ( g_param_libyt.reduced_output_set  &&  reduced_output_flush() != YT_SUCCESS )
+      YT_ABORT( "Flushing the reduced output ... failed!\n" );
+
+   reset_step();
+
+   return YT_SUCCESS;
+
+} // FUNCTION : shm_inline
+
+
+
+//-------------------------------------------------------------------------------------------------------
+// Function    :  append / append_string / append_double
+// Description :  Append formatted text, a JSON string, or a JSON number to a growable buffer
+//
+// Note        :  1. The buffer is always null-terminated
+//                2. append_double() writes "NaN", "Infinity", and "-Infinity" as accepted by the Python json module
+//-------------------------------------------------------------------------------------------------------
+static void append( char **buffer, int64_t *size, int64_t *capacity, const char *format, ... )
+{
+
+   va_list args;
+
+   while ( true )
+   {
+      va_start( args, format );
+      const int n = vsnprintf( *buffer + *size, *capacity - *size, format, args );
+      va_end( args );
+
+      if ( *size + n < *capacity )
+      {
+         *size += n;
+         return;
+      }
+
+      *capacity = MAX( 2*(*capacity), *size + n + 1024 );
+      *buffer   = (char*)realloc( *buffer, *capacity );
+   }
+
+} // FUNCTION : append
+
+
+static void append_string( char **buffer, int64_t *size, int64_t *capacity, const char *string )
+{
+
+   append( buffer, size, capacity, "\"" );
+
+   for (const char *c=string; *c!='\0'; c++)
+   {
+      if      ( *c == '"'  ||  *c == '\\' )   append( buffer, size, capacity, "\\%c", *c );
+      else if ( (unsigned char)*c < 0x20 )    append( buffer, size, capacity, "\\u%04x", (unsigned char)*c );
+      else                                    append( buffer, size, capacity, "%c", *c );
+   }
+
+   append( buffer, size, capacity, "\"" );
+
+} // FUNCTION : append_string
+
+
+static void append_double( char **buffer, int64_t *size, int64_t *capacity, const double value )
+{
+
+   if      ( isnan( value ) )   append( buffer, size, capacity, "NaN" );
+   else if ( isinf( value ) )   append( buffer, size, capacity, ( value > 0.0 ) ? "Infinity" : "-Infinity" );
+   else                         append( buffer, size, capacity, "%.17g", value );
+
+} // FUNCTION : append_double
+
+
+
+//-------------------------------------------------------------------------------------------------------
+// Function    :  map_slot
+// Description :  Make sure that the slot segment "/<shm_name>.<slot>" is mapped with at least "nbytes" bytes
+//
+// Note        :  1. The segment only grows ==> it is remapped with 25% headroom when it is too small
+//                2. Must not be called while the server is analyzing this slot
+//
+// Parameter   :  slot   : Target slot
+//                nbytes : Minimum size in bytes
+//
+// Return      :  YT_SUCCESS or YT_FAIL
+//-------------------------------------------------------------------------------------------------------
+static int map_slot( const int slot, const int64_t nbytes )
+{
+
+   if ( Slot_Ptr[slot] != NULL  &&  Slot_Size[slot] >= nbytes )   return YT_SUCCESS;
+
+   const int64_t size = padded( nbytes + nbytes/4 );
+   char name[256];
+   sprintf( name, "/%s.%d", g_param_libyt.shm_name, slot );
+
+   if ( Slot_Ptr[slot] != NULL )   munmap( Slot_Ptr[slot], Slot_Size[slot] );
+
+   Slot_Ptr [slot] = NULL;
+   Slot_Size[slot] = 0;
+
+   const int fd = shm_open( name, O_CREAT|O_RDWR, 0600 );
+   if ( fd < 0 )   return YT_FAIL;
+
+   if ( ftruncate( fd, size ) != 0 )
+   {
+      close( fd );
+      return YT_FAIL;
+   }
+
+   char *ptr = (char*)mmap( NULL, size, PROT_READ|PROT_WRITE, MAP_SHARED, fd, 0 );
+   close( fd );
+
+   if ( ptr == MAP_FAILED )   return YT_FAIL;
+
+   Slot_Ptr [slot] = ptr;
+   Slot_Size[slot] = size;
+
+   log_debug( "Mapping the shared-memory segment \"%s\" with %ld bytes ... done\n", name, (long)size );
+
+   return YT_SUCCESS;
+
+} // FUNCTION : map_slot
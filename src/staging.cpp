@@ -0,0 +1,731 @@
+#define NO_PYTHON
+#include "yt_combo.h"
+#undef NO_PYTHON
+#include "libyt.h"
+#include <string.h>
+#include <stdint.h>
+#include <limits.h>
+#include <typeinfo>
+
+
+// message tags between compute and analysis ranks
+enum { TAG_META=7001, TAG_ACK=7002, TAG_FINISH=7003 };
+
+
+// all record payloads are padded to multiples of "Alignment" bytes
+static const int64_t Alignment = 8;
+
+
+// record types
+enum staging_kind { STAGING_PARAM_YT=1, STAGING_USER_PARAM=2, STAGING_GRID=3 };
+
+
+//-------------------------------------------------------------------------------------------------------
+// Structure   :  staging_message_header / staging_record_header / staging_user_param_header / staging_field
+// Description :  Layout of the metadata message sent by each compute rank at each yt_inline()
+//
+// Note        :  1. Message layout: [staging_message_header] [staging_record_header + payload] ...
+//                2. Payload of each record type:
+//                   STAGING_PARAM_YT   : yt_param_yt + frontend + '\0' + fig_basename + '\0'
+//                   STAGING_USER_PARAM : staging_user_param_header + key + '\0' + [padding] + data
+//                   STAGING_GRID       : yt_grid + num_fields*staging_field + num_fields*(label + '\0')
+//                3. Field data are not included but pulled by the analysis rank from the RMA window of the
+//                   compute rank at the addresses stored in staging_field
+//                4. Structures are stored in the native binary layout
+//                   ==> all ranks must run the same build of libyt
+//-------------------------------------------------------------------------------------------------------
+struct staging_message_header
+{
+   int64_t counter;     // step (i.e., g_param_libyt.counter) of the compute rank
+   int64_t num_grids;   // number of grids staged on the compute rank
+};
+
+struct staging_record_header
+{
+   int32_t kind;
+   int32_t padding;
+   int64_t nbytes;      // payload size in bytes including padding
+};
+
+struct staging_user_param_header
+{
+   int32_t type;        // see USER_PARAM_* below
+   int32_t n;           // number of elements (string length + 1 for strings)
+   int32_t key_size;    // key length + 1
+   int32_t data_size;   // data size in bytes
+};
+
+struct staging_field
+{
+   MPI_Aint address;    // address of the field data in the RMA window of the compute rank
+   int64_t  nbytes;     // size of the field data in bytes
+};
+
+enum { USER_PARAM_INT=0, USER_PARAM_LONG=1, USER_PARAM_UINT=2, USER_PARAM_ULONG=3,
+       USER_PARAM_FLOAT=4, USER_PARAM_DOUBLE=5, USER_PARAM_STRING=6 };
+
+
+// metadata message of this step (compute ranks only)
+static char   *Message          = NULL;
+static int64_t Message_Size     = 0;
+static int64_t Message_Capacity = 0;
+
+// number of steps sent to the analysis ranks so far ==> the next step is sent to rank ( Num_Staged % N )
+static long    Num_Staged       = 0;
+
+// rank of the first analysis rank in MPI_COMM_WORLD (i.e., number of compute ranks)
+static int     First_Analysis_Rank = 0;
+
+static int64_t padded( const int64_t nbytes ) { return ( nbytes + Alignment - 1 ) / Alignment * Alignment; }
+static char   *append( const void *data, const int64_t nbytes );
+static char   *append_record( const staging_kind kind, const int64_t nbytes );
+static int     append_user_param( const char *key, const int type, const int n, const void *input, const int data_size );
+static int     transfer( void *buffer, const int64_t nbytes, const int rank, MPI_Aint address );
+
+
+
+
+//-------------------------------------------------------------------------------------------------------
+// Function    :  staging_init
+// Description :  Set up the staging mode, where the last "g_param_libyt.num_analysis_ranks" ranks of
+//                MPI_COMM_WORLD are reserved for analysis
+//
+// Note        :  1. Called by yt_init() on all ranks before initializing Python
+//                   ==> MPI must have been initialized by the simulation
+//                2. Set "g_param_libyt.staging" on the compute ranks, which skip Python entirely
+//                3. Split MPI_COMM_WORLD into "g_compute_comm" (compute ranks) and the communicator of the
+//                   analysis ranks, and create the dynamic RMA window "g_staging_win" exposing the field
+//                   buffers of the compute ranks
+//                4. Do nothing if the staging mode is disabled
+//
+// Parameter   :  None
+//
+// Return      :  YT_SUCCESS or YT_FAIL
+//-------------------------------------------------------------------------------------------------------
+int staging_init()
+{
+
+   g_compute_comm = MPI_COMM_WORLD;
+
+   if ( g_param_libyt.num_analysis_ranks == 0 )   return YT_SUCCESS;
+
+   int initialized, rank, size;
+   MPI_Initialized( &initialized );
+
+   if ( !initialized )
+      YT_ABORT( "MPI must be initialized before calling yt_init() with \"num_analysis_ranks\" = %d!\n",
+                g_param_libyt.num_analysis_ranks );
+
+   MPI_Comm_rank( MPI_COMM_WORLD, &rank );
+   MPI_Comm_size( MPI_COMM_WORLD, &size );
+
+   if ( g_param_libyt.num_analysis_ranks < 0  ||  g_param_libyt.num_analysis_ranks >= size )
+      YT_ABORT( "\"%s\" == %d is not in the range [0, %d)!\n", "num_analysis_ranks",
+                g_param_libyt.num_analysis_ranks, size );
+
+   First_Analysis_Rank          = size - g_param_libyt.num_analysis_ranks;
+   g_param_libyt.analysis_rank  = ( rank >= First_Analysis_Rank );
+   g_param_libyt.staging        = !g_param_libyt.analysis_rank;
+
+   if ( MPI_Comm_split( MPI_COMM_WORLD, g_param_libyt.analysis_rank, rank, &g_compute_comm ) != MPI_SUCCESS )
+      YT_ABORT( "Splitting MPI_COMM_WORLD ... failed!\n" );
+
+   if ( MPI_Win_create_dynamic( MPI_INFO_NULL, MPI_COMM_WORLD, &g_staging_win ) != MPI_SUCCESS )
+      YT_ABORT( "Creating the RMA window ... failed!\n" );
+
+   log_debug( "Staging mode: rank %d is a%s rank (%d compute and %d analysis ranks)\n",
+              rank, g_param_libyt.analysis_rank ? "n analysis" : " compute",
+              First_Analysis_Rank, g_param_libyt.num_analysis_ranks );
+
+   return YT_SUCCESS;
+
+} // FUNCTION : staging_init
+
+
+
+//-------------------------------------------------------------------------------------------------------
+// Function    :  staging_finalize
+// Description :  Shut down the staging mode
+//
+// Note        :  1. Called by yt_finalize() on all ranks
+//                2. Compute ranks tell all analysis ranks to leave yt_run_analysis_server()
+//                3. Collective over MPI_COMM_WORLD
+//
+// Parameter   :  None
+//
+// Return      :  YT_SUCCESS or YT_FAIL
+//-------------------------------------------------------------------------------------------------------
+int staging_finalize()
+{
+
+   if ( g_param_libyt.num_analysis_ranks == 0 )   return YT_SUCCESS;
+
+   if ( g_param_libyt.staging )
+   {
+      int size;
+      MPI_Comm_size( MPI_COMM_WORLD, &size );
+
+      for (int r=First_Analysis_Rank; r<size; r++)
+         MPI_Send( NULL, 0, MPI_BYTE, r, TAG_FINISH, MPI_COMM_WORLD );
+   }
+
+   MPI_Win_free( &g_staging_win );
+   MPI_Comm_free( &g_compute_comm );
+   g_compute_comm = MPI_COMM_WORLD;
+
+   free( Message );
+   Message          = NULL;
+   Message_Size     = 0;
+   Message_Capacity = 0;
+
+   g_param_libyt.staging       = false;
+   g_param_libyt.analysis_rank = false;
+
+   return YT_SUCCESS;
+
+} // FUNCTION : staging_finalize
+
+
+
+//-------------------------------------------------------------------------------------------------------
+// Function    :  staging_agree
+// Description :  Make all compute ranks agree on whether to perform analysis at this step
+//
+// Note        :  1. Called by decide_analysis() on the compute ranks
+//                   ==> Analysis is due if it is due on any compute rank
+//                2. Collective over "g_compute_comm"
+//
+// Parameter   :  due : Decision of this rank
+//
+// Return      :  Decision of all compute ranks
+//-------------------------------------------------------------------------------------------------------
+bool staging_agree( const bool due )
+{
+
+   int local = due, global;
+
+   MPI_Allreduce( &local, &global, 1, MPI_INT, MPI_LOR, g_compute_comm );
+
+   return global;
+
+} // FUNCTION : staging_agree
+
+
+
+//-------------------------------------------------------------------------------------------------------
+// Function    :  staging_set_parameter / staging_user_param / staging_user_param_string
+// Description :  yt_set_parameter() and yt_add_user_parameter_*() on the compute ranks
+//
+// Note        :  1. Validate the input and append it to the metadata message of this step without touching
+//                   Python
+//                2. staging_set_parameter() also allocates "g_param_libyt.grid_set" and "g_grids" so that
+//                   yt_add_grid() works as usual
+//
+// Return      :  YT_SUCCESS or YT_FAIL
+//-------------------------------------------------------------------------------------------------------
+int staging_set_parameter( yt_param_yt *param_yt )
+{
+
+   if ( g_param_libyt.param_yt_set )
+      YT_ABORT( "%s() has been called already in the staging mode!\n", "yt_set_parameter" );
+
+   if ( begin_step( param_yt ) != YT_SUCCESS )   return YT_FAIL;
+
+
+// start a new message
+   Message_Size = 0;
+
+   staging_message_header header;
+   header.counter   = g_param_libyt.counter;
+   header.num_grids = 0;
+   if ( append( &header, sizeof(staging_message_header) ) == NULL )   return YT_FAIL;
+
+   const char   *frontend     = ( param_yt->frontend     == NULL ) ? "" : param_yt->frontend;
+   const char   *fig_basename = ( param_yt->fig_basename == NULL ) ? "" : param_yt->fig_basename;
+   const int64_t nbytes       = sizeof(yt_param_yt) + strlen(frontend) + 1 + strlen(fig_basename) + 1;
+
+   char *payload = append_record( STAGING_PARAM_YT, nbytes );
+   if ( payload == NULL )   return YT_FAIL;
+
+   memcpy( payload, param_yt, sizeof(yt_param_yt) );
+   payload += sizeof(yt_param_yt);
+   memcpy( payload, frontend, strlen(frontend)+1 );
+   payload += strlen(frontend) + 1;
+   memcpy( payload, fig_basename, strlen(fig_basename)+1 );
+
+   g_param_libyt.param_yt_set = true;
+
+   log_debug( "Staging YT parameters ... done\n" );
+
+   return YT_SUCCESS;
+
+} // FUNCTION : staging_set_parameter
+
+
+template <typename T>
+int staging_user_param( const char *key, const int n, const T *input )
+{
+
+   if ( g_param_libyt.analysis_decided  &&  !g_param_libyt.analysis_due )   return YT_SUCCESS;
+
+   if ( !g_param_libyt.param_yt_set )
+      YT_ABORT( "Please invoke yt_set_parameter() before calling %s() in the staging mode!\n",
+                "yt_add_user_parameter" );
+
+   if ( n != 1  &&  n != 3 )
+      YT_ABORT( "Currently %s() only supports loading a single scalar or a three-element array!\n",
+                "yt_add_user_parameter" );
+
+   int type;
+   if      ( typeid(T) == typeid(   int) )   type = USER_PARAM_INT;
+   else if ( typeid(T) == typeid(  long) )   type = USER_PARAM_LONG;
+   else if ( typeid(T) == typeid(  uint) )   type = USER_PARAM_UINT;
+   else if ( typeid(T) == typeid( ulong) )   type = USER_PARAM_ULONG;
+   else if ( typeid(T) == typeid( float) )   type = USER_PARAM_FLOAT;
+   else if ( typeid(T) == typeid(double) )   type = USER_PARAM_DOUBLE;
+   else
+      YT_ABORT( "Unsupported data type (only support float, double, int, long, unit, ulong)!\n" );
+
+   return append_user_param( key, type, n, input, n*sizeof(T) );
+
+} // FUNCTION : staging_user_param
+
+
+int staging_user_param_string( const char *key, const char *input )
+{
+
+   if ( g_param_libyt.analysis_decided  &&  !g_param_libyt.analysis_due )   return YT_SUCCESS;
+
+   if ( !g_param_libyt.param_yt_set )
+      YT_ABORT( "Please invoke yt_set_parameter() before calling %s() in the staging mode!\n",
+                "yt_add_user_parameter_string" );
+
+   return append_user_param( key, USER_PARAM_STRING, strlen(input)+1, input, strlen(input)+1 );
+
+} // FUNCTION : staging_user_param_string
+
+
+// explicit template instantiation
+template int staging_user_param <int>    ( const char *key, const int n, const int    *input );
+template int staging_user_param <long>   ( const char *key, const int n, const long   *input );
+template int staging_user_param <uint>   ( const char *key, const int n, const uint   *input );
+template int staging_user_param <ulong>  ( const char *key, const int n, const ulong  *input );
+template int staging_user_param <float>  ( const char *key, const int n, const float  *input );
+template int staging_user_param <double> ( const char *key, const int n, const double *input );
+
+
+
+//-------------------------------------------------------------------------------------------------------
+// Function    :  staging_inline
+// Description :  yt_inline() on the compute ranks
+//
+// Note        :  1. Attach the field buffers of all grids added on this rank to the RMA window, send the
+//                   metadata message to the analysis rank of this step, and wait until that rank has pulled
+//                   all field data
+//                   ==> Return without waiting for the analysis script so that the simulation can overwrite
+//                       the field buffers as soon as yt_inline() returns
+//                2. Successive analyses are sent to the analysis ranks in a round-robin fashion
+//                   ==> The analysis of one step overlaps with the simulation and the analyses of the next
+//                       "num_analysis_ranks - 1" steps
+//
+// Parameter   :  None
+//
+// Return      :  YT_SUCCESS or YT_FAIL
+//-------------------------------------------------------------------------------------------------------
+int staging_inline()
+{
+
+   const double start = get_wall_time();
+
+// skip if no analysis is scheduled at this step
+   if ( g_param_libyt.analysis_decided  &&  !g_param_libyt.analysis_due )
+   {
+      log_info( "No analysis is scheduled at step [%ld] ... skipped\n", g_param_libyt.counter );
+
+      end_analysis_step();
+      g_param_libyt.counter ++;
+
+      return YT_SUCCESS;
+   }
+
+   if ( !g_param_libyt.param_yt_set )
+      YT_ABORT( "Please invoke yt_set_parameter() before calling %s()!\n", "yt_inline" );
+
+
+// append all grids added on this rank and expose their field buffers
+   long num_grids = 0;
+
+   for (long g=0; g<g_param_yt.num_grids; g++)
+   {
+      if ( !g_param_libyt.grid_set[g] )   continue;
+
+      const yt_grid *grid      = g_grids + g;
+      const size_t   type_size = ( grid->field_ftype == YT_FLOAT ) ? sizeof(float) : sizeof(double);
+      const int64_t  data_size = (int64_t)grid->dimensions[0]*grid->dimensions[1]*grid->dimensions[2]*type_size;
+
+      int64_t nbytes = sizeof(yt_grid) + grid->num_fields*sizeof(staging_field);
+      for (int v=0; v<grid->num_fields; v++)   nbytes += strlen( grid->field_labels[v] ) + 1;
+
+      char *payload = append_record( STAGING_GRID, nbytes );
+      if ( payload == NULL )   return YT_FAIL;
+
+      memcpy( payload, grid, sizeof(yt_grid) );
+
+      staging_field *fields = (staging_field*)( payload + sizeof(yt_grid) );
+      char          *label  = (char*)( fields + grid->num_fields );
+
+      for (int v=0; v<grid->num_fields; v++)
+      {
+         if ( MPI_Win_attach( g_staging_win, grid->field_data[v], data_size ) != MPI_SUCCESS )
+            YT_ABORT( "Attaching grid [%ld] field \"%s\" to the RMA window ... failed!\n", g, grid->field_labels[v] );
+
+         MPI_Get_address( grid->field_data[v], &fields[v].address );
+         fields[v].nbytes = data_size;
+
+         memcpy( label, grid->field_labels[v], strlen( grid->field_labels[v] ) + 1 );
+         label += strlen( grid->field_labels[v] ) + 1;
+      }
+
+      num_grids ++;
+   }
+
+   ( (staging_message_header*)Message )->num_grids = num_grids;
+
+
+// send the metadata and wait until the analysis rank has pulled all field data
+   const int target = First_Analysis_Rank + Num_Staged % g_param_libyt.num_analysis_ranks;
+
+   if ( Message_Size > INT_MAX )
+      YT_ABORT( "Metadata message of %ld bytes is too large!\n", (long)Message_Size );
+
+   MPI_Send( Message, (int)Message_Size, MPI_BYTE, target, TAG_META, MPI_COMM_WORLD );
+   MPI_Recv( NULL, 0, MPI_BYTE, target, TAG_ACK, MPI_COMM_WORLD, MPI_STATUS_IGNORE );
+
+   for (long g=0; g<g_param_yt.num_grids; g++)
+   {
+      if ( !g_param_libyt.grid_set[g] )   continue;
+
+      for (int v=0; v<g_grids[g].num_fields; v++)   MPI_Win_detach( g_staging_win, g_grids[g].field_data[v] );
+   }
+
+   log_debug( "Staging %ld grids of step [%ld] to rank %d ... done (%.3f s)\n",
+              num_grids, g_param_libyt.counter, target, get_wall_time() - start );
+
+   Num_Staged ++;
+
+
+// flush the reduced output of this step (the I/O thread does the actual work)
+   if ( g_param_libyt.reduced_output_set  &&  reduced_output_flush() != YT_SUCCESS )
+      YT_ABORT( "Flushing the reduced output ... failed!\n" );
+
+   reset_step();
+
+   return YT_SUCCESS;
+
+} // FUNCTION : staging_inline
+
+
+
+//-------------------------------------------------------------------------------------------------------
+// Function    :  staging_serve
+// Description :  Main loop of the analysis ranks
+//
+// Note        :  1. Called by yt_run_analysis_server()
+//                2. For each step sent to this rank: receive the metadata message of every compute rank,
+//                   pull the field data from the RMA window of each compute rank, release that compute rank,
+//                   and then feed everything back into yt_set_parameter(), yt_add_user_parameter_*(),
+//                   yt_add_grid(), and yt_inline() on this rank
+//                3. YT parameters and user parameters are taken from the first compute rank
+//                4. Return once all compute ranks have called yt_finalize()
+//                5. A failed analysis does not stop the loop so that the compute ranks never hang
+//
+// Parameter   :  None
+//
+// Return      :  YT_SUCCESS or YT_FAIL (if any analysis failed)
+//-------------------------------------------------------------------------------------------------------
+int staging_serve()
+{
+
+   const int num_compute   = First_Analysis_Rank;
+   char    **messages      = new char*   [num_compute];
+   int      *message_sizes = new int     [num_compute];
+   long      num_steps     = 0;
+   long      num_failed    = 0;
+
+   while ( true )
+   {
+//    wait for the next step or the end of the simulation
+      MPI_Status mpi_status;
+      MPI_Probe( 0, MPI_ANY_TAG, MPI_COMM_WORLD, &mpi_status );
+
+      if ( mpi_status.MPI_TAG == TAG_FINISH )
+      {
+         for (int r=0; r<num_compute; r++)
+            MPI_Recv( NULL, 0, MPI_BYTE, r, TAG_FINISH, MPI_COMM_WORLD, MPI_STATUS_IGNORE );
+         break;
+      }
+
+      const double start  = get_wall_time();
+      int          status = YT_SUCCESS;
+
+
+//    receive the metadata of all compute ranks
+      long num_grids = 0;
+
+      for (int r=0; r<num_compute; r++)
+      {
+         MPI_Probe( r, TAG_META, MPI_COMM_WORLD, &mpi_status );
+         MPI_Get_count( &mpi_status, MPI_BYTE, message_sizes + r );
+
+         messages[r] = (char*)malloc( message_sizes[r] );
+         MPI_Recv( messages[r], message_sizes[r], MPI_BYTE, r, TAG_META, MPI_COMM_WORLD, MPI_STATUS_IGNORE );
+
+         num_grids += ( (const staging_message_header*)messages[r] )->num_grids;
+      }
+
+
+//    pull the field data of all compute ranks
+      yt_grid *grids = new yt_grid [num_grids];
+      num_grids = 0;
+
+      for (int r=0; r<num_compute; r++)
+      {
+         MPI_Win_lock( MPI_LOCK_SHARED, r, 0, g_staging_win );
+
+         for (int64_t offset=sizeof(staging_message_header); offset<message_sizes[r]; )
+         {
+            const staging_record_header *record = (const staging_record_header*)( messages[r] + offset );
+            char *payload = messages[r] + offset + sizeof(staging_record_header);
+
+            offset += sizeof(staging_record_header) + record->nbytes;
+
+            if ( record->kind != STAGING_GRID )   continue;
+
+            yt_grid *grid = grids + num_grids;
+            *grid = *(const yt_grid*)payload;
+
+            const staging_field *fields = (const staging_field*)( payload + sizeof(yt_grid) );
+            const char          *label  = (const char*)( fields + grid->num_fields );
+
+            grid->field_labels = new const char* [ grid->num_fields ];
+            grid->field_data   = new void*       [ grid->num_fields ];
+            grid->field_codec  = NULL;
+
+            for (int v=0; v<grid->num_fields; v++)
+            {
+               grid->field_labels[v] = label;
+               grid->field_data  [v] = malloc( fields[v].nbytes );
+               label += strlen( label ) + 1;
+
+               if ( transfer( grid->field_data[v], fields[v].nbytes, r, fields[v].address ) != YT_SUCCESS )
+               {
+                  log_error( "Pulling grid [%ld] field \"%s\" from rank %d ... failed!\n",
+                             grid->id, grid->field_labels[v], r );
+                  status = YT_FAIL;
+               }
+            }
+
+            num_grids ++;
+         }
+
+//       all field data have arrived after unlocking ==> the compute rank can leave yt_inline()
+         MPI_Win_unlock( r, g_staging_win );
+         MPI_Send( NULL, 0, MPI_BYTE, r, TAG_ACK, MPI_COMM_WORLD );
+      }
+
+      log_debug( "Pulling %ld grids from %d compute ranks ... done (%.3f s)\n",
+                 num_grids, num_compute, get_wall_time() - start );
+
+
+//    replay this step with the parameters of the first compute rank
+//    ==> the decision to perform analysis has been made by the compute ranks
+      g_param_libyt.counter                 = ( (const staging_message_header*)messages[0] )->counter;
+      g_param_libyt.analysis_decided        = true;
+      g_param_libyt.analysis_due            = true;
+      g_param_libyt.analysis_start_walltime = start;
+
+      for (int64_t offset=sizeof(staging_message_header); offset<message_sizes[0]  &&  status == YT_SUCCESS; )
+      {
+         const staging_record_header *record = (const staging_record_header*)( messages[0] + offset );
+         char *payload = messages[0] + offset + sizeof(staging_record_header);
+
+         offset += sizeof(staging_record_header) + record->nbytes;
+
+         if ( record->kind == STAGING_PARAM_YT )
+         {
+            yt_param_yt *param_yt = (yt_param_yt*)payload;
+            param_yt->frontend     = payload + sizeof(yt_param_yt);
+            param_yt->fig_basename = param_yt->frontend + strlen( param_yt->frontend ) + 1;
+            if ( param_yt->fig_basename[0] == '\0' )   param_yt->fig_basename = NULL;
+
+            status = yt_set_parameter( param_yt );
+         }
+
+         else if ( record->kind == STAGING_USER_PARAM )
+         {
+            const staging_user_param_header *param = (const staging_user_param_header*)payload;
+            const char *key  = payload + sizeof(staging_user_param_header);
+            const void *data = payload + padded( sizeof(staging_user_param_header) + param->key_size );
+
+            switch ( param->type )
+            {
+               case USER_PARAM_INT    : status = yt_add_user_parameter_int   ( key, param->n, (const int   *)data );   break;
+               case USER_PARAM_LONG   : status = yt_add_user_parameter_long  ( key, param->n, (const long  *)data );   break;
+               case USER_PARAM_UINT   : status = yt_add_user_parameter_uint  ( key, param->n, (const uint  *)data );   break;
+               case USER_PARAM_ULONG  : status = yt_add_user_parameter_ulong ( key, param->n, (const ulong *)data );   break;
+               case USER_PARAM_FLOAT  : status = yt_add_user_parameter_float ( key, param->n, (const float *)data );   break;
+               case USER_PARAM_DOUBLE : status = yt_add_user_parameter_double( key, param->n, (const double*)data );   break;
+               case USER_PARAM_STRING : status = yt_add_user_parameter_string( key, (const char*)data );              break;
+               default                : status = YT_FAIL;
+            }
+         }
+      }
+
+      for (long g=0; g<num_grids  &&  status == YT_SUCCESS; g++)   status = yt_add_grid( grids + g );
+
+      if ( status == YT_SUCCESS )   status = yt_inline();
+
+      num_steps ++;
+
+//    keep serving so that the compute ranks do not hang
+      if ( status != YT_SUCCESS )
+      {
+         log_error( "Analysis of step [%ld] on the analysis rank ... failed!\n", g_param_libyt.counter );
+         num_failed ++;
+      }
+
+
+//    free resources
+      for (long g=0; g<num_grids; g++)
+      {
+         for (int v=0; v<grids[g].num_fields; v++)   free( grids[g].field_data[v] );
+
+         delete [] grids[g].field_labels;
+         delete [] grids[g].field_data;
+      }
+      delete [] grids;
+
+      for (int r=0; r<num_compute; r++)   free( messages[r] );
+   } // while ( true )
+
+   delete [] messages;
+   delete [] message_sizes;
+
+   log_info( "Analysis server performed %ld analyses (%ld failed)\n", num_steps, num_failed );
+
+   return ( num_failed == 0 ) ? YT_SUCCESS : YT_FAIL;
+
+} // FUNCTION : staging_serve
+
+
+
+//-------------------------------------------------------------------------------------------------------
+// Function    :  append / append_record / append_user_param
+// Description :  Append data, a record header, or a user parameter to the metadata message
+//
+// Return      :  append/append_record : Pointer to the appended data/payload (zero-padded), NULL on error
+//                append_user_param    : YT_SUCCESS or YT_FAIL
+//-------------------------------------------------------------------------------------------------------
+static char *append( const void *data, const int64_t nbytes )
+{
+
+   const int64_t size = padded( nbytes );
+
+   if ( Message_Size + size > Message_Capacity )
+   {
+      const int64_t capacity = MAX( 2*Message_Capacity, Message_Size + size );
+      char *message = (char*)realloc( Message, capacity );
+
+      if ( message == NULL )
+      {
+         log_error( "Allocating %ld bytes for the staging metadata ... failed!\n", (long)capacity );
+         return NULL;
+      }
+
+      Message          = message;
+      Message_Capacity = capacity;
+   }
+
+   char *ptr = Message + Message_Size;
+   memset( ptr, 0, size );
+   if ( data != NULL )   memcpy( ptr, data, nbytes );
+
+   Message_Size += size;
+
+   return ptr;
+
+} // FUNCTION : append
+
+
+static char *append_record( const staging_kind kind, const int64_t nbytes )
+{
+
+   staging_record_header header;
+   header.kind    = kind;
+   header.padding = 0;
+   header.nbytes  = padded( nbytes );
+
+   if ( append( &header, sizeof(staging_record_header) ) == NULL )   return NULL;
+
+   return append( NULL, nbytes );
+
+} // FUNCTION : append_record
+
+
+static int append_user_param( const char *key, const int type, const int n, const void *input, const int data_size )
+{
+
+   staging_user_param_header header;
+   header.type      = type;
+   header.n         = n;
+   header.key_size  = strlen( key ) + 1;
+   header.data_size = data_size;
+
+   const int64_t head_size = sizeof(staging_user_param_header) + header.key_size;
+   char *payload = append_record( STAGING_USER_PARAM, padded(head_size) + data_size );
+
+   if ( payload == NULL )   YT_ABORT( "Staging code-specific parameter \"%s\" ... failed!\n", key );
+
+   memcpy( payload, &header, sizeof(staging_user_param_header) );
+   memcpy( payload + sizeof(staging_user_param_header), key, header.key_size );
+   memcpy( payload + padded(head_size), input, data_size );
+
+   return YT_SUCCESS;
+
+} // FUNCTION : append_user_param
+
+
+
+//-------------------------------------------------------------------------------------------------------
+// Function    :  transfer
+// Description :  Pull data from the RMA window of a compute rank
+//
+// Note        :  1. Must be called within a passive-target epoch of the target rank
+//                2. Split into chunks of at most INT_MAX bytes
+//
+// Parameter   :  buffer  : Destination buffer
+//                nbytes  : Number of bytes
+//                rank    : Target rank
+//                address : Address of the data on the target rank
+//
+// Return      :  YT_SUCCESS or YT_FAIL
+//-------------------------------------------------------------------------------------------------------
+static int transfer( void *buffer, const int64_t nbytes, const int rank, MPI_Aint address )
+{
+
+   if ( buffer == NULL  &&  nbytes > 0 )   return YT_FAIL;
+
+   for (int64_t done=0; done<nbytes; )
+   {
+      const int count = (int)MIN( nbytes - done, (int64_t)INT_MAX );
+
+      if ( MPI_Get( (char*)buffer + done, count, MPI_BYTE, rank, MPI_Aint_add( address, done ),
+                    count, MPI_BYTE, g_staging_win ) != MPI_SUCCESS )
+         return YT_FAIL;
+
+      done += count;
+   }
+
+   return YT_SUCCESS;
+
+} // FUNCTION : transfer
@@ -0,0 +1,108 @@
+#define NO_PYTHON
+#include "yt_combo.h"
+#undef NO_PYTHON
+
+
+
+
+//-------------------------------------------------------------------------------------------------------
+// Function    :  begin_step
+// Description :  Validate the YT parameters of this step and allocate the slots for staging grids
+//
+// Note        :  1. Called by yt_set_parameter() on the steps with analysis, in all of the in-process,
+//                   shared-memory, and staging modes
+//                2. Store "param_yt" to "g_param_yt" and allocate "g_param_libyt.grid_set" and "g_grids" so
+//                   that yt_add_grid() works as usual
+//                   ==> Those allocated by an earlier call at the same step are freed first
+//                3. Does not set "g_param_libyt.param_yt_set", which is set by the caller once all the
+//                   mode-specific work is done
+//                4. Grids left committed by a failed yt_inline() are withdrawn from the native routines
+//                   before being freed (see native_call_drain())
+//                5. Does not touch any Python object
+//
+// Parameter   :  param_yt : YT parameters passed to yt_set_parameter()
+//
+// Return      :  YT_SUCCESS or YT_FAIL
+//-------------------------------------------------------------------------------------------------------
+int begin_step( yt_param_yt *param_yt )
+{
+
+// reset all cosmological parameters to zero for non-cosmological datasets
+   if ( !param_yt->cosmological_simulation ) {
+      param_yt->current_redshift = param_yt->omega_lambda = param_yt->omega_matter = param_yt->hubble_constant = 0.0; }
+
+
+// check if all parameters have been set properly
+   if ( param_yt->validate() )
+      log_debug( "Validating YT parameters ... done\n" );
+   else
+      YT_ABORT(  "Validating YT parameters ... failed\n" );
+
+   g_param_yt = *param_yt;
+
+
+// withdraw the grids of the last step from the native routines and wait for the calls still reading them
+   g_param_libyt.grids_committed = false;
+   native_call_drain();
+
+
+// allocate the table recording the status of each grid and the slots for staging grids in yt_add_grid()
+   delete [] g_param_libyt.grid_set;
+   delete [] g_grids;
+
+   g_param_libyt.grid_set = new bool [ g_param_yt.num_grids ];
+
+   for (long g=0; g<g_param_yt.num_grids; g++)   g_param_libyt.grid_set[g] = false;
+
+   g_grids = new yt_grid [ g_param_yt.num_grids ];
+
+
+// discard the host IDs (see renumber_grids()) and the block pools left by a failed yt_inline()
+   grid_order_free();
+   block_pool_free();
+
+   return YT_SUCCESS;
+
+} // FUNCTION : begin_step
+
+
+
+//-------------------------------------------------------------------------------------------------------
+// Function    :  reset_step
+// Description :  Free the resources of this step to prepare for the next step
+//
+// Note        :  1. Called at the end of yt_inline() on the steps with analysis, in all of the in-process,
+//                   shared-memory, and staging modes
+//                   ==> yt_inline() must hold the GIL in the in-process mode
+//                2. Withdraw the grids from the native routines and wait for the calls still reading them
+//                   (see native_call_drain())
+//                3. Reset the YT parameters, advance the step counter, and free the staged grids, the
+//                   spatial index, the grid permutation, and the block pools
+//                4. Python objects of this step are cleared by yt_inline() itself
+//
+// Parameter   :  None
+//
+// Return      :  None
+//-------------------------------------------------------------------------------------------------------
+void reset_step()
+{
+
+   g_param_libyt.grids_committed = false;
+   native_call_drain();
+
+   g_param_yt.init();
+   g_param_libyt.param_yt_set = false;
+   g_param_libyt.counter ++;
+   end_analysis_step();
+
+   delete [] g_param_libyt.grid_set;
+   g_param_libyt.grid_set = NULL;
+
+   delete [] g_grids;
+   g_grids = NULL;
+
+   grid_index_free();
+   grid_order_free();
+   block_pool_free();
+
+} // FUNCTION : reset_step
@@ -0,0 +1,81 @@
+#include "yt_combo.h"
+
+
+
+
+//-------------------------------------------------------------------------------------------------------
+// Function    :  track_view
+// Description :  Track a NumPy array wrapping the simulation data
+//
+// Note        :  1. Called by get_grid_data() for each array in libyt.grid_data and by export_block_pools()
+//                2. A new reference is kept in "g_py_views" as a tuple (grid_id, field_label, array)
+//                   ==> After libyt.grid_data is cleared, this is the only expected reference of the array
+//
+// Parameter   :  grid_id : Grid ID
+//                label   : Field label
+//                view    : NumPy array wrapping the simulation data
+//
+// Return      :  None
+//-------------------------------------------------------------------------------------------------------
+void track_view( const long grid_id, const char *label, PyObject *view )
+{
+
+   if ( g_param_libyt.view_check == YT_VIEW_CHECK_OFF )   return;
+
+   PyObject *py_item = Py_BuildValue( "(lsO)", grid_id, label, view );
+
+   PyList_Append( g_py_views, py_item );
+   Py_DECREF( py_item );
+
+} // FUNCTION : track_view
+
+
+
+//-------------------------------------------------------------------------------------------------------
+// Function    :  release_views
+// Description :  Check whether Python still refers to any array tracked by track_view(), and release them
+//
+// Note        :  1. Called by yt_inline() after clearing all libyt dictionaries and collecting garbage,
+//                   right before returning control to the simulation, which may then overwrite or free
+//                   the wrapped memory
+//                2. Arrays with reference counts > 1 are still referred to by Python (e.g., by a global
+//                   variable, a cache in yt, a view of a slice, or a pending output task)
+//                3. Action depends on "g_param_libyt.view_check"
+//
+// Parameter   :  None
+//
+// Return      :  YT_SUCCESS or YT_FAIL (only if view_check == YT_VIEW_CHECK_ERROR and some views are alive)
+//-------------------------------------------------------------------------------------------------------
+int release_views()
+{
+
+   if ( g_param_libyt.view_check == YT_VIEW_CHECK_OFF )   return YT_SUCCESS;
+
+   const Py_ssize_t num_views = PyList_GET_SIZE( g_py_views );
+   long             num_alive = 0;
+
+   for (Py_ssize_t t=0; t<num_views; t++)
+   {
+      PyObject *py_item = PyList_GET_ITEM( g_py_views, t );
+      PyObject *py_view = PyTuple_GET_ITEM( py_item, 2 );
+
+      if ( Py_REFCNT( py_view ) > 1 )
+      {
+         num_alive ++;
+         log_warning( "NumPy array of grid [%ld] field \"%s\" is still referred to by Python (refcount = %ld)\n",
+                      PyInt_AsLong( PyTuple_GET_ITEM( py_item, 0 ) ), PyString_AsString( PyTuple_GET_ITEM( py_item, 1 ) ),
+                      (long)Py_REFCNT( py_view ) - 1 );
+      }
+   }
+
+   PyList_SetSlice( g_py_views, 0, num_views, NULL );
+
+   log_debug( "Releasing %ld NumPy arrays wrapping the simulation data ... done (%ld still alive)\n",
+              (long)num_views, num_alive );
+
+   if ( num_alive > 0  &&  g_param_libyt.view_check == YT_VIEW_CHECK_ERROR )
+      YT_ABORT( "%ld NumPy arrays wrapping the simulation data are still alive after yt_inline()!\n", num_alive );
+
+   return YT_SUCCESS;
+
+} // FUNCTION : release_views
@@ -0,0 +1,88 @@
+#include "yt_combo.h"
+#include "libyt.h"
+
+
+
+
+//-------------------------------------------------------------------------------------------------------
+// Function    :  yt_add_block_pool
+// Description :  Add a pool of equal-sized blocks stored in a single array
+//
+// Note        :  1. Block "b" is passed to yt_add_grid() as grid "first_id + b", with its field pointers
+//                   derived from "data" and the strides
+//                   ==> The grid filter, the grid ordering, and all transports apply as usual
+//                2. The pointer array of all blocks is allocated once and owned by libyt, so that users do
+//                   not need to keep one pointer array per block alive until yt_inline() returns
+//                3. The whole pool is also exported to libyt.block_pools as a single strided array
+//                   (see export_block_pools())
+//                4. Not thread-safe ==> call it once per pool instead of once per block
+//                5. "data", "left_edge", "right_edge", "level", "parent_id", and "particle_count" must
+//                   remain valid until yt_inline() returns
+//
+// Parameter   :  pool : Structure describing the block pool
+//
+// Return      :  YT_SUCCESS or YT_FAIL
+//-------------------------------------------------------------------------------------------------------
+int yt_add_block_pool( const yt_block_pool *pool )
+{
+
+// check if libyt has been initialized
+   if ( !g_param_libyt.libyt_initialized )
+      YT_ABORT( "Please invoke yt_init() before calling %s()!\n", __FUNCTION__ );
+
+
+// skip if no analysis is scheduled at this step
+   if ( g_param_libyt.analysis_decided  &&  !g_param_libyt.analysis_due )   return YT_SUCCESS;
+
+
+// check if YT parameters have been set
+   if ( !g_param_libyt.param_yt_set )
+      YT_ABORT( "Please invoke yt_set_parameter() before calling %s()!\n", __FUNCTION__ );
+
+
+// check if all parameters have been set properly
+   if ( pool->validate() )
+      log_debug( "Validating block pool ... done\n" );
+   else
+      YT_ABORT(  "Validating block pool ... failed\n" );
+
+   if ( pool->first_id + pool->num_blocks > g_param_yt.num_grids )
+      YT_ABORT( "Block pool grid IDs [%ld, %ld) exceed the total number of grids [%ld]!\n",
+                pool->first_id, pool->first_id + pool->num_blocks, g_param_yt.num_grids );
+
+
+// store the pool and derive the field pointers of all blocks
+   void       **field_data   = block_pool_register( pool );
+   const char **field_labels = block_pool_labels();
+
+
+// add each block as a grid
+   for (long b=0; b<pool->num_blocks; b++)
+   {
+      yt_grid grid;
+
+      for (int d=0; d<3; d++)
+      {
+         grid.left_edge [d] = pool->left_edge [b][d];
+         grid.right_edge[d] = pool->right_edge[b][d];
+         grid.dimensions[d] = pool->block_dims[d];
+      }
+
+      grid.particle_count = ( pool->particle_count == NULL ) ? 0  : pool->particle_count[b];
+      grid.id             = pool->first_id + b;
+      grid.parent_id      = ( pool->parent_id      == NULL ) ? -1 : pool->parent_id[b];
+      grid.level          = pool->level[b];
+      grid.num_fields     = pool->num_fields;
+      grid.field_labels   = field_labels;
+      grid.field_data     = field_data + b*pool->num_fields;
+      grid.field_ftype    = pool->field_ftype;
+
+      if ( yt_add_grid( &grid ) != YT_SUCCESS )
+         YT_ABORT( "Adding block [%ld] of the block pool ... failed!\n", b );
+   }
+
+   log_debug( "Adding %ld blocks of the block pool ... done\n", pool->num_blocks );
+
+   return YT_SUCCESS;
+
+} // FUNCTION : yt_add_block_pool
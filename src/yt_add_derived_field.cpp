@@ -0,0 +1,90 @@
+#include "yt_combo.h"
+#include "libyt.h"
+#include <string.h>
+
+
+static void append_derived_field( const yt_derived_field *field );
+
+
+
+
+//-------------------------------------------------------------------------------------------------------
+// Function    :  yt_add_derived_field
+// Description :  Register a derived field computed by a native kernel
+//
+// Note        :  1. The derived field of a grid is computed when Python calls
+//                   "libyt.derived_field( grid_id, name )", and is cached until the end of yt_inline()
+//                   ==> Kernels are evaluated directly on the simulation data without creating any
+//                       temporary NumPy array
+//                2. Can be called any time after yt_init(). Registered fields persist across steps.
+//                   ==> The list is replaced with the GIL held after waiting for the native calls in flight,
+//                       since the output workers may be evaluating derived fields (see native_call_drain())
+//                3. "name" is copied, while the pointer array "input_labels" must remain valid until
+//                   yt_finalize()
+//
+// Parameter   :  field : Structure describing the derived field
+//
+// Return      :  YT_SUCCESS or YT_FAIL
+//-------------------------------------------------------------------------------------------------------
+int yt_add_derived_field( const yt_derived_field *field )
+{
+
+// check if libyt has been initialized
+   if ( !g_param_libyt.libyt_initialized )
+      YT_ABORT( "Please invoke yt_init() before calling %s()!\n", __FUNCTION__ );
+
+
+// check if all parameters have been set properly
+   if ( !field->validate() )
+      YT_ABORT( "Validating derived field ... failed\n" );
+
+
+// check if this field has been registered previously
+   if ( find_derived_field( field->name ) != NULL )
+      YT_ABORT( "Derived field \"%s\" has been registered already!\n", field->name );
+
+
+// append to the list of derived fields
+// ==> the compute ranks and the shared-memory transport do not run Python and thus have no native call
+   if ( g_param_libyt.external  ||  g_param_libyt.staging )
+      append_derived_field( field );
+   else
+   {
+      yt_gil_guard gil;
+      native_call_drain();
+      append_derived_field( field );
+   }
+
+   log_debug( "Registering derived field \"%s\" with %d input field(s) ... done\n", field->name, field->num_inputs );
+
+
+   return YT_SUCCESS;
+
+} // FUNCTION : yt_add_derived_field
+
+
+
+//-------------------------------------------------------------------------------------------------------
+// Function    :  append_derived_field
+// Description :  Append a copy of "field" with its own copy of the name to "g_derived_fields"
+//
+// Note        :  1. Names are free'd by yt_finalize()
+//
+// Parameter   :  field : Structure describing the derived field
+//
+// Return      :  None
+//-------------------------------------------------------------------------------------------------------
+static void append_derived_field( const yt_derived_field *field )
+{
+
+   yt_derived_field *derived_fields = new yt_derived_field [ g_num_derived_fields + 1 ];
+
+   for (int f=0; f<g_num_derived_fields; f++)   derived_fields[f] = g_derived_fields[f];
+   derived_fields[ g_num_derived_fields ]      = *field;
+   derived_fields[ g_num_derived_fields ].name = strdup( field->name );
+
+   delete [] g_derived_fields;
+   g_derived_fields = derived_fields;
+   g_num_derived_fields ++;
+
+} // FUNCTION : append_derived_field
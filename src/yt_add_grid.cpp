@@ -11,12 +11,24 @@
 // Note        :  1. Store the input "grid" to libyt.hierarchy and libyt.grid_data
 //                2. Must call yt_set_parameter() in advance, which will set the total number of grids and
 //                   preallocate memory for NumPy arrays
+//                3. Thread-safe ==> can be called concurrently for different grids (e.g., in an OpenMP
+//                   parallel region)
+//                   --> This function does not touch any Python object. The input grid is copied to
+//                       "g_grids[grid->id]" and exported to Python in bulk by commit_grids() when calling
+//                       yt_inline().
+//                   --> The pointer arrays "field_labels" and "field_data" must remain valid until
+//                       yt_inline() returns
+//                4. Fields encoded by "field_codec" are decoded on access (see decode_cache.cpp)
+//                5. "num_fields", "field_labels", and "field_ftype" are filled by the declared fields if
+//                   "field_labels" is not set (see yt_declare_fields())
+//                   ==> Only the staged copy is filled, and the input "grid" is left unchanged so that it can
+//                       be reused after the fields are declared again
 //
-// Parameter   :  grid : Structure storing all information of a single grid
+// Parameter   :  input : Structure storing all information of a single grid
 //
 // Return      :  YT_SUCCESS or YT_FAIL
 //-------------------------------------------------------------------------------------------------------
-int yt_add_grid( yt_grid *grid )
+int yt_add_grid( yt_grid *input )
 {
 
 // check if libyt has been initialized
@@ -24,16 +36,82 @@ int yt_add_grid( yt_grid *grid )
       YT_ABORT( "Please invoke yt_init() before calling %s()!\n", __FUNCTION__ );
 
 
+// skip if no analysis is scheduled at this step
+   if ( g_param_libyt.analysis_decided  &&  !g_param_libyt.analysis_due )   return YT_SUCCESS;
+
+
 // check if YT parameters have been set
    if ( !g_param_libyt.param_yt_set )
       YT_ABORT( "Please invoke yt_set_parameter() before calling %s()!\n", __FUNCTION__ );
 
 
+// use the declared fields for the grids that do not set their own labels (see yt_declare_fields())
+   yt_grid  staged = *input;
+   yt_grid *grid   = &staged;
+
+   if ( g_num_fields > 0  &&  grid->field_labels == NULL )
+   {
+      if ( grid->num_fields  == INT_UNDEFINED    )   grid->num_fields  = g_num_fields;
+      if ( grid->field_ftype == YT_FTYPE_UNKNOWN )   grid->field_ftype = g_fields_ftype;
+      grid->field_labels = field_registry_labels();
+   }
+
+
 // check if all parameters have been set properly
    if ( !grid->validate() )
       YT_ABORT(  "Validating input grid [%ld] ... failed\n", grid->id );
 
 
+// grids must only contain the declared fields
+   if ( g_num_fields > 0 )
+   {
+      if ( grid->field_labels == field_registry_labels() )
+      {
+         if ( grid->num_fields > g_num_fields )
+            YT_ABORT( "Grid [%ld] has %d fields > number of declared fields [%d]!\n",
+                      grid->id, grid->num_fields, g_num_fields );
+      }
+
+      else
+      {
+         for (int v=0; v<grid->num_fields; v++)
+            if ( field_registry_find( grid->field_labels[v] ) < 0 )
+               YT_ABORT( "Field \"%s\" of grid [%ld] has not been declared!\n", grid->field_labels[v], grid->id );
+      }
+
+      if ( grid->field_ftype != g_fields_ftype )
+         YT_ABORT( "Grid [%ld] field type [%d] != declared field type [%d]!\n",
+                   grid->id, grid->field_ftype, g_fields_ftype );
+   }
+
+
+// encoded fields are only decoded for libyt.grid_data and the native analysis routines
+// ==> same for the fields that are not cell-centered, which can only be accessed in libyt.grid_data
+   bool encoded = false, staggered = false;
+   for (int v=0; v<grid->num_fields; v++)
+   {
+      const bool field_encoded   = ( field_encoding ( grid, v ) != YT_ENCODING_NONE  );
+      const bool field_staggered = ( field_centering( grid, v ) != YT_CELL_CENTERED );
+
+      if ( field_encoded  &&  field_staggered )
+         YT_ABORT( "Field \"%s\" of grid [%ld] cannot be both encoded and not cell-centered!\n",
+                   grid->field_labels[v], grid->id );
+
+      if ( field_encoded   )   encoded   = true;
+      if ( field_staggered )   staggered = true;
+   }
+
+   if ( staggered  &&  ( g_param_libyt.capture != NULL  ||  g_param_libyt.reduced_output_set  ||
+                         g_param_libyt.external  ||  g_param_libyt.staging ) )
+      YT_ABORT( "Grid [%ld] has fields that are not cell-centered, which are not supported by the capture, "
+                "the reduced output, the shared-memory server, or the analysis ranks!\n", grid->id );
+
+   if ( encoded  &&  ( g_param_libyt.capture != NULL  ||  g_param_libyt.reduced_output_set  ||
+                       g_param_libyt.external  ||  g_param_libyt.staging ) )
+      YT_ABORT( "Grid [%ld] has encoded fields, which are not supported by the capture, the reduced output, "
+                "the shared-memory server, or the analysis ranks!\n", grid->id );
+
+
 // additional checks that depend on input YT parameters
 // grid ID
    if ( grid->id >= g_param_yt.num_grids )
@@ -60,71 +138,34 @@ int yt_add_grid( yt_grid *grid )
                    grid->id, grid->right_edge[d], g_param_yt.domain_right_edge[d], d );
    }
 
+// compact hierarchy
+   long left_index[3];
+   if ( g_param_libyt.compact_hierarchy  &&  get_left_index( grid, left_index ) == YT_FAIL )
+      YT_ABORT( "Grid [%ld] cannot be stored in the compact hierarchy!\n", grid->id );
+
 
 // check if this grid has been set previously
-   if ( g_param_libyt.grid_set[ grid->id ] == true )
+// ==> use an atomic exchange so that concurrent calls with the same grid ID are detected as well
+   if ( __atomic_exchange_n( &g_param_libyt.grid_set[ grid->id ], true, __ATOMIC_ACQ_REL ) == true )
       YT_ABORT( "Grid [%ld] has been set already!\n", grid->id );
 
 
-// export grid info to libyt.hierarchy
-   PyArrayObject *py_array_obj;
-
-// convenient macro
-// note that PyDict_GetItemString() returns a **borrowed** reference ==> no need to call Py_DECREF
-#  define FILL_ARRAY( KEY, ARRAY, DIM, TYPE )                                                            \
-   {                                                                                                     \
-      for (int t=0; t<DIM; t++)                                                                          \
-      {                                                                                                  \
-         if (  ( py_array_obj = (PyArrayObject*)PyDict_GetItemString( g_py_hierarchy, KEY ) ) == NULL )  \
-            YT_ABORT( "Accessing the key \"%s\" from libyt.hierarchy ... failed!\n", KEY );              \
-                                                                                                         \
-         *(TYPE*)PyArray_GETPTR2( py_array_obj, grid->id, t ) = (TYPE)(ARRAY)[t];                        \
-      }                                                                                                  \
-   }
-
-   FILL_ARRAY( "grid_left_edge",       grid->left_edge,      3, npy_double );
-   FILL_ARRAY( "grid_right_edge",      grid->right_edge,     3, npy_double );
-   FILL_ARRAY( "grid_dimensions",      grid->dimensions,     3, npy_long   );
-   FILL_ARRAY( "grid_particle_count", &grid->particle_count, 1, npy_long   );
-   FILL_ARRAY( "grid_parent_id",      &grid->parent_id,      1, npy_long   );
-   FILL_ARRAY( "grid_levels",         &grid->level,          1, npy_long   );
-
-   log_debug( "Inserting grid [%15ld] info to libyt.hierarchy ... done\n", grid->id );
-
-
-// export grid data to libyt.grid_data as "libyt.grid_data[grid_id][field_label][field_data]"
-   int      grid_ftype   = (grid->field_ftype == YT_FLOAT ) ? NPY_FLOAT : NPY_DOUBLE;
-   npy_intp grid_dims[3] = { grid->dimensions[0], grid->dimensions[1], grid->dimensions[2] };
-   PyObject *py_grid_id, *py_field_labels, *py_field_data;
-
-// allocate [grid_id][field_label]
-   py_grid_id      = PyLong_FromLong( grid->id );
-   py_field_labels = PyDict_New();
-
-   PyDict_SetItem( g_py_grid_data, py_grid_id, py_field_labels );
-
-// fill [grid_id][field_label][field_data]
-   for (int v=0; v<grid->num_fields; v++)
+// stage the grid in the slot reserved for it unless it is rejected by the grid filter
+// ==> different threads always write to different slots, so no lock is required
+// ==> libyt.hierarchy and libyt.grid_data are filled later by commit_grids() in yt_inline()
+   if ( grid_filter_accept( grid ) )
    {
-//    PyArray_SimpleNewFromData simply creates an array wrapper and does note allocate and own the array
-      py_field_data = PyArray_SimpleNewFromData( 3, grid_dims, grid_ftype, grid->field_data[v] );
-
-//    add the field data to "libyt.grid_data[grid_id][field_label]"
-      PyDict_SetItemString( py_field_labels, grid->field_labels[v], py_field_data );
+      g_grids[ grid->id ] = *grid;
 
-//    call decref since PyDict_SetItemString() returns a new reference
-      Py_DECREF( py_field_data );
+      log_debug( "Staging grid [%15ld] ... done\n", grid->id );
    }
-
-// call decref since both PyLong_FromLong() and PyDict_New() return a new reference
-   Py_DECREF( py_grid_id );
-   Py_DECREF( py_field_labels );
-
-   log_debug( "Inserting grid [%15ld] data to libyt.hierarchy ... done\n", grid->id );
+   else
+      log_debug( "Staging grid [%15ld] ... rejected by the grid filter\n", grid->id );
 
 
-// record that the grid "grid->id" has been set successfully
-   g_param_libyt.grid_set[ grid->id ] = true;
+// dump reduced data products
+   if ( g_param_libyt.reduced_output_set  &&  reduced_output_add_grid( grid ) != YT_SUCCESS )
+      YT_ABORT( "Adding grid [%ld] to the reduced output ... failed!\n", grid->id );
 
 
    return YT_SUCCESS;
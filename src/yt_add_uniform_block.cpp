@@ -0,0 +1,68 @@
+#include "yt_combo.h"
+#include "libyt.h"
+
+
+
+
+//-------------------------------------------------------------------------------------------------------
+// Function    :  yt_add_uniform_block
+// Description :  Add a block of the uniform decomposition set by yt_set_uniform_decomposition()
+//
+// Note        :  1. Edges, dimensions, level (0), parent ID (-1), and particle count (0) are derived from the
+//                   block ID and the decomposition, and the block is then passed to yt_add_grid()
+//                   ==> The grid filter, the grid ordering, and all transports apply as usual
+//                2. Fields are those declared by yt_declare_fields(), and "field_data" points to their data
+//                   in the declaration order
+//                   ==> Number of fields, field labels, and field type are filled by yt_add_grid()
+//                3. Thread-safe as yt_add_grid()
+//                4. The pointer array "field_data" must remain valid until yt_inline() returns
+//                5. Edges of the outermost blocks are set to the domain edges exactly
+//
+// Parameter   :  block_id   : Block ID ==> ( i*blocks[1] + j )*blocks[2] + k
+//                field_data : Pointer array pointing to the data of each declared field
+//
+// Return      :  YT_SUCCESS or YT_FAIL
+//-------------------------------------------------------------------------------------------------------
+int yt_add_uniform_block( const long block_id, void **field_data )
+{
+
+// check if the decomposition and the fields have been set
+   if ( !g_param_libyt.uniform_set )
+      YT_ABORT( "Please invoke yt_set_uniform_decomposition() before calling %s()!\n", __FUNCTION__ );
+
+   if ( g_num_fields == 0 )
+      YT_ABORT( "Please invoke yt_declare_fields() before calling %s()!\n", __FUNCTION__ );
+
+   const int *blocks     = g_param_libyt.uniform_blocks;
+   const int *block_dims = g_param_libyt.uniform_block_dims;
+
+   if ( block_id < 0  ||  block_id >= (long)blocks[0]*blocks[1]*blocks[2] )
+      YT_ABORT( "Block ID [%ld] is not in the range [0, %ld)!\n", block_id, (long)blocks[0]*blocks[1]*blocks[2] );
+
+
+// derive the grid geometry
+   const long index[3] = { block_id / ( (long)blocks[1]*blocks[2] ),
+                           block_id / blocks[2] % blocks[1],
+                           block_id % blocks[2] };
+   yt_grid grid;
+
+   for (int d=0; d<3; d++)
+   {
+      const double dh = ( g_param_yt.domain_right_edge[d] - g_param_yt.domain_left_edge[d] ) / blocks[d];
+
+      grid.left_edge [d] = ( index[d] == 0           ) ? g_param_yt.domain_left_edge [d]
+                                                       : g_param_yt.domain_left_edge[d] + dh*index[d];
+      grid.right_edge[d] = ( index[d] == blocks[d]-1 ) ? g_param_yt.domain_right_edge[d]
+                                                       : g_param_yt.domain_left_edge[d] + dh*( index[d] + 1 );
+      grid.dimensions[d] = block_dims[d];
+   }
+
+   grid.particle_count = 0;
+   grid.id             = block_id;
+   grid.parent_id      = -1;
+   grid.level          = 0;
+   grid.field_data     = field_data;
+
+   return yt_add_grid( &grid );
+
+} // FUNCTION : yt_add_uniform_block
@@ -52,6 +52,16 @@ static int add_nonstring( const char *key, const int n, const T *input )
    if ( !g_param_libyt.libyt_initialized )
       YT_ABORT( "Please invoke yt_init() before calling %s()!\n", __FUNCTION__ );
 
+   if ( g_param_libyt.external )   return shm_user_param( key, n, input );
+#  ifdef SUPPORT_MPI
+   if ( g_param_libyt.staging )   return staging_user_param( key, n, input );
+#  endif
+
+// skip if no analysis is scheduled at this step (before acquiring the GIL)
+   if ( g_param_libyt.analysis_decided  &&  !g_param_libyt.analysis_due )   return YT_SUCCESS;
+
+   yt_gil_guard gil;
+
 
 // export data to libyt.param_user
    if (  typeid(T) == typeid(float)  ||  typeid(T) == typeid(double)  ||
@@ -73,6 +83,10 @@ static int add_nonstring( const char *key, const int n, const T *input )
 
    log_debug( "Inserting code-specific parameter \"%-*s\" ... done\n", MaxParamNameWidth, key );
 
+
+// record the input parameter for yt_replay()
+   if ( capture_user_param( key, n, input ) == YT_FAIL )   return YT_FAIL;
+
    return YT_SUCCESS;
 
 } // FUNCTION : add_nonstring
@@ -89,6 +103,16 @@ static int add_string( const char *key, const char *input )
    if ( !g_param_libyt.libyt_initialized )
       YT_ABORT( "Please invoke yt_init() before calling %s()!\n", __FUNCTION__ );
 
+   if ( g_param_libyt.external )   return shm_user_param_string( key, input );
+#  ifdef SUPPORT_MPI
+   if ( g_param_libyt.staging )   return staging_user_param_string( key, input );
+#  endif
+
+// skip if no analysis is scheduled at this step (before acquiring the GIL)
+   if ( g_param_libyt.analysis_decided  &&  !g_param_libyt.analysis_due )   return YT_SUCCESS;
+
+   yt_gil_guard gil;
+
 
 // export data to libyt.param_user
    if ( add_dict_string( g_py_param_user, key, input ) == YT_FAIL )   return YT_FAIL;
@@ -96,6 +120,10 @@ static int add_string( const char *key, const char *input )
 
    log_debug( "Inserting code-specific parameter \"%-*s\" ... done\n", MaxParamNameWidth, key );
 
+
+// record the input parameter for yt_replay()
+   if ( capture_user_param_string( key, input ) == YT_FAIL )   return YT_FAIL;
+
    return YT_SUCCESS;
 
 } // FUNCTION : add_string
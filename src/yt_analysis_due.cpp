@@ -0,0 +1,50 @@
+#include "yt_combo.h"
+#include "libyt.h"
+
+
+
+
+//-------------------------------------------------------------------------------------------------------
+// Function    :  yt_analysis_due
+// Description :  Return whether inline analysis will be performed at this step
+//
+// Note        :  1. Schedule is set by "analysis_interval_*" and "analysis_predicate" in yt_param_libyt
+//                2. Simulation codes can keep calling yt_set_parameter(), yt_add_user_parameter_*(),
+//                   yt_add_grid(), and yt_inline() unconditionally since they are no-ops on the steps
+//                   without analysis. This function is useful for skipping the preparation of grids
+//                   on the simulation side.
+//                3. The decision of this step is fixed once this function or yt_set_parameter() is called
+//                   ==> If called before yt_set_parameter(), the simulation-time criterion is evaluated with
+//                       the time passed to yt_set_parameter() at the previous step
+//                4. The decision is only renewed by yt_inline(), which must thus be called on every step even
+//                   if this function returns 0:
+//
+//                   if ( yt_analysis_due() ) { /* prepare grids */  yt_set_parameter(...); yt_add_grid(...); }
+//                   yt_inline();
+//
+//                   ==> An error is logged if this function is called again before yt_inline(), which
+//                       returns the stale decision of the step that has not been ended yet
+//
+// Parameter   :  None
+//
+// Return      :  1 ==> analysis is due at this step
+//                0 ==> analysis is skipped at this step (or libyt has not been initialized)
+//-------------------------------------------------------------------------------------------------------
+int yt_analysis_due()
+{
+
+// check if libyt has been initialized
+   if ( !g_param_libyt.libyt_initialized )
+   {
+      log_error( "Please invoke yt_init() before calling %s()!\n", __FUNCTION__ );
+      return 0;
+   }
+
+// a decision reused without calling yt_inline() is stale if the host has moved on to the next step
+   if ( ++g_param_libyt.analysis_queries == 2 )
+      log_error( "%s() is called again before yt_inline() ==> reusing the decision of step [%ld]! "
+                 "Please call yt_inline() on every step.\n", __FUNCTION__, g_param_libyt.counter );
+
+   return ( decide_analysis( FLT_UNDEFINED ) ) ? 1 : 0;
+
+} // FUNCTION : yt_analysis_due
@@ -0,0 +1,75 @@
+#include "yt_combo.h"
+#include "libyt.h"
+
+
+
+
+//-------------------------------------------------------------------------------------------------------
+// Function    :  yt_declare_fields
+// Description :  Declare the fields of all grids once
+//
+// Note        :  1. Grids passed to yt_add_grid() can then leave "num_fields", "field_labels", and
+//                   "field_ftype" unset, and only set "field_data" as a pointer array indexed by the
+//                   declared field index
+//                   ==> Grids can still set their own labels, which must then be declared fields
+//                2. libyt.grid_data then uses one interned key per field for all grids, and the declared
+//                   fields are exported to libyt.field_list
+//                3. All fields share the floating-point type "field_ftype", which is the type stored in
+//                   "yt_grid::field_ftype"
+//                4. Fields that are not cell-centered are only available in libyt.grid_data, and are not
+//                   supported by the native analysis routines, capture, the reduced output, the
+//                   shared-memory server, or the analysis ranks
+//                5. Must be called after yt_init() and before yt_set_parameter(), and stays effective until
+//                   it is called again
+//                6. Pass num_fields = 0 to remove the declaration
+//
+// Parameter   :  num_fields  : Number of fields
+//                fields      : Array of fields
+//                field_ftype : Floating-point type of all fields ==> YT_FLOAT or YT_DOUBLE
+//                              (ignored when num_fields = 0)
+//
+// Return      :  YT_SUCCESS or YT_FAIL
+//-------------------------------------------------------------------------------------------------------
+int yt_declare_fields( const int num_fields, const yt_field *fields, const yt_ftype field_ftype )
+{
+
+// check if libyt has been initialized
+   if ( g_param_libyt.libyt_initialized )
+      log_info( "Declaring %d field(s) ...\n", num_fields );
+   else
+      YT_ABORT( "Please invoke yt_init() before calling %s()!\n", __FUNCTION__ );
+
+   if ( g_param_libyt.param_yt_set )
+      YT_ABORT( "Please invoke %s() before yt_set_parameter()!\n", __FUNCTION__ );
+
+   if ( num_fields < 0 )
+      YT_ABORT( "\"%s\" == %d < 0!\n", "num_fields", num_fields );
+
+
+// remove the declaration
+   if ( num_fields == 0 )
+   {
+      field_registry_free();
+
+      log_debug( "Removing declared fields ... done\n" );
+      return YT_SUCCESS;
+   }
+
+   if ( fields == NULL )
+      YT_ABORT( "\"%s\" has not been set!\n", "fields" );
+
+
+// store user-provided fields to a libyt internal variable
+   if ( field_registry_init( num_fields, fields, field_ftype ) )
+      log_debug( "Storing declared fields ... done\n" );
+   else
+      YT_ABORT(  "Storing declared fields ... failed!\n" );
+
+   log_debug( "   Floating-point type: %s\n", ( g_fields_ftype == YT_FLOAT ) ? "float32" : "float64" );
+
+   for (int v=0; v<num_fields; v++)
+      log_debug( "   [%2d] %-20s %s\n", v, g_fields[v].field_name, g_fields[v].field_unit );
+
+   return YT_SUCCESS;
+
+} // FUNCTION : yt_declare_fields
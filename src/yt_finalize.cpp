@@ -23,9 +23,63 @@ int yt_finalize()
 // check whether libyt has been initialized
    if ( !g_param_libyt.libyt_initialized )   YT_ABORT( "Calling yt_finalize() before yt_init()!\n" );
 
+// wait until all reduced data products have been written
+   if ( g_param_libyt.reduced_output_set )
+   {
+      if ( reduced_output_finalize() != YT_SUCCESS )   YT_ABORT( "Finalizing the reduced output ... failed!\n" );
+
+      g_param_libyt.reduced_output_set = false;
+   }
+
+// close the capture file
+   if ( capture_close() != YT_SUCCESS )   YT_ABORT( "Closing the capture file ... failed!\n" );
+
+// execute all pending output tasks
+   output_pool_finalize();
+
+// wait for the external server and remove the shared-memory segments
+   if ( g_param_libyt.external )
+   {
+      if ( shm_finalize() != YT_SUCCESS )   YT_ABORT( "Closing the shared-memory transport ... failed!\n" );
+
+      g_param_libyt.libyt_initialized = false;
+      return YT_SUCCESS;
+   }
+
+// release the analysis ranks
+#  ifdef SUPPORT_MPI
+   const bool staging = g_param_libyt.staging;
+
+   if ( staging_finalize() != YT_SUCCESS )   YT_ABORT( "Finalizing the staging mode ... failed!\n" );
+
+// compute ranks never initialize Python
+   if ( staging )
+   {
+      g_param_libyt.libyt_initialized = false;
+      return YT_SUCCESS;
+   }
+#  endif
+
 // free all libyt resources
+// ==> Py_Finalize() must be called by the main thread holding the GIL
+   PyEval_RestoreThread( g_py_main_tstate );
+   g_py_main_tstate = NULL;
+
+   analysis_task_free();
+
    Py_Finalize();
 
+   for (int f=0; f<g_num_derived_fields; f++)   free( (char*)g_derived_fields[f].name );
+   delete [] g_derived_fields;
+   g_derived_fields     = NULL;
+   g_num_derived_fields = 0;
+
+   grid_filter_free();
+   g_param_libyt.grid_filter_set = false;
+
+   block_pool_free();
+   field_registry_free();
+
    g_param_libyt.libyt_initialized = false;
    return YT_SUCCESS;
 
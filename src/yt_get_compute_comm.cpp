@@ -0,0 +1,34 @@
+#define NO_PYTHON
+#include "yt_combo.h"
+#undef NO_PYTHON
+#include "libyt.h"
+
+
+
+
+//-------------------------------------------------------------------------------------------------------
+// Function    :  yt_get_compute_comm
+// Description :  Return the communicator to be used by the simulation
+//
+// Note        :  1. In the staging mode, it contains all compute ranks and excludes the analysis ranks
+//                   ==> The simulation must use it instead of MPI_COMM_WORLD
+//                   ==> On the analysis ranks, it contains all analysis ranks
+//                2. MPI_COMM_WORLD if the staging mode is disabled
+//                3. Owned by libyt and freed by yt_finalize()
+//
+// Parameter   :  comm : Communicator to be returned
+//
+// Return      :  YT_SUCCESS or YT_FAIL
+//-------------------------------------------------------------------------------------------------------
+int yt_get_compute_comm( MPI_Comm *comm )
+{
+
+// check if libyt has been initialized
+   if ( !g_param_libyt.libyt_initialized )
+      YT_ABORT( "Please invoke yt_init() before calling %s()!\n", __FUNCTION__ );
+
+   *comm = g_compute_comm;
+
+   return YT_SUCCESS;
+
+} // FUNCTION : yt_get_compute_comm
@@ -37,11 +37,104 @@ int yt_init( int argc, char *argv[], const yt_param_libyt *param_libyt )
 // --> better do it **before** calling any log function since they will query g_param_libyt.verbose
    g_param_libyt.verbose = param_libyt->verbose;
    g_param_libyt.script  = param_libyt->script;
+   g_param_libyt.capture = param_libyt->capture;
+   g_param_libyt.analysis_interval_step     = param_libyt->analysis_interval_step;
+   g_param_libyt.analysis_interval_time     = param_libyt->analysis_interval_time;
+   g_param_libyt.analysis_interval_walltime = param_libyt->analysis_interval_walltime;
+   g_param_libyt.analysis_predicate         = param_libyt->analysis_predicate;
+   g_param_libyt.analysis_time_budget       = param_libyt->analysis_time_budget;
+   g_param_libyt.analysis_overhead_target   = param_libyt->analysis_overhead_target;
+   g_param_libyt.analysis_slice_time        = param_libyt->analysis_slice_time;
+   g_param_libyt.compact_hierarchy          = param_libyt->compact_hierarchy;
+   g_param_libyt.output_threads             = param_libyt->output_threads;
+   g_param_libyt.output_queue_size          = param_libyt->output_queue_size;
+   g_param_libyt.gc_policy                  = param_libyt->gc_policy;
+   g_param_libyt.view_check                 = param_libyt->view_check;
+   g_param_libyt.num_analysis_ranks         = param_libyt->num_analysis_ranks;
+   g_param_libyt.shm_name                   = param_libyt->shm_name;
+   g_param_libyt.shm_slots                  = param_libyt->shm_slots;
+   g_param_libyt.decode_cache_mb            = param_libyt->decode_cache_mb;
+   g_param_libyt.grid_order                 = param_libyt->grid_order;
+   g_param_libyt.ring_buffer_depth          = param_libyt->ring_buffer_depth;
+   g_param_libyt.ring_buffer_mb             = param_libyt->ring_buffer_mb;
+   g_param_libyt.parallel_workers           = param_libyt->parallel_workers;
    g_param_libyt.counter = param_libyt->counter;   // useful during restart, where the initial counter can be non-zero
 
    log_info( "Initializing libyt ...\n" );
    log_debug( "   verbose = %d\n", g_param_libyt.verbose );
    log_debug( "   script  = %s\n", g_param_libyt.script );
+   log_debug( "   capture = %s\n", ( g_param_libyt.capture == NULL ) ? "NULL" : g_param_libyt.capture );
+   log_debug( "   analysis_interval_step     = %ld\n",    g_param_libyt.analysis_interval_step );
+   log_debug( "   analysis_interval_time     = %13.7e\n", g_param_libyt.analysis_interval_time );
+   log_debug( "   analysis_interval_walltime = %13.7e\n", g_param_libyt.analysis_interval_walltime );
+   log_debug( "   analysis_predicate         = %s\n",     ( g_param_libyt.analysis_predicate == NULL ) ? "NULL" : "set" );
+   log_debug( "   analysis_time_budget       = %13.7e\n", g_param_libyt.analysis_time_budget );
+   log_debug( "   analysis_overhead_target   = %13.7e\n", g_param_libyt.analysis_overhead_target );
+   log_debug( "   analysis_slice_time        = %13.7e\n", g_param_libyt.analysis_slice_time );
+   log_debug( "   compact_hierarchy          = %d\n",     g_param_libyt.compact_hierarchy );
+   log_debug( "   output_threads             = %d\n",     g_param_libyt.output_threads );
+   log_debug( "   output_queue_size          = %d\n",     g_param_libyt.output_queue_size );
+   log_debug( "   gc_policy                  = %d\n",     g_param_libyt.gc_policy );
+   log_debug( "   view_check                 = %d\n",     g_param_libyt.view_check );
+   log_debug( "   num_analysis_ranks         = %d\n",     g_param_libyt.num_analysis_ranks );
+   log_debug( "   shm_name                   = %s\n",     ( g_param_libyt.shm_name == NULL ) ? "NULL" : g_param_libyt.shm_name );
+   log_debug( "   shm_slots                  = %d\n",     g_param_libyt.shm_slots );
+   log_debug( "   decode_cache_mb            = %13.7e\n", g_param_libyt.decode_cache_mb );
+   log_debug( "   grid_order                 = %d\n",     g_param_libyt.grid_order );
+   log_debug( "   ring_buffer_depth          = %d\n",     g_param_libyt.ring_buffer_depth );
+   log_debug( "   ring_buffer_mb             = %13.7e\n", g_param_libyt.ring_buffer_mb );
+   log_debug( "   parallel_workers           = %d\n",     g_param_libyt.parallel_workers );
+
+   if ( g_param_libyt.analysis_overhead_target < 0.0  ||  g_param_libyt.analysis_overhead_target >= 1.0 )
+      YT_ABORT( "\"%s\" == %13.7e is not in the range [0.0, 1.0)!\n", "analysis_overhead_target",
+                g_param_libyt.analysis_overhead_target );
+   if ( g_param_libyt.analysis_slice_time < 0.0 )
+      YT_ABORT( "\"%s\" == %13.7e < 0.0!\n", "analysis_slice_time", g_param_libyt.analysis_slice_time );
+   if ( g_param_libyt.output_threads < 0 )
+      YT_ABORT( "\"%s\" == %d < 0!\n", "output_threads", g_param_libyt.output_threads );
+   if ( g_param_libyt.output_queue_size <= 0 )
+      YT_ABORT( "\"%s\" == %d <= 0!\n", "output_queue_size", g_param_libyt.output_queue_size );
+   if ( g_param_libyt.decode_cache_mb < 0.0 )
+      YT_ABORT( "\"%s\" == %13.7e < 0.0!\n", "decode_cache_mb", g_param_libyt.decode_cache_mb );
+   if ( g_param_libyt.ring_buffer_depth <= 0 )
+      YT_ABORT( "\"%s\" == %d <= 0!\n", "ring_buffer_depth", g_param_libyt.ring_buffer_depth );
+   if ( g_param_libyt.ring_buffer_mb < 0.0 )
+      YT_ABORT( "\"%s\" == %13.7e < 0.0!\n", "ring_buffer_mb", g_param_libyt.ring_buffer_mb );
+   if ( g_param_libyt.parallel_workers < 0 )
+      YT_ABORT( "\"%s\" == %d < 0!\n", "parallel_workers", g_param_libyt.parallel_workers );
+   if ( g_param_libyt.grid_order != YT_ORDER_HOST  &&  g_param_libyt.grid_order != YT_ORDER_MORTON  &&
+        g_param_libyt.grid_order != YT_ORDER_HILBERT )
+      YT_ABORT( "Unknown \"%s\" == %d!\n", "grid_order", g_param_libyt.grid_order );
+   if ( g_param_libyt.shm_name != NULL  &&  g_param_libyt.num_analysis_ranks != 0 )
+      YT_ABORT( "\"%s\" and \"%s\" cannot be enabled at the same time!\n", "shm_name", "num_analysis_ranks" );
+
+
+// reserve ranks for analysis
+// ==> compute ranks only send their grids to the analysis ranks and do not need Python at all
+#  ifdef SUPPORT_MPI
+   if ( staging_init() == YT_FAIL )   return YT_FAIL;
+
+   if ( g_param_libyt.staging )
+   {
+      g_param_libyt.libyt_initialized = true;
+      return YT_SUCCESS;
+   }
+#  else
+   if ( g_param_libyt.num_analysis_ranks != 0 )
+      YT_ABORT( "\"%s\" == %d requires compiling libyt with -DSUPPORT_MPI!\n", "num_analysis_ranks",
+                g_param_libyt.num_analysis_ranks );
+#  endif
+
+
+// publish analysis steps to an external server
+// ==> this process does not need Python at all
+   if ( shm_init() == YT_FAIL )   return YT_FAIL;
+
+   if ( g_param_libyt.external )
+   {
+      g_param_libyt.libyt_initialized = true;
+      return YT_SUCCESS;
+   }
 
 
 // initialize Python interpreter
@@ -52,6 +145,24 @@ int yt_init( int argc, char *argv[], const yt_param_libyt *param_libyt )
    if ( init_libyt_module() == YT_FAIL )   return YT_FAIL;
 
 
+// record all API calls for yt_replay()
+   if ( g_param_libyt.capture != NULL  &&  capture_open( g_param_libyt.capture ) == YT_FAIL )   return YT_FAIL;
+
+
+// set up the garbage collection policy
+// ==> after importing the analysis script so that YT_GC_FREEZE can freeze all modules imported by it
+   if ( init_gc_policy() == YT_FAIL )   return YT_FAIL;
+
+
+// launch the output workers
+   if ( output_pool_init() == YT_FAIL )   return YT_FAIL;
+
+
+// release the GIL so that the output workers can run while the simulation is running
+// ==> all API functions touching Python objects must acquire it with yt_gil_guard
+   g_py_main_tstate = PyEval_SaveThread();
+
+
    g_param_libyt.libyt_initialized = true;
    return YT_SUCCESS;
 
@@ -18,6 +18,10 @@
 //                      #your YT commands
 //                      # ...
 //
+//                3. "yt_inline" can also be a generator function resumed across steps (see run_analysis_task())
+//                4. The script is aborted with KeyboardInterrupt if it exceeds "g_param_libyt.analysis_time_budget"
+//                   ==> Not treated as an error so that the simulation can continue
+//
 // Parameter   :  None
 //
 // Return      :  YT_SUCCESS or YT_FAIL
@@ -25,12 +29,35 @@
 int yt_inline()
 {
 
+   const double start = get_wall_time();
+
 // check if libyt has been initialized
    if ( g_param_libyt.libyt_initialized )
       log_info( "Performing YT inline analysis ...\n" );
    else
       YT_ABORT( "Please invoke yt_init() before calling %s()!\n", __FUNCTION__ );
 
+// publish the grids to the external server or send them to the analysis ranks instead
+   if ( g_param_libyt.external )   return shm_inline();
+
+#  ifdef SUPPORT_MPI
+   if ( g_param_libyt.staging )   return staging_inline();
+#  endif
+
+// skip if no analysis is scheduled at this step
+// ==> done before acquiring the GIL, which may be held by the output workers
+   if ( g_param_libyt.analysis_decided  &&  !g_param_libyt.analysis_due )
+   {
+      log_info( "No analysis is scheduled at step [%ld] ... skipped\n", g_param_libyt.counter );
+
+      end_analysis_step();
+      g_param_libyt.counter ++;
+
+      return YT_SUCCESS;
+   }
+
+   yt_gil_guard gil;
+
 
 // check if YT parameters have been set
    if ( !g_param_libyt.param_yt_set )
@@ -45,33 +72,70 @@ int yt_inline()
    }
 
 
+// renumber the grids selected by the grid filter and sort them along the space-filling curve
+   if ( compact_grids() != YT_SUCCESS )
+      YT_ABORT( "Compacting grids ... failed!\n" );
+
+   if ( order_grids() != YT_SUCCESS )
+      YT_ABORT( "Sorting grids ... failed!\n" );
+
+
+// export all staged grids to Python
+   if ( commit_grids() )
+      log_debug( "Committing grids ... done\n" );
+   else
+      YT_ABORT(  "Committing grids ... failed!\n" );
+
+
+// record this call for yt_replay()
+   if ( capture_inline() == YT_FAIL )   return YT_FAIL;
+
+
 // execute YT script
    const int CallYT_CommandWidth = strlen( g_param_libyt.script ) + 13;   // 13 = ".yt_inline()" + '\0'
    char *CallYT = (char*) malloc( CallYT_CommandWidth*sizeof(char) );
    sprintf( CallYT, "%s.yt_inline()", g_param_libyt.script );
 
-   if ( PyRun_SimpleString( CallYT ) == 0 )
-      log_debug( "Invoking \"%s\" ... done\n", CallYT );
+   if ( watchdog_start( start ) == YT_FAIL )   return YT_FAIL;
+
+   const int  status = run_analysis_task();
+   const bool abort  = watchdog_stop();
+
+   if ( abort )
+      log_warning( "Invoking \"%s\" ... aborted after exceeding the time budget of %.3f s (%.3f s)\n",
+                   CallYT, g_param_libyt.analysis_time_budget, get_wall_time() - start );
+   else if ( status == 0 )
+      log_debug( "Invoking \"%s\" ... done (%.3f s)\n", CallYT, get_wall_time() - start );
    else
       YT_ABORT(  "Invoking \"%s\" ... failed\n", CallYT );
 
    free( CallYT );
 
 
+// flush the reduced output of this step (the I/O thread does the actual work)
+   if ( g_param_libyt.reduced_output_set  &&  reduced_output_flush() != YT_SUCCESS )
+      YT_ABORT( "Flushing the reduced output ... failed!\n" );
+
+
 // free resources to prepare for the next execution
-   g_param_yt.init();
-   g_param_libyt.param_yt_set = false;
-   g_param_libyt.counter ++;
+// ==> also wait for the native calls of the output workers still reading the grids (e.g., libyt.render())
+   reset_step();
 
-   delete [] g_param_libyt.grid_set;
-   g_param_libyt.grid_set = NULL;
+   PyObject *py_zero = PyLong_FromLong( 0 );
+   PyObject_SetAttrString( g_py_grid_data, "_num_grids", py_zero );
+   Py_DECREF( py_zero );
 
    PyDict_Clear( g_py_grid_data  );
    PyDict_Clear( g_py_hierarchy  );
-   PyDict_Clear( g_py_param_yt   );
    PyDict_Clear( g_py_param_user );
+   PyDict_Clear( g_py_derived_cache );
+   clear_block_pools();
+   decode_cache_clear();
+
+   collect_garbage();
 
-   PyRun_SimpleString( "gc.collect()" );
+   if ( release_views() != YT_SUCCESS )
+      YT_ABORT( "Python still refers to the simulation data after the analysis!\n" );
 
 
    return YT_SUCCESS;
@@ -0,0 +1,33 @@
+#include "yt_combo.h"
+#include "libyt.h"
+
+
+
+
+//-------------------------------------------------------------------------------------------------------
+// Function    :  yt_inline_wait
+// Description :  Wait until all tasks submitted by libyt.submit_output() have been executed
+//
+// Note        :  1. Tasks keep running in the background after yt_inline() returns. Call this function
+//                   before modifying anything the tasks depend on, or before writing checkpoints that
+//                   must include the analysis outputs.
+//                2. Also called by yt_finalize()
+//
+// Parameter   :  None
+//
+// Return      :  YT_SUCCESS or YT_FAIL
+//-------------------------------------------------------------------------------------------------------
+int yt_inline_wait()
+{
+
+// check if libyt has been initialized
+   if ( !g_param_libyt.libyt_initialized )
+      YT_ABORT( "Please invoke yt_init() before calling %s()!\n", __FUNCTION__ );
+
+   output_pool_wait();
+
+   log_debug( "Waiting for output tasks ... done\n" );
+
+   return YT_SUCCESS;
+
+} // FUNCTION : yt_inline_wait
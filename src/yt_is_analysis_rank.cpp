@@ -0,0 +1,33 @@
+#define NO_PYTHON
+#include "yt_combo.h"
+#undef NO_PYTHON
+#include "libyt.h"
+
+
+
+
+//-------------------------------------------------------------------------------------------------------
+// Function    :  yt_is_analysis_rank
+// Description :  Return whether this rank is reserved for analysis in the staging mode
+//
+// Note        :  1. The last "param_libyt.num_analysis_ranks" ranks of MPI_COMM_WORLD are analysis ranks
+//                2. Analysis ranks should call yt_run_analysis_server() instead of running the simulation
+//
+// Parameter   :  None
+//
+// Return      :  1 ==> analysis rank
+//                0 ==> compute rank (or the staging mode is disabled, or libyt has not been initialized)
+//-------------------------------------------------------------------------------------------------------
+int yt_is_analysis_rank()
+{
+
+// check if libyt has been initialized
+   if ( !g_param_libyt.libyt_initialized )
+   {
+      log_error( "Please invoke yt_init() before calling %s()!\n", __FUNCTION__ );
+      return 0;
+   }
+
+   return ( g_param_libyt.analysis_rank ) ? 1 : 0;
+
+} // FUNCTION : yt_is_analysis_rank
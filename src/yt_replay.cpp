@@ -0,0 +1,45 @@
+#include "yt_combo.h"
+#include "libyt.h"
+#include <string.h>
+
+
+
+
+//-------------------------------------------------------------------------------------------------------
+// Function    :  yt_replay
+// Description :  Replay all libyt API calls recorded in a capture file
+//
+// Note        :  1. Capture files are created by setting "param_libyt.capture" when calling yt_init()
+//                2. Feed the recorded yt_set_parameter(), yt_add_user_parameter_*(), yt_add_grid(), and
+//                   yt_inline() calls back into libyt in the original order and at full speed
+//                   ==> Useful for profiling inline analysis scripts without running the simulation
+//                3. Field data are memory-mapped from the capture file without copying
+//                4. See tool/replay/replay.cpp for a standalone driver
+//
+// Parameter   :  filename : Name of the capture file
+//
+// Return      :  YT_SUCCESS or YT_FAIL
+//-------------------------------------------------------------------------------------------------------
+int yt_replay( const char *filename )
+{
+
+// check if libyt has been initialized
+   if ( g_param_libyt.libyt_initialized )
+      log_info( "Replaying the capture file \"%s\" ...\n", filename );
+   else
+      YT_ABORT( "Please invoke yt_init() before calling %s()!\n", __FUNCTION__ );
+
+
+// the capture file has been truncated by yt_init() if it's also the target of capture
+   if ( g_param_libyt.capture != NULL  &&  strcmp( g_param_libyt.capture, filename ) == 0 )
+      YT_ABORT( "Cannot replay the capture file \"%s\" while capturing to the same file!\n", filename );
+
+
+// replay all API calls
+   if ( replay_capture( filename ) == YT_FAIL )
+      YT_ABORT( "Replaying the capture file \"%s\" ... failed!\n", filename );
+
+
+   return YT_SUCCESS;
+
+} // FUNCTION : yt_replay
@@ -0,0 +1,47 @@
+#define NO_PYTHON
+#include "yt_combo.h"
+#undef NO_PYTHON
+#include "libyt.h"
+
+
+
+
+//-------------------------------------------------------------------------------------------------------
+// Function    :  yt_run_analysis_server
+// Description :  Run the inline analysis of the steps sent by the compute ranks in the staging mode
+//
+// Note        :  1. Must be called on the analysis ranks only (see yt_is_analysis_rank())
+//                2. Compute ranks expose their field data in an RMA window and send a small metadata message
+//                   at each yt_inline(). The analysis rank pulls all field data with MPI_Get(), releases
+//                   the compute ranks, and then runs the analysis script as if the grids were local.
+//                3. Successive analyses are distributed among the analysis ranks in a round-robin fashion
+//                4. Return after all compute ranks have called yt_finalize()
+//                   ==> Call yt_finalize() afterwards on the analysis ranks as well
+//
+// Parameter   :  None
+//
+// Return      :  YT_SUCCESS or YT_FAIL
+//-------------------------------------------------------------------------------------------------------
+int yt_run_analysis_server()
+{
+
+// check if libyt has been initialized
+   if ( g_param_libyt.libyt_initialized )
+      log_info( "Running the analysis server ...\n" );
+   else
+      YT_ABORT( "Please invoke yt_init() before calling %s()!\n", __FUNCTION__ );
+
+
+// check if this is an analysis rank
+   if ( !g_param_libyt.analysis_rank )
+      YT_ABORT( "%s() must be called on the analysis ranks only (see yt_is_analysis_rank())!\n", __FUNCTION__ );
+
+
+// serve the compute ranks
+   if ( staging_serve() == YT_FAIL )
+      YT_ABORT( "Running the analysis server ... failed!\n" );
+
+
+   return YT_SUCCESS;
+
+} // FUNCTION : yt_run_analysis_server
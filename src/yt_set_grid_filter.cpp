@@ -0,0 +1,71 @@
+#include "yt_combo.h"
+#include "libyt.h"
+
+
+
+
+//-------------------------------------------------------------------------------------------------------
+// Function    :  yt_set_grid_filter
+// Description :  Select the grids and fields passed to the analysis
+//
+// Note        :  1. Grids rejected by the filter are discarded by yt_add_grid() right after validation
+//                   ==> They must still be passed to yt_add_grid() and counted in "yt_param_yt::num_grids"
+//                2. The surviving grids are renumbered consecutively by yt_inline(), which also updates
+//                   libyt.param_yt["num_grids"], libyt.hierarchy, and the parent IDs (-1 if the parent
+//                   grid is rejected)
+//                3. Can be called again to replace the filter, but not between yt_set_parameter() and
+//                   yt_inline()
+//                4. Pass NULL to remove the filter
+//                5. Only supported by the analysis in this process (i.e., not with capture, the shared-memory
+//                   server, or the analysis ranks)
+//
+// Parameter   :  filter : Structure selecting the grids and fields
+//
+// Return      :  YT_SUCCESS or YT_FAIL
+//-------------------------------------------------------------------------------------------------------
+int yt_set_grid_filter( const yt_grid_filter *filter )
+{
+
+// check if libyt has been initialized
+   if ( g_param_libyt.libyt_initialized )
+      log_info( "Setting grid filter ...\n" );
+   else
+      YT_ABORT( "Please invoke yt_init() before calling %s()!\n", __FUNCTION__ );
+
+   if ( g_param_libyt.param_yt_set )
+      YT_ABORT( "Please invoke %s() before yt_set_parameter()!\n", __FUNCTION__ );
+
+   if ( g_param_libyt.capture != NULL  ||  g_param_libyt.external  ||  g_param_libyt.staging )
+      YT_ABORT( "%s() is not supported with capture, the shared-memory server, or the analysis ranks!\n", __FUNCTION__ );
+
+
+// remove the filter
+   if ( filter == NULL )
+   {
+      grid_filter_free();
+      g_param_libyt.grid_filter_set = false;
+
+      log_debug( "Removing grid filter ... done\n" );
+      return YT_SUCCESS;
+   }
+
+
+// check if all parameters have been set properly
+   if ( filter->validate() )
+      log_debug( "Validating grid filter ... done\n" );
+   else
+      YT_ABORT(  "Validating grid filter ... failed\n" );
+
+
+// store user-provided parameters to a libyt internal variable
+   if ( grid_filter_init( filter ) )
+      log_debug( "Storing grid filter ... done\n" );
+   else
+      YT_ABORT(  "Storing grid filter ... failed!\n" );
+
+
+   g_param_libyt.grid_filter_set = true;
+
+   return YT_SUCCESS;
+
+} // FUNCTION : yt_set_grid_filter
@@ -9,6 +9,8 @@
 // Description :  Set YT-specific parameters
 //
 // Note        :  1. Store the input "param_yt" to libyt.param_yt
+//                2. libyt.param_yt reads "g_param_yt" directly (see param_yt_object.cpp)
+//                   ==> Only the structure and its strings are copied here
 //
 // Parameter   :  param_yt : Structure storing all YT-specific parameters
 //
@@ -23,6 +25,46 @@ int yt_set_parameter( yt_param_yt *param_yt )
    else
       YT_ABORT( "Please invoke yt_init() before calling %s()!\n", __FUNCTION__ );
 
+// derive the number of grids from the uniform decomposition
+   if ( g_param_libyt.uniform_set )
+   {
+      const int *blocks     = g_param_libyt.uniform_blocks;
+      const int *block_dims = g_param_libyt.uniform_block_dims;
+      const long num_blocks = (long)blocks[0]*blocks[1]*blocks[2];
+
+      if ( param_yt->num_grids == INT_UNDEFINED )   param_yt->num_grids = num_blocks;
+
+      if ( param_yt->num_grids != num_blocks )
+         YT_ABORT( "\"%s\" == %ld != number of blocks of the uniform decomposition == %ld!\n",
+                   "num_grids", param_yt->num_grids, num_blocks );
+
+      for (int d=0; d<3; d++)
+      {
+         if ( param_yt->domain_dimensions[d] != blocks[d]*block_dims[d] )
+            YT_ABORT( "\"%s[%d]\" == %d != blocks*block_dims == %d of the uniform decomposition!\n",
+                      "domain_dimensions", d, param_yt->domain_dimensions[d], blocks[d]*block_dims[d] );
+      }
+   }
+
+// skip everything if no analysis is scheduled at this step
+// ==> done before acquiring the GIL, which may be held by the output workers
+   g_param_libyt.last_time = param_yt->current_time;
+
+   if ( !decide_analysis( param_yt->current_time ) )
+   {
+      log_debug( "No analysis is scheduled at step [%ld] ==> skip %s()\n", g_param_libyt.counter, __FUNCTION__ );
+      return YT_SUCCESS;
+   }
+
+// the external server or the analysis ranks will receive the parameters at yt_inline()
+   if ( g_param_libyt.external )   return shm_set_parameter( param_yt );
+
+#  ifdef SUPPORT_MPI
+   if ( g_param_libyt.staging )   return staging_set_parameter( param_yt );
+#  endif
+
+   yt_gil_guard gil;
+
 
 // check if this function has been called previously
    if ( g_param_libyt.param_yt_set )
@@ -32,16 +74,13 @@ int yt_set_parameter( yt_param_yt *param_yt )
    }
 
 
-// reset all cosmological parameters to zero for non-cosmological datasets
-   if ( !param_yt->cosmological_simulation ) {
-      param_yt->current_redshift = param_yt->omega_lambda = param_yt->omega_matter = param_yt->hubble_constant = 0.0; }
-
+// validate and store user-provided parameters to "g_param_yt", and allocate the slots for staging grids
+// ==> must do this before calling allocate_hierarchy() since it will need "g_param_yt.num_grids"
+// ==> must do this before setting the default figure base name since it will overwrite g_param_yt.fig_basename
+   if ( begin_step( param_yt ) != YT_SUCCESS )   return YT_FAIL;
 
-// check if all parameters have been set properly
-   if ( param_yt->validate() )
-      log_debug( "Validating YT parameters ... done\n" );
-   else
-      YT_ABORT(  "Validating YT parameters ... failed\n" );
+// drop the block pools of the last step left by a failed yt_inline()
+   clear_block_pools();
 
 
 // print out all parameters
@@ -49,46 +88,27 @@ int yt_set_parameter( yt_param_yt *param_yt )
    param_yt->show();
 
 
-// store user-provided parameters to a libyt internal variable
-// ==> must do this before calling allocate_hierarchy() since it will need "g_param_yt.num_grids"
-// ==> must do this before setting the default figure base name since it will overwrite g_param_yt.fig_basename
-   g_param_yt = *param_yt;
+// record the input parameters for yt_replay()
+   if ( capture_param_yt( param_yt ) == YT_FAIL )   return YT_FAIL;
 
 
-// set the default figure base name if it's not set by users
-   if ( param_yt->fig_basename == NULL )
-   {
-      char fig_basename[15];
-      sprintf( fig_basename, "Fig%09ld", g_param_libyt.counter );
+// keep private copies of the strings since libyt.param_yt reads them lazily during yt_inline()
+// ==> also set the default figure base name if it's not set by users
+   static char *Frontend     = NULL;
+   static char *Fig_Basename = NULL;
 
-      g_param_yt.fig_basename = fig_basename;
-   }
+   free( Frontend );
+   free( Fig_Basename );
+   Frontend     = strdup( param_yt->frontend );
+   Fig_Basename = (char*)malloc( ( ( param_yt->fig_basename == NULL ) ? 16 : strlen(param_yt->fig_basename)+1 )*sizeof(char) );
 
+   if ( param_yt->fig_basename == NULL )
+      sprintf( Fig_Basename, "Fig%09ld", g_param_libyt.counter );
+   else
+      strcpy( Fig_Basename, param_yt->fig_basename );
 
-// export data to libyt.param_yt
-// strings
-   add_dict_string(  g_py_param_yt, "frontend",                g_param_yt.frontend                );
-   add_dict_string(  g_py_param_yt, "fig_basename",            g_param_yt.fig_basename            );
-
-// scalars
-   add_dict_scalar(  g_py_param_yt, "current_time",            g_param_yt.current_time            );
-   add_dict_scalar(  g_py_param_yt, "current_redshift",        g_param_yt.current_redshift        );
-   add_dict_scalar(  g_py_param_yt, "omega_lambda",            g_param_yt.omega_lambda            );
-   add_dict_scalar(  g_py_param_yt, "omega_matter",            g_param_yt.omega_matter            );
-   add_dict_scalar(  g_py_param_yt, "hubble_constant",         g_param_yt.hubble_constant         );
-   add_dict_scalar(  g_py_param_yt, "length_unit",             g_param_yt.length_unit             );
-   add_dict_scalar(  g_py_param_yt, "mass_unit",               g_param_yt.mass_unit               );
-   add_dict_scalar(  g_py_param_yt, "time_unit",               g_param_yt.time_unit               );
-   add_dict_scalar(  g_py_param_yt, "cosmological_simulation", g_param_yt.cosmological_simulation );
-   add_dict_scalar(  g_py_param_yt, "dimensionality",          g_param_yt.dimensionality          );
-   add_dict_scalar(  g_py_param_yt, "refine_by",               g_param_yt.refine_by               );
-   add_dict_scalar(  g_py_param_yt, "num_grids",               g_param_yt.num_grids               );
-
-// vectors (stored as Python tuples)
-   add_dict_vector3( g_py_param_yt, "domain_left_edge",        g_param_yt.domain_left_edge        );
-   add_dict_vector3( g_py_param_yt, "domain_right_edge",       g_param_yt.domain_right_edge       );
-   add_dict_vector3( g_py_param_yt, "periodicity",             g_param_yt.periodicity             );
-   add_dict_vector3( g_py_param_yt, "domain_dimensions",       g_param_yt.domain_dimensions       );
+   g_param_yt.frontend     = Frontend;
+   g_param_yt.fig_basename = Fig_Basename;
 
    log_debug( "Inserting YT parameters to libyt.param_yt ... done\n" );
 
@@ -0,0 +1,60 @@
+#include "yt_combo.h"
+#include "libyt.h"
+
+
+
+
+//-------------------------------------------------------------------------------------------------------
+// Function    :  yt_set_reduced_output
+// Description :  Enable the output stage dumping reduced data products to an append-only binary file
+//
+// Note        :  1. Selected fields of the selected grids are copied (and optionally downsampled) when
+//                   calling yt_add_grid(), and then written to disk by a background I/O thread
+//                   ==> yt_inline() never waits on the file system unless the I/O queue is full
+//                2. Output files are "basename.ldat" (data chunks) and "basename.lidx" (chunk index)
+//                   ==> Use tool/read_reduced_output.py to load them
+//                3. Can only be called once after yt_init()
+//                4. Files are closed by yt_finalize()
+//
+// Parameter   :  output : Structure describing the reduced data products
+//
+// Return      :  YT_SUCCESS or YT_FAIL
+//-------------------------------------------------------------------------------------------------------
+int yt_set_reduced_output( const yt_reduced_output *output )
+{
+
+// check if libyt has been initialized
+   if ( g_param_libyt.libyt_initialized )
+      log_info( "Setting reduced output ...\n" );
+   else
+      YT_ABORT( "Please invoke yt_init() before calling %s()!\n", __FUNCTION__ );
+
+
+// check if this function has been called previously
+   if ( g_param_libyt.reduced_output_set )
+      YT_ABORT( "%s() should not be called more than once!\n", __FUNCTION__ );
+
+
+// check if all parameters have been set properly
+   if ( output->validate() )
+      log_debug( "Validating reduced output parameters ... done\n" );
+   else
+      YT_ABORT(  "Validating reduced output parameters ... failed\n" );
+
+
+// store user-provided parameters to a libyt internal variable
+   g_reduced_output = *output;
+
+
+// open files and launch the I/O thread
+   if ( reduced_output_init() )
+      log_debug( "Initializing reduced output \"%s\" ... done\n", g_reduced_output.basename );
+   else
+      YT_ABORT(  "Initializing reduced output \"%s\" ... failed!\n", g_reduced_output.basename );
+
+
+   g_param_libyt.reduced_output_set = true;
+
+   return YT_SUCCESS;
+
+} // FUNCTION : yt_set_reduced_output
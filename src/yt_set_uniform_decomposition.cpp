@@ -0,0 +1,54 @@
+#include "yt_combo.h"
+#include "libyt.h"
+
+
+
+
+//-------------------------------------------------------------------------------------------------------
+// Function    :  yt_set_uniform_decomposition
+// Description :  Describe a uniform grid decomposed into equal-sized blocks
+//
+// Note        :  1. Blocks are then passed by yt_add_uniform_block() with only their field data, and libyt
+//                   derives the grid geometry from the block ID and the fields from yt_declare_fields()
+//                   ==> Block ID = ( i*blocks[1] + j )*blocks[2] + k for the block with indices (i,j,k)
+//                2. yt_set_parameter() sets "num_grids" to the total number of blocks if it is not set, and
+//                   checks that "domain_dimensions" == blocks*block_dims
+//                3. Must be called before yt_set_parameter() and stays effective until it is called again
+//                4. yt_add_grid() can still be used for individual blocks
+//
+// Parameter   :  blocks     : Number of blocks along each direction
+//                block_dims : Number of cells of each block along each direction
+//
+// Return      :  YT_SUCCESS or YT_FAIL
+//-------------------------------------------------------------------------------------------------------
+int yt_set_uniform_decomposition( const int blocks[3], const int block_dims[3] )
+{
+
+// check if libyt has been initialized
+   if ( g_param_libyt.libyt_initialized )
+      log_info( "Setting uniform decomposition ...\n" );
+   else
+      YT_ABORT( "Please invoke yt_init() before calling %s()!\n", __FUNCTION__ );
+
+   if ( g_param_libyt.param_yt_set )
+      YT_ABORT( "Please invoke %s() before yt_set_parameter()!\n", __FUNCTION__ );
+
+
+// check and store the input decomposition
+   for (int d=0; d<3; d++)
+   {
+      if ( blocks    [d] <= 0 )   YT_ABORT( "\"%s[%d]\" == %d <= 0!\n", "blocks",     d, blocks    [d] );
+      if ( block_dims[d] <= 0 )   YT_ABORT( "\"%s[%d]\" == %d <= 0!\n", "block_dims", d, block_dims[d] );
+
+      g_param_libyt.uniform_blocks    [d] = blocks    [d];
+      g_param_libyt.uniform_block_dims[d] = block_dims[d];
+   }
+
+   g_param_libyt.uniform_set = true;
+
+   log_debug( "   blocks     = [%d, %d, %d]\n", blocks    [0], blocks    [1], blocks    [2] );
+   log_debug( "   block_dims = [%d, %d, %d]\n", block_dims[0], block_dims[1], block_dims[2] );
+
+   return YT_SUCCESS;
+
+} // FUNCTION : yt_set_uniform_decomposition
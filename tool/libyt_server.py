@@ -0,0 +1,178 @@
+"""
+Out-of-process analysis server for the shared-memory transport of libyt (see "param_libyt.shm_name")
+
+The simulation publishes every analysis step in POSIX shared memory (Linux: /dev/shm):
+    /<name>.ctl    : control segment ==> single-producer single-consumer ring of "num_slots" steps
+    /<name>.<slot> : one step per slot ==> [slot header] [JSON] [padding] [hierarchy and field arrays]
+
+This server maps each published step, exposes it through a stand-in "libyt" module (param_yt, param_user,
+hierarchy, grid_data) with the field data wrapped as read-only NumPy arrays without copying, runs
+"<script>.yt_inline()", and then releases the slot. A failing script is reported and does not affect the
+simulation.
+
+Usage:
+    python libyt_server.py <name> [script=yt_inline_script] [poll interval in seconds=0.01]
+
+Start it before or after the simulation. It exits once the simulation has called yt_finalize() and all
+published steps have been analyzed. Native methods (e.g., libyt.derived_field()) are not available, and
+libyt.submit_output() executes the task immediately.
+"""
+
+import gc
+import json
+import mmap
+import os
+import struct
+import sys
+import time
+import traceback
+import types
+
+import numpy as np
+
+
+FORMAT_VERSION = 1
+MAX_SLOTS      = 16
+
+# must be consistent with "shm_control" and "shm_slot_header" in src/shm_transport.cpp
+CONTROL_FORMAT = "<8sii4q%dq%dq" % ( MAX_SLOTS, MAX_SLOTS )
+CONTROL_SIZE   = struct.calcsize( CONTROL_FORMAT )
+OFFSET_TAIL    = 24
+OFFSET_PID     = 32
+SLOT_FORMAT    = "<8s3q"
+SLOT_HEADER    = 64
+
+FTYPE = { 1: np.float32, 2: np.float64 }
+
+
+
+def _segment( name ):
+    return os.path.join( "/dev/shm", name )
+
+
+
+class Control( object ):
+    """ Mapping of the control segment """
+
+    def __init__( self, name, poll ):
+        while True:
+            try:
+                with open( _segment( name + ".ctl" ), "r+b" ) as f:
+                    self.mm = mmap.mmap( f.fileno(), CONTROL_SIZE )
+                if self.mm[:8] == b"LIBYTSC\0":
+                    break
+                self.mm.close()
+            except ( IOError, OSError, ValueError ):
+                pass
+            time.sleep( poll )
+
+        version, self.num_slots = struct.unpack_from( "<ii", self.mm, 8 )
+        if version != FORMAT_VERSION:
+            raise IOError( "Unsupported shared-memory format version %d!" % version )
+
+        struct.pack_into( "<q", self.mm, OFFSET_PID, os.getpid() )
+
+
+    def state( self ):
+        fields = struct.unpack_from( CONTROL_FORMAT, self.mm, 0 )
+        head, tail, pid, closed = fields[3:7]
+        return head, tail, closed, fields[7:7+MAX_SLOTS], fields[7+MAX_SLOTS:]
+
+
+    def release( self, tail ):
+        struct.pack_into( "<q", self.mm, OFFSET_TAIL, tail )
+
+
+
+def load_step( name, slot, nbytes, libyt ):
+    """ Map a published step and fill the dictionaries of the stand-in libyt module """
+
+    with open( _segment( "%s.%d" % (name, slot) ), "rb" ) as f:
+        mm = mmap.mmap( f.fileno(), nbytes, access=mmap.ACCESS_READ )
+
+    magic, step, json_size, data_offset = struct.unpack_from( SLOT_FORMAT, mm, 0 )
+    if magic != b"LIBYTSS\0":
+        raise IOError( "Slot [%d] is not a libyt shared-memory segment!" % slot )
+
+    meta = json.loads( mm[ SLOT_HEADER : SLOT_HEADER + json_size ].decode( "utf-8" ) )
+
+    def array( desc ):
+        count = int( np.prod( desc["shape"] ) )
+        return np.frombuffer( mm, dtype=desc["dtype"], count=count,
+                              offset=data_offset + desc["offset"] ).reshape( desc["shape"] )
+
+    def value( v ):
+        return tuple(v) if isinstance( v, list ) else v
+
+    libyt.param_yt   = dict( ( str(k), value(v) ) for k, v in meta["param_yt"  ].items() )
+    libyt.param_user = dict( ( str(k), value(v) ) for k, v in meta["param_user"].items() )
+    libyt.hierarchy  = dict( ( str(k), array(v) ) for k, v in meta["hierarchy" ].items() )
+    libyt.grid_data  = {}
+
+    fields = [ str(label) for label in meta["fields"] ]
+    offset = array( meta["field_offset"] )
+    ftype  = array( meta["field_ftype"]  )
+    dims   = libyt.hierarchy["grid_dimensions"]
+
+    for g in range( libyt.param_yt["num_grids"] ):
+        grid  = libyt.grid_data[g] = {}
+        dtype = np.dtype( FTYPE[ int( ftype[g,0] ) ] )
+        shape = tuple( int(n) for n in dims[g] )
+        for l, label in enumerate( fields ):
+            if offset[g,l] >= 0:
+                grid[label] = np.frombuffer( mm, dtype=dtype, count=int( np.prod(shape) ),
+                                             offset=data_offset + int( offset[g,l] ) ).reshape( shape )
+
+    return step
+
+
+
+def serve( name, script, poll ):
+    # stand-in libyt module imported by the analysis script and the yt frontend
+    libyt = types.ModuleType( "libyt" )
+    libyt.submit_output = lambda func, *args: func( *args )
+    sys.modules["libyt"] = libyt
+
+    sys.path.insert( 0, os.getcwd() )
+    module  = __import__( script )
+    control = Control( name, poll )
+    print( "libyt server: attached to \"%s\" with %d slots" % (name, control.num_slots) )
+
+    while True:
+        head, tail, closed, steps, nbytes = control.state()
+
+        if tail >= head:
+            if closed:
+                break
+            time.sleep( poll )
+            continue
+
+        slot  = tail % control.num_slots
+        start = time.time()
+
+        try:
+            step = load_step( name, slot, nbytes[slot], libyt )
+            module.yt_inline()
+            print( "libyt server: analysis of step [%d] ... done (%.3f s)" % (step, time.time() - start) )
+        except Exception:
+            print( "libyt server: analysis of step [%d] ... failed" % steps[slot] )
+            traceback.print_exc()
+
+        # drop all references to the slot before releasing it
+        libyt.param_yt = libyt.param_user = libyt.hierarchy = libyt.grid_data = None
+        gc.collect()
+
+        control.release( tail + 1 )
+
+    print( "libyt server: simulation has finished" )
+
+
+
+if __name__ == "__main__":
+    if len( sys.argv ) < 2:
+        print( __doc__ )
+        sys.exit( 1 )
+
+    serve( sys.argv[1],
+           sys.argv[2]        if len( sys.argv ) > 2 else "yt_inline_script",
+           float(sys.argv[3]) if len( sys.argv ) > 3 else 0.01 )
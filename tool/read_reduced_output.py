@@ -0,0 +1,124 @@
+"""
+Reader of the reduced data products dumped by yt_set_reduced_output()
+
+Files:
+    basename.ldat : 16-byte file header followed by [chunk header + payload] for each chunk
+    basename.lidx : 16-byte file header followed by an array of chunk headers (memory-mappable)
+
+Example:
+    from read_reduced_output import ReducedOutput
+
+    out  = ReducedOutput( "libyt_reduced" )
+    for step in out.steps():
+        for rec in out.select( step=step, field="Dens", level=1 ):
+            dens = out.read( rec )   # NumPy array memory-mapped to the data file
+"""
+
+import numpy as np
+
+
+HEADER_SIZE = 16   # magic (8 bytes) + version (int32) + record size (int32)
+FORMAT_VERSION = 1
+
+# must be consistent with "reduced_chunk_header" in src/reduced_output.cpp
+CHUNK_DTYPE = np.dtype( [ ( "magic",      "S4"         ),
+                          ( "ftype",      "<i4"        ),
+                          ( "step",       "<i8"        ),
+                          ( "time",       "<f8"        ),
+                          ( "grid_id",    "<i8"        ),
+                          ( "level",      "<i4"        ),
+                          ( "downsample", "<i4"        ),
+                          ( "dimensions", "<i4", (3,)  ),
+                          ( "padding",    "<i4"        ),
+                          ( "left_edge",  "<f8", (3,)  ),
+                          ( "right_edge", "<f8", (3,)  ),
+                          ( "field",      "S32"        ),
+                          ( "offset",     "<i8"        ),
+                          ( "nbytes",     "<i8"        ) ] )
+
+FTYPE = { 1: np.float32, 2: np.float64 }
+
+
+
+def _check_header( filename, magic ):
+    with open( filename, "rb" ) as f:
+        header = f.read( HEADER_SIZE )
+
+    if len(header) < HEADER_SIZE  or  header[:8] != magic:
+        raise IOError( "\"%s\" is not a libyt reduced output file!" % filename )
+
+    version, record_size = np.frombuffer( header[8:], dtype="<i4" )
+    if version != FORMAT_VERSION:
+        raise IOError( "Unsupported format version %d in \"%s\"!" % (version, filename) )
+    if record_size != CHUNK_DTYPE.itemsize:
+        raise IOError( "Inconsistent record size %d in \"%s\"!" % (record_size, filename) )
+
+
+
+class ReducedOutput( object ):
+    """
+    Memory-mapped view of a reduced output
+
+    index : NumPy structured array (dtype = CHUNK_DTYPE) of all chunks written so far
+    """
+
+    def __init__( self, basename ):
+        self.data_file  = basename + ".ldat"
+        self.index_file = basename + ".lidx"
+
+        _check_header( self.data_file,  b"LIBYTRD\0" )
+        _check_header( self.index_file, b"LIBYTRI\0" )
+
+        self.reload()
+
+
+    def reload( self ):
+        """ Map the chunks appended since the last call (the files are append-only) """
+        self.index = np.memmap( self.index_file, dtype=CHUNK_DTYPE, mode="r", offset=HEADER_SIZE )
+        self.data  = np.memmap( self.data_file,  dtype=np.uint8,    mode="r" )
+
+
+    def steps( self ):
+        """ Return all steps stored in the file """
+        return np.unique( self.index["step"] )
+
+
+    def select( self, step=None, field=None, level=None, grid_id=None ):
+        """ Return the index records matching all the given conditions """
+        mask = np.ones( len(self.index), dtype=bool )
+
+        if step    is not None:   mask &= self.index["step"]    == step
+        if level   is not None:   mask &= self.index["level"]   == level
+        if grid_id is not None:   mask &= self.index["grid_id"] == grid_id
+        if field   is not None:
+            if not isinstance( field, bytes ):   field = field.encode( "ascii" )
+            mask &= self.index["field"] == field
+
+        return self.index[mask]
+
+
+    def read( self, record ):
+        """ Return the payload of a chunk as a NumPy array without copying """
+        dtype  = FTYPE[ int(record["ftype"]) ]
+        offset = int( record["offset"] )
+        nbytes = int( record["nbytes"] )
+
+        return self.data[ offset : offset+nbytes ].view( dtype ).reshape( tuple(record["dimensions"]) )
+
+
+    def scan( self ):
+        """ Rebuild the index by scanning the self-describing data file (e.g., if the index file is lost) """
+        records = []
+        offset  = HEADER_SIZE
+
+        while offset + CHUNK_DTYPE.itemsize <= len(self.data):
+            record = self.data[ offset : offset+CHUNK_DTYPE.itemsize ].view( CHUNK_DTYPE )[0]
+            if record["magic"] != b"CHNK":
+                raise IOError( "Corrupted chunk at offset %d in \"%s\"!" % (offset, self.data_file) )
+
+            offset = int( record["offset"] ) + int( record["nbytes"] )
+            if offset > len(self.data):   break   # incomplete chunk at the end of file
+
+            records.append( record )
+
+        return np.array( records, dtype=CHUNK_DTYPE )
@@ -0,0 +1 @@
+g++ -g -Wall replay.cpp -o replay -I../../include -L../../src -lyt
@@ -0,0 +1,69 @@
+
+
+// ==========================================
+// Replay a capture file created by setting
+// "param_libyt.capture" in yt_init()
+//
+// Usage: ./replay capture_file [script]
+// ==========================================
+
+
+#include <stdlib.h>
+#include <sys/time.h>
+#include "libyt.h"
+
+
+
+//-------------------------------------------------------------------------------------------------------
+// Function    :  main
+// Description :  Main function
+//-------------------------------------------------------------------------------------------------------
+int main( int argc, char *argv[] )
+{
+
+   if ( argc < 2 )
+   {
+      fprintf( stderr, "Usage: %s capture_file [script (default=yt_inline_script)]\n", argv[0] );
+      exit( EXIT_FAILURE );
+   }
+
+
+// initialize libyt
+   yt_param_libyt param_libyt;
+
+   param_libyt.verbose = YT_VERBOSE_INFO;
+   if ( argc >= 3 )   param_libyt.script = argv[2];
+
+   if ( yt_init( argc, argv, &param_libyt ) != YT_SUCCESS )
+   {
+      fprintf( stderr, "ERROR: yt_init() failed!\n" );
+      exit( EXIT_FAILURE );
+   }
+
+
+// replay all API calls
+   timeval t_start, t_end;
+   gettimeofday( &t_start, NULL );
+
+   if ( yt_replay( argv[1] ) != YT_SUCCESS )
+   {
+      fprintf( stderr, "ERROR: yt_replay() failed!\n" );
+      exit( EXIT_FAILURE );
+   }
+
+   gettimeofday( &t_end, NULL );
+
+   fprintf( stdout, "Replaying \"%s\" took %.6f s\n", argv[1],
+            ( t_end.tv_sec - t_start.tv_sec ) + 1.0e-6*( t_end.tv_usec - t_start.tv_usec ) );
+
+
+// exit libyt
+   if ( yt_finalize() != YT_SUCCESS )
+   {
+      fprintf( stderr, "ERROR: yt_finalize() failed!\n" );
+      exit( EXIT_FAILURE );
+   }
+
+   return EXIT_SUCCESS;
+
+} // FUNCTION : main